@@ -0,0 +1,806 @@
+//
+//  allocbench.c
+//  allocbench
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <__tlsf.h>
+#include <__lsta.h>
+
+// Host-side verification and benchmark of the TLSF heap allocator. The benchmark
+// replays allocation traces against the TLSF allocator and the first-fit lsta
+// allocator that libc and the kernel used before. A trace is either one of the
+// built-in synthetic traces or a trace file passed on the command line. A trace
+// file has one operation per line:
+//
+//  a <id> <size>   allocate a block of 'size' bytes and name it 'id'
+//  r <id> <size>   resize the block 'id' to 'size' bytes
+//  f <id>          free the block 'id'
+//
+// Usage: allocbench [-f <rounds>] [-s <seed>] [trace_file]
+//
+// -f runs the given number of fuzz rounds instead of the benchmark. Every round
+// drives the TLSF allocator with a random operation sequence and checks the heap
+// invariants along the way. -s sets the seed of the random number generator.
+
+#define MAX_IDS         8192
+#define MAX_OPS         200000
+#define ARENA_SIZE      (8 * 1024 * 1024)
+#define ROUNDS          4
+#define BURST_IDS       16  // Ids [MAX_IDS - BURST_IDS, MAX_IDS) are reserved for short lived bursts
+
+// Allowance for the per-block overhead of the allocators when the tight heap is
+// sized: header and trailer (4 words), rounding of the size to a word multiple
+// and the minimum net block size that holds the free list links (2 words)
+#define BLOCK_OVERHEAD  (4 * sizeof(void*))
+#define BLOCK_MIN_SIZE  (2 * sizeof(void*))
+
+enum {
+    OP_ALLOC,
+    OP_REALLOC,
+    OP_FREE
+};
+
+typedef struct Op {
+    int8_t  kind;
+    int32_t id;
+    int32_t size;
+} Op;
+
+typedef struct Trace {
+    const char* _Nonnull    name;
+    Op* _Nonnull            ops;
+    int                     count;
+    size_t                  peak_live;  // Highest number of live bytes
+    size_t                  peak_gross; // Highest number of live bytes including the per-block overhead allowance
+} Trace;
+
+typedef struct Block {
+    unsigned char* _Nullable    ptr;
+    size_t                      size;
+    unsigned char               fill;
+} Block;
+
+typedef struct Result {
+    double  kops;       // Thousands of operations per second
+    int     failed;     // Operations that failed in the tight heap
+    size_t  footprint;  // Highest heap address touched in the tight heap relative to the heap start
+} Result;
+
+static Block    gBlocks[MAX_IDS];
+static Op       gOps[MAX_OPS];
+
+
+static void fatal(const char* msg, int i)
+{
+    fprintf(stderr, "allocbench: %s (block %d)\n", msg, i);
+    exit(EXIT_FAILURE);
+}
+
+static void mem_error(int err, const char* _Nonnull funcName, void* _Nullable ptr)
+{
+    fprintf(stderr, "allocbench: %s: %s at %p\n", funcName, (err == MERR_DOUBLE_FREE) ? "double free" : "heap corruption", ptr);
+    exit(EXIT_FAILURE);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Allocators
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct Allocator {
+    const char* _Nonnull    name;
+    void* _Nullable         (*create)(char* _Nonnull mem, size_t nbytes);
+    void* _Nullable         (*alloc)(void* _Nonnull self, size_t nbytes);
+    void* _Nullable         (*realloc)(void* _Nonnull self, void* _Nullable ptr, size_t nbytes);
+    void                    (*dealloc)(void* _Nonnull self, void* _Nullable ptr);
+} Allocator;
+
+static void* _Nullable tlsf_create(char* _Nonnull mem, size_t nbytes)
+{
+    mem_desc_t md;
+
+    md.lower = mem;
+    md.upper = mem + nbytes;
+    return __tlsf_create(&md, NULL, NULL, mem_error);
+}
+
+static void* _Nullable tlsf_alloc(void* _Nonnull self, size_t nbytes)
+{
+    return __tlsf_alloc(self, nbytes);
+}
+
+static void* _Nullable tlsf_realloc(void* _Nonnull self, void* _Nullable ptr, size_t nbytes)
+{
+    return __tlsf_realloc(self, ptr, nbytes);
+}
+
+static void tlsf_dealloc(void* _Nonnull self, void* _Nullable ptr)
+{
+    if (__tlsf_dealloc(self, ptr) != EOK) {
+        fatal("tlsf: foreign pointer", -1);
+    }
+}
+
+static void* _Nullable lsta_create(char* _Nonnull mem, size_t nbytes)
+{
+    mem_desc_t md;
+
+    md.lower = mem;
+    md.upper = mem + nbytes;
+    return __lsta_create(&md, NULL, NULL, mem_error);
+}
+
+static void* _Nullable lsta_alloc(void* _Nonnull self, size_t nbytes)
+{
+    return __lsta_alloc(self, nbytes);
+}
+
+static void* _Nullable lsta_realloc(void* _Nonnull self, void* _Nullable ptr, size_t nbytes)
+{
+    return __lsta_realloc(self, ptr, nbytes);
+}
+
+static void lsta_dealloc(void* _Nonnull self, void* _Nullable ptr)
+{
+    if (__lsta_dealloc(self, ptr) != EOK) {
+        fatal("lsta: foreign pointer", -1);
+    }
+}
+
+static const Allocator gAllocators[] = {
+    {"tlsf", tlsf_create, tlsf_alloc, tlsf_realloc, tlsf_dealloc},
+    {"lsta", lsta_create, lsta_alloc, lsta_realloc, lsta_dealloc},
+};
+#define ALLOCATOR_COUNT (sizeof(gAllocators) / sizeof(Allocator))
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Verification
+////////////////////////////////////////////////////////////////////////////////
+
+static void check_fill(int id)
+{
+    const Block* bp = &gBlocks[id];
+
+    for (size_t i = 0; i < bp->size; i++) {
+        if (bp->ptr[i] != bp->fill) {
+            fatal("block contents were overwritten", id);
+        }
+    }
+}
+
+static void fill(int id)
+{
+    Block* bp = &gBlocks[id];
+
+    bp->fill = (unsigned char)(id * 31 + 7);
+    memset(bp->ptr, bp->fill, bp->size);
+}
+
+static int gGrowCount;
+static int gReleaseCount;
+
+static bool grow_heap(tlsf_t _Nonnull self, size_t minByteCount)
+{
+    const size_t nbytes = (minByteCount + 1024 > 64*1024) ? minByteCount + 1024 : 64*1024;
+    char* ptr = malloc(nbytes);
+    mem_desc_t md;
+
+    md.lower = ptr;
+    md.upper = ptr + nbytes;
+    gGrowCount++;
+    return (ptr && __tlsf_add_memregion(self, &md) == EOK) ? true : false;
+}
+
+static bool release_region(tlsf_t _Nonnull self, const mem_desc_t* _Nonnull md)
+{
+    // malloc() returns word aligned memory. So 'md->lower' is the pointer that
+    // grow_heap() got from malloc()
+    free(md->lower);
+    gReleaseCount++;
+    return true;
+}
+
+static const char gSite[] = "verify";
+
+typedef struct VisitedBlock {
+    unsigned char* _Nonnull ptr;
+    size_t                  size;
+} VisitedBlock;
+
+typedef struct VisitCount {
+    int             blocks;
+    int             sites;
+    VisitedBlock    visited[MAX_IDS];
+} VisitCount;
+
+static VisitCount gVisitCount;
+
+static void count_block(void* _Nullable ctx, void* _Nonnull ptr, size_t size, const char* _Nullable site)
+{
+    VisitCount* vc = ctx;
+
+    if (vc->blocks < MAX_IDS) {
+        vc->visited[vc->blocks].ptr = ptr;
+        vc->visited[vc->blocks].size = size;
+    }
+    vc->blocks++;
+    if (site == gSite) {
+        vc->sites++;
+    }
+}
+
+static int cmp_visited(const void* lhs, const void* rhs)
+{
+    const VisitedBlock* l = lhs;
+    const VisitedBlock* r = rhs;
+
+    return (l->ptr < r->ptr) ? -1 : ((l->ptr > r->ptr) ? 1 : 0);
+}
+
+// Checks that the blocks that the heap reports don't overlap and that every
+// live block in 'gBlocks' is one of them and big enough. 'vc' must hold exactly
+// the live blocks.
+static void check_layout(VisitCount* _Nonnull vc, int nids)
+{
+    qsort(vc->visited, vc->blocks, sizeof(VisitedBlock), cmp_visited);
+
+    for (int i = 1; i < vc->blocks; i++) {
+        if (vc->visited[i - 1].ptr + vc->visited[i - 1].size > vc->visited[i].ptr) {
+            fatal("allocated blocks overlap", -1);
+        }
+    }
+
+    for (int id = 0; id < nids; id++) {
+        if (gBlocks[id].ptr) {
+            const VisitedBlock key = {gBlocks[id].ptr, 0};
+            const VisitedBlock* vbp = bsearch(&key, vc->visited, vc->blocks, sizeof(VisitedBlock), cmp_visited);
+
+            if (vbp == NULL) {
+                fatal("heap does not know about a live block", id);
+            }
+            if (vbp->size < gBlocks[id].size) {
+                fatal("heap reports a block that is too small", id);
+            }
+        }
+    }
+}
+
+// Checks that the heap statistics and the allocated blocks that the heap
+// reports match the live blocks in 'gBlocks'.
+static void check_info(tlsf_t _Nonnull heap, int nids)
+{
+    VisitCount* vc = &gVisitCount;
+    int nlive = 0, nsites = 0;
+    tlsf_info_t info;
+
+    for (int id = 0; id < nids; id++) {
+        if (gBlocks[id].ptr) {
+            nlive++;
+            nsites += (id & 1);
+        }
+    }
+
+    vc->blocks = 0;
+    vc->sites = 0;
+    __tlsf_getinfo(heap, &info);
+    __tlsf_visit(heap, count_block, vc);
+    if (info.used_block_count != nlive || vc->blocks != nlive || vc->sites != nsites) {
+        fatal("heap statistics do not match the live blocks", -1);
+    }
+    if (info.allocs - info.frees != nlive || info.used_bytes > info.peak_used_bytes) {
+        fatal("heap counters are inconsistent", -1);
+    }
+    if (info.largest_free_size > info.free_bytes || __tlsf_getfreebytes(heap) < info.free_bytes) {
+        fatal("heap free space is inconsistent", -1);
+    }
+    check_layout(vc, nids);
+}
+
+// Allocates, resizes and frees blocks at random from a small heap that grows
+// and shrinks through the grow and release callbacks. Every block is filled with
+// a pattern that is checked before the block is resized or freed. Blocks with
+// odd ids carry an allocation site. One in 8 requests asks for up to 'max_size'
+// bytes and all others ask for up to 256 bytes. The heap invariants are checked
+// every 'check_interval' operations.
+static void verify(int nids, int nops, size_t max_size, int check_interval)
+{
+    char* mem = malloc(32*1024);
+    mem_desc_t md;
+
+    md.lower = mem;
+    md.upper = mem + 32*1024;
+    tlsf_t heap = __tlsf_create(&md, grow_heap, release_region, mem_error);
+    if (heap == NULL) {
+        fatal("unable to create heap", -1);
+    }
+    memset(gBlocks, 0, sizeof(gBlocks));
+    gGrowCount = 0;
+    gReleaseCount = 0;
+
+
+    for (int n = 0; n < nops; n++) {
+        const int id = rand() % nids;
+        Block* bp = &gBlocks[id];
+        const size_t size = (rand() % 8 == 0) ? 1 + rand() % max_size : 1 + rand() % 256;
+
+        if (bp->ptr == NULL) {
+            bp->ptr = (id & 1) ? __tlsf_alloc_site(heap, size, gSite) : __tlsf_alloc(heap, size);
+            bp->size = size;
+            if (bp->ptr == NULL) {
+                fatal("out of memory", id);
+            }
+            fill(id);
+        }
+        else if (rand() % 4 == 0) {
+            check_fill(id);
+            unsigned char* np = __tlsf_realloc(heap, bp->ptr, size);
+            if (np == NULL) {
+                fatal("realloc failed", id);
+            }
+            for (size_t i = 0; i < ((size < bp->size) ? size : bp->size); i++) {
+                if (np[i] != bp->fill) {
+                    fatal("realloc lost the block contents", id);
+                }
+            }
+            bp->ptr = np;
+            bp->size = size;
+            fill(id);
+        }
+        else {
+            check_fill(id);
+            if (__tlsf_dealloc(heap, bp->ptr) != EOK) {
+                fatal("dealloc failed", id);
+            }
+            bp->ptr = NULL;
+        }
+
+        if (bp->ptr) {
+            size_t bsize;
+
+            if (__tlsf_getblocksize(heap, bp->ptr, &bsize) != EOK || bsize < bp->size) {
+                fatal("block is too small", id);
+            }
+            if (((uintptr_t)bp->ptr & (sizeof(void*) - 1)) != 0) {
+                fatal("block is misaligned", id);
+            }
+        }
+
+        if (n % check_interval == 0) {
+            check_info(heap, nids);
+        }
+    }
+    check_info(heap, nids);
+
+
+    // Free everything and make sure that all grown regions were handed back
+    for (int id = 0; id < nids; id++) {
+        if (gBlocks[id].ptr) {
+            check_fill(id);
+            __tlsf_dealloc(heap, gBlocks[id].ptr);
+            gBlocks[id].ptr = NULL;
+        }
+    }
+    if (gReleaseCount != gGrowCount) {
+        fatal("not all grown memory regions were released", -1);
+    }
+    check_info(heap, nids);
+    if (__tlsf_alloc(heap, 16*1024) == NULL) {
+        fatal("initial region did not coalesce", -1);
+    }
+
+    free(mem);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Traces
+////////////////////////////////////////////////////////////////////////////////
+
+// Returns the number of bytes that a live block of 'size' bytes occupies in the
+// heap including the overhead allowance.
+static size_t gross_size(size_t size)
+{
+    const size_t net = (size + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+
+    return ((net > BLOCK_MIN_SIZE) ? net : BLOCK_MIN_SIZE) + BLOCK_OVERHEAD;
+}
+
+// Computes the peak number of live bytes with and without the per-block
+// overhead allowance of the trace 'tp'.
+static void trace_peaks(Trace* _Nonnull tp)
+{
+    size_t live = 0, peak = 0;
+    size_t gross = 0, peak_gross = 0;
+
+    memset(gBlocks, 0, sizeof(gBlocks));
+    for (int i = 0; i < tp->count; i++) {
+        const Op* op = &tp->ops[i];
+        Block* bp = &gBlocks[op->id];
+        const bool isLive = (bp->ptr != NULL);
+
+        switch (op->kind) {
+            case OP_ALLOC:
+                if (!isLive) {
+                    bp->ptr = (unsigned char*)bp;   // Only marks the block as live
+                    bp->size = op->size;
+                    live += bp->size;
+                    gross += gross_size(bp->size);
+                }
+                break;
+
+            case OP_REALLOC:
+                if (isLive) {
+                    live = live - bp->size + op->size;
+                    gross = gross - gross_size(bp->size) + gross_size(op->size);
+                    bp->size = op->size;
+                }
+                break;
+
+            case OP_FREE:
+                if (isLive) {
+                    live -= bp->size;
+                    gross -= gross_size(bp->size);
+                    bp->ptr = NULL;
+                    bp->size = 0;
+                }
+                break;
+        }
+        peak = (live > peak) ? live : peak;
+        peak_gross = (gross > peak_gross) ? gross : peak_gross;
+    }
+    memset(gBlocks, 0, sizeof(gBlocks));
+
+    tp->peak_live = peak;
+    tp->peak_gross = peak_gross;
+}
+
+// Returns a block size drawn from a mix that resembles the kernel heap: many
+// small objects (wait queues, descriptors, channels), some medium sized objects
+// (processes, inodes, dispatch queues) and a few block sized buffers.
+static int32_t kernel_object_size(void)
+{
+    const int r = rand() % 100;
+
+    if (r < 60) {
+        return 8 + (rand() % 15) * 8;
+    }
+    else if (r < 90) {
+        return 128 + rand() % 896;
+    }
+    else if (r < 98) {
+        return (rand() % 2) ? 512 : 4096;
+    }
+    else {
+        return 8192 + rand() % 24576;
+    }
+}
+
+// Returns a block size that resembles lots of small objects like list nodes,
+// strings and descriptors.
+static int32_t small_object_size(void)
+{
+    return 4 + rand() % 61;
+}
+
+// Returns a block size for buffers that are grown and shrunk over and over like
+// string builders, line buffers and dynamic arrays.
+static int32_t buffer_size(void)
+{
+    return 16 << (rand() % 10);
+}
+
+// Returns a block size that is drawn uniformly from [1, 64K].
+static int32_t random_size(void)
+{
+    return 1 + rand() % 65536;
+}
+
+// Generates a trace that keeps about 'nlive' blocks alive. Every round either
+// allocates a new block, resizes a random live block or frees a random live
+// block. One in 'realloc_odds' of the rounds that don't allocate a block resize
+// one. Blocks allocated as part of a burst are freed again in LIFO order like
+// the objects of a system call.
+static void make_trace(Trace* _Nonnull tp, const char* _Nonnull name, int nlive, int realloc_odds, int32_t (*size_func)(void))
+{
+    int live[MAX_IDS];
+    int nlive_now = 0;
+    int next_id = 0;
+    int n = 0;
+
+    memset(gBlocks, 0, sizeof(gBlocks));
+    // Leave room for a burst and for freeing all live blocks at the end
+    while (n + 2 * BURST_IDS + nlive_now < MAX_OPS) {
+        if (nlive_now < nlive && (nlive_now == 0 || rand() % 2 == 0)) {
+            // Find an unused id
+            while (gBlocks[next_id].ptr) {
+                next_id = (next_id + 1) % (MAX_IDS - BURST_IDS);
+            }
+
+            gOps[n++] = (Op){OP_ALLOC, next_id, size_func()};
+            gBlocks[next_id].ptr = (void*)1;
+            live[nlive_now++] = next_id;
+        }
+        else if (rand() % 8 == 0) {
+            // Short lived burst
+            const int nburst = 1 + rand() % BURST_IDS;
+
+            for (int i = 0; i < nburst; i++) {
+                gOps[n++] = (Op){OP_ALLOC, MAX_IDS - 1 - i, size_func()};
+            }
+            for (int i = nburst - 1; i >= 0; i--) {
+                gOps[n++] = (Op){OP_FREE, MAX_IDS - 1 - i, 0};
+            }
+        }
+        else if (rand() % realloc_odds == 0) {
+            const int k = rand() % nlive_now;
+
+            gOps[n++] = (Op){OP_REALLOC, live[k], size_func()};
+        }
+        else {
+            const int k = rand() % nlive_now;
+
+            gOps[n++] = (Op){OP_FREE, live[k], 0};
+            gBlocks[live[k]].ptr = NULL;
+            live[k] = live[--nlive_now];
+        }
+    }
+
+    for (int i = 0; i < nlive_now; i++) {
+        gOps[n++] = (Op){OP_FREE, live[i], 0};
+    }
+
+    tp->name = name;
+    tp->ops = malloc(sizeof(Op) * n);
+    tp->count = n;
+    memcpy(tp->ops, gOps, sizeof(Op) * n);
+    trace_peaks(tp);
+}
+
+static void load_trace(Trace* _Nonnull tp, const char* _Nonnull path)
+{
+    FILE* fp = fopen(path, "r");
+    char kind;
+    int id, size;
+    int n = 0;
+
+    if (fp == NULL) {
+        fprintf(stderr, "allocbench: unable to open '%s'\n", path);
+        exit(EXIT_FAILURE);
+    }
+
+    while (n < MAX_OPS && fscanf(fp, " %c %d", &kind, &id) == 2) {
+        if (id < 0 || id >= MAX_IDS) {
+            fatal("trace: id out of range", id);
+        }
+
+        switch (kind) {
+            case 'a':
+            case 'r':
+                if (fscanf(fp, "%d", &size) != 1 || size < 0) {
+                    fatal("trace: bad size", id);
+                }
+                gOps[n++] = (Op){(kind == 'a') ? OP_ALLOC : OP_REALLOC, id, size};
+                break;
+
+            case 'f':
+                gOps[n++] = (Op){OP_FREE, id, 0};
+                break;
+
+            default:
+                fatal("trace: unknown operation", id);
+        }
+    }
+    fclose(fp);
+
+    tp->name = path;
+    tp->ops = malloc(sizeof(Op) * n);
+    tp->count = n;
+    memcpy(tp->ops, gOps, sizeof(Op) * n);
+    trace_peaks(tp);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark
+////////////////////////////////////////////////////////////////////////////////
+
+// Replays the trace once and returns the number of operations that failed
+// because the allocator could not find a big enough block. Returns the highest
+// address that a block reached in 'pOutTop' if it isn't NULL.
+static int replay(const Allocator* _Nonnull ap, void* _Nonnull self, const Trace* _Nonnull tp, unsigned char* _Nullable * _Nullable pOutTop)
+{
+    unsigned char* top = NULL;
+    int nfailed = 0;
+
+    for (int i = 0; i < tp->count; i++) {
+        const Op* op = &tp->ops[i];
+        Block* bp = &gBlocks[op->id];
+
+        switch (op->kind) {
+            case OP_ALLOC:
+                if (bp->ptr == NULL) {
+                    bp->ptr = ap->alloc(self, op->size);
+                    nfailed += (bp->ptr == NULL) ? 1 : 0;
+                    if (pOutTop && bp->ptr && bp->ptr + op->size > top) {
+                        top = bp->ptr + op->size;
+                    }
+                }
+                break;
+
+            case OP_REALLOC:
+                if (bp->ptr) {
+                    unsigned char* np = ap->realloc(self, bp->ptr, op->size);
+
+                    if (np) {
+                        bp->ptr = np;
+                        if (pOutTop && np + op->size > top) {
+                            top = np + op->size;
+                        }
+                    }
+                    else {
+                        nfailed++;
+                    }
+                }
+                break;
+
+            case OP_FREE:
+                ap->dealloc(self, bp->ptr);
+                bp->ptr = NULL;
+                break;
+        }
+    }
+
+    for (int id = 0; id < MAX_IDS; id++) {
+        if (gBlocks[id].ptr) {
+            ap->dealloc(self, gBlocks[id].ptr);
+            gBlocks[id].ptr = NULL;
+        }
+    }
+
+    if (pOutTop) {
+        *pOutTop = top;
+    }
+    return nfailed;
+}
+
+static double elapsed_kops(clock_t start, long nops)
+{
+    const double secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    return (secs > 0.0) ? nops / secs / 1000.0 : 0.0;
+}
+
+// Measures the throughput with a heap that is big enough for the whole trace.
+// Then replays the trace once more in a heap that is only 25% bigger than the
+// peak number of live bytes plus the per-block overhead and measures the number of failed operations and
+// the footprint. The footprint is the part of the heap that the allocator had
+// to touch to serve the trace. Both show how well the allocator keeps
+// fragmentation in check.
+static void bench(const Trace* _Nonnull tp)
+{
+    static char* arena;
+    Result res[ALLOCATOR_COUNT];
+
+    if (arena == NULL) {
+        arena = malloc(ARENA_SIZE);
+    }
+
+    for (int a = 0; a < ALLOCATOR_COUNT; a++) {
+        const Allocator* ap = &gAllocators[a];
+        void* self = ap->create(arena, ARENA_SIZE);
+        unsigned char* top;
+
+        memset(gBlocks, 0, sizeof(gBlocks));
+        const clock_t start = clock();
+        for (int r = 0; r < ROUNDS; r++) {
+            replay(ap, self, tp, NULL);
+        }
+        res[a].kops = elapsed_kops(start, (long)tp->count * ROUNDS);
+
+
+        const size_t tight_size = tp->peak_gross + tp->peak_gross / 4 + 4096;
+        self = ap->create(arena, (tight_size < ARENA_SIZE) ? tight_size : ARENA_SIZE);
+        res[a].failed = replay(ap, self, tp, &top);
+        res[a].footprint = (top) ? top - (unsigned char*)arena : 0;
+    }
+
+    printf("%-10s  %8d  %10zu", tp->name, tp->count, tp->peak_live);
+    for (int a = 0; a < ALLOCATOR_COUNT; a++) {
+        const size_t frag = (res[a].footprint > tp->peak_live) ? ((res[a].footprint - tp->peak_live) * 100) / res[a].footprint : 0;
+
+        printf("  %10.0f  %6d  %10zu  %4zu%%", res[a].kops, res[a].failed, res[a].footprint, frag);
+    }
+    putchar('\n');
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Fuzzing
+////////////////////////////////////////////////////////////////////////////////
+
+// Runs 'rounds' verification passes with random parameters. Every pass reseeds
+// the random number generator with 'seed' + round number so that a failing pass
+// can be replayed on its own with -f 1 -s <seed + round>.
+static void fuzz(unsigned int seed, int rounds)
+{
+    for (int r = 0; r < rounds; r++) {
+        srand(seed + r);
+
+        const int nids = 1 + rand() % 2048;
+        const int nops = 1000 + rand() % 50000;
+        const size_t max_size = 1 + rand() % 65536;
+        const int check_interval = 1 + rand() % 500;
+
+        printf("fuzz %u: %d ids, %d ops, max size %zu\n", seed + r, nids, nops, max_size);
+        verify(nids, nops, max_size, check_interval);
+    }
+    puts("fuzz: ok");
+}
+
+
+int main(int argc, char* argv[])
+{
+    Trace traces[5];
+    int ntraces = 0;
+    unsigned int seed = 42;
+    int fuzz_rounds = 0;
+    int i = 1;
+
+    while (i < argc && argv[i][0] == '-') {
+        if (i + 1 < argc && !strcmp(argv[i], "-f")) {
+            fuzz_rounds = atoi(argv[i + 1]);
+        }
+        else if (i + 1 < argc && !strcmp(argv[i], "-s")) {
+            seed = (unsigned int)strtoul(argv[i + 1], NULL, 10);
+        }
+        else {
+            fprintf(stderr, "usage: allocbench [-f <rounds>] [-s <seed>] [trace_file]\n");
+            return EXIT_FAILURE;
+        }
+        i += 2;
+    }
+
+    if (fuzz_rounds > 0) {
+        fuzz(seed, fuzz_rounds);
+        return EXIT_SUCCESS;
+    }
+
+    srand(seed);
+
+    verify(64, 200000, 20000, 10000);
+    verify(1024, 200000, 20000, 10000);
+    puts("verify: ok\n");
+
+    if (i < argc) {
+        load_trace(&traces[ntraces++], argv[i]);
+    }
+    else {
+        make_trace(&traces[ntraces++], "kernel", 2000, 16, kernel_object_size);
+        make_trace(&traces[ntraces++], "kernel-lg", 6000, 16, kernel_object_size);
+        make_trace(&traces[ntraces++], "small", 6000, 16, small_object_size);
+        make_trace(&traces[ntraces++], "realloc", 500, 2, buffer_size);
+        make_trace(&traces[ntraces++], "random", 100, 16, random_size);
+    }
+
+    printf("%-10s  %8s  %10s", "trace", "ops", "peak live");
+    for (int a = 0; a < ALLOCATOR_COUNT; a++) {
+        printf("  %5s [k/s]  %6s  %10s  %5s", gAllocators[a].name, "failed", "footprint", "frag");
+    }
+    putchar('\n');
+
+    for (int i = 0; i < ntraces; i++) {
+        bench(&traces[i]);
+    }
+
+    return EXIT_SUCCESS;
+}
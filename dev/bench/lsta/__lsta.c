@@ -68,8 +68,9 @@ typedef struct mem_region {
 struct lsta {
     mem_region_t* _Nonnull      first_region;
     mem_region_t* _Nonnull      last_region;
-    lsta_grow_func_t _Nullable  grow_func;
-    lsta_error_func_t _Nonnull  error_func;
+    lsta_grow_func_t _Nullable      grow_func;
+    lsta_release_func_t _Nullable   release_func;
+    lsta_error_func_t _Nonnull      error_func;
 };
 
 
@@ -137,6 +138,12 @@ static bool mem_region_manages(const mem_region_t* _Nonnull mr, char* _Nullable
     return (addr >= mr->lower && addr < mr->upper) ? true : false;
 }
 
+// Returns true if the given memory region consists of a single free block.
+static bool mem_region_isempty(const mem_region_t* _Nonnull mr)
+{
+    return (((block_header_t*)mr->lower)->size == (mr->upper - mr->lower)) ? true : false;
+}
+
 // Returns the size of the given memory block. This is the size minus the block
 // header and plus whatever additional memory the allocator added based on its
 // internal alignment constraints.
@@ -246,7 +253,12 @@ static bool mem_region_grow_block(mem_region_t* _Nonnull mr, void* _Nonnull ptr,
 
 
     // Calculate the block header, trailer & gross block size of the block
-    // following the 'ptr' block. Ignore if the successor block isn't free.
+    // following the 'ptr' block. Ignore if the successor block isn't free or
+    // 'ptr' is the last block in the region.
+    if ((char*)btrl + sizeof(block_trailer_t) >= mr->upper) {
+        return false;
+    }
+
     block_header_t* succ_hdr = (block_header_t*)((char*)btrl + sizeof(block_trailer_t));
     if (!__validate_block_header(succ_hdr)) {
         goto corruption;
@@ -331,43 +343,55 @@ static bool mem_region_free(mem_region_t* _Nonnull mr, void* _Nonnull ptr)
 
 
     // Calculate the block header, trailer & gross block size of the block in
-    // front of 'ptr'. This one may be freed or allocated.
-    block_trailer_t* pred_trl = (block_trailer_t*)((char*)bhdr - sizeof(block_trailer_t));
-    if (!__validate_block_trailer(pred_trl)) {
-        goto corruption;
-    }
+    // front of 'ptr'. This one may be freed or allocated. There is no
+    // predecessor if 'ptr' is the first block in the region.
+    block_trailer_t* pred_trl = NULL;
+    block_header_t* pred_hdr = NULL;
+
+    if ((char*)bhdr > mr->lower) {
+        pred_trl = (block_trailer_t*)((char*)bhdr - sizeof(block_trailer_t));
+        if (!__validate_block_trailer(pred_trl)) {
+            goto corruption;
+        }
 
-    const word_t gross_pred_size = __abs(pred_trl->size);
-    block_header_t* pred_hdr = (block_header_t*)((char*)pred_trl - gross_pred_size + sizeof(block_trailer_t));
-    if (!__validate_block_header(pred_hdr)) {
-        goto corruption;
+        const word_t gross_pred_size = __abs(pred_trl->size);
+        pred_hdr = (block_header_t*)((char*)pred_trl - gross_pred_size + sizeof(block_trailer_t));
+        if (!__validate_block_header(pred_hdr)) {
+            goto corruption;
+        }
     }
 
 
     // Calculate the block header, trailer & gross block size of the block
-    // following the 'ptr' block. This one may be freed or allocated.
-    block_header_t* succ_hdr = (block_header_t*)((char*)btrl + sizeof(block_trailer_t));
-    if (!__validate_block_header(succ_hdr)) {
-        goto corruption;
-    }
+    // following the 'ptr' block. This one may be freed or allocated. There is
+    // no successor if 'ptr' is the last block in the region.
+    block_header_t* succ_hdr = NULL;
+    block_trailer_t* succ_trl = NULL;
+
+    if ((char*)btrl + sizeof(block_trailer_t) < mr->upper) {
+        succ_hdr = (block_header_t*)((char*)btrl + sizeof(block_trailer_t));
+        if (!__validate_block_header(succ_hdr)) {
+            goto corruption;
+        }
 
-    const word_t gross_succ_size = __abs(succ_hdr->size);
-    block_trailer_t* succ_trl = (block_trailer_t*)((char*)succ_hdr + gross_succ_size - sizeof(block_trailer_t));
-    if (!__validate_block_trailer(succ_trl)) {
-        goto corruption;
+        const word_t gross_succ_size = __abs(succ_hdr->size);
+        succ_trl = (block_trailer_t*)((char*)succ_hdr + gross_succ_size - sizeof(block_trailer_t));
+        if (!__validate_block_trailer(succ_trl)) {
+            goto corruption;
+        }
     }
 
 
     // Figure out the memory configuration:
-    // 0 -> pred & succ are allocated
+    // 0 -> pred & succ are allocated (or don't exist)
     // 1 -> pred allocated; succ freed
     // 2 -> pred freed; succ allocated
     // 3 -> pred & succ freed
     unsigned int config = 0;
-    if (succ_hdr->size >= 0) {
+    if (succ_hdr && succ_hdr->size >= 0) {
         config |= 0x01;
     }
-    if (pred_hdr->size >= 0) {
+    if (pred_hdr && pred_hdr->size >= 0) {
         config |= 0x10;
     }
 
@@ -421,7 +445,7 @@ corruption:
 ////////////////////////////////////////////////////////////////////////////////
 
 // Allocates a new heap.
-lsta_t _Nullable __lsta_create(const mem_desc_t* _Nonnull md, lsta_grow_func_t _Nullable growFunc, lsta_error_func_t _Nonnull errFunc)
+lsta_t _Nullable __lsta_create(const mem_desc_t* _Nonnull md, lsta_grow_func_t _Nullable growFunc, lsta_release_func_t _Nullable releaseFunc, lsta_error_func_t _Nonnull errFunc)
 {
     lsta_t self = NULL;
     mem_region_t* mr = mem_region_create(md, errFunc);
@@ -432,6 +456,7 @@ lsta_t _Nullable __lsta_create(const mem_desc_t* _Nonnull md, lsta_grow_func_t _
             self->first_region = mr;
             self->last_region = mr;
             self->grow_func = growFunc;
+            self->release_func = releaseFunc;
             self->error_func = errFunc;
         }
     }
@@ -456,6 +481,52 @@ static mem_region_t* _Nullable __lsta_getmemregion(lsta_t _Nonnull self, void* _
     return NULL;
 }
 
+// Same as __lsta_getmemregion() but also returns the predecessor of the memory
+// region.
+static mem_region_t* _Nullable __lsta_getmemregion_pred(lsta_t _Nonnull self, void* _Nullable addr, mem_region_t* _Nullable * _Nonnull pOutPred)
+{
+    mem_region_t* pmr = NULL;
+    mem_region_t* mr = self->first_region;
+
+    while (mr) {
+        if (mem_region_manages(mr, addr)) {
+            *pOutPred = pmr;
+            return mr;
+        }
+
+        pmr = mr;
+        mr = mr->next;
+    }
+
+    *pOutPred = NULL;
+    return NULL;
+}
+
+// Removes the empty memory region 'mr' from the allocator and hands it to the
+// release function. 'mr' is put back in place if the release function declines
+// to take it. The first memory region is never released since it stores the
+// allocator itself.
+static void __lsta_releasememregion(lsta_t _Nonnull self, mem_region_t* _Nonnull pmr, mem_region_t* _Nonnull mr)
+{
+    mem_region_t* nmr = mr->next;
+    mem_desc_t md;
+
+    md.lower = (char*)mr;
+    md.upper = mr->upper;
+
+    pmr->next = nmr;
+    if (self->last_region == mr) {
+        self->last_region = pmr;
+    }
+
+    if (!self->release_func(self, &md)) {
+        pmr->next = mr;
+        if (self->last_region == pmr) {
+            self->last_region = mr;
+        }
+    }
+}
+
 bool __lsta_isvalidptr(lsta_t _Nonnull self, void* _Nullable ptr)
 {
     if (ptr == NULL || ((uintptr_t) ptr) == UINTPTR_MAX) {
@@ -533,15 +604,19 @@ errno_t __lsta_dealloc(lsta_t _Nonnull self, void* _Nullable ptr)
     }
     
     // Find out which memory region contains the block that we want to free
-    mem_region_t* mr = __lsta_getmemregion(self, ptr);
+    mem_region_t* pmr;
+    mem_region_t* mr = __lsta_getmemregion_pred(self, ptr, &pmr);
     if (mr == NULL) {
         // 'ptr' isn't managed by this allocator
         return ENOTBLK;
     }
 
 
-    // Tell the memory region to free the memory block
-    mem_region_free(mr, ptr);
+    // Tell the memory region to free the memory block and give the region back
+    // if nothing is allocated from it anymore
+    if (mem_region_free(mr, ptr) && pmr && self->release_func && mem_region_isempty(mr)) {
+        __lsta_releasememregion(self, pmr, mr);
+    }
     
     return EOK;
 }
@@ -576,9 +651,10 @@ void* _Nullable __lsta_realloc(lsta_t _Nonnull self, void * _Nullable ptr, size_
     const size_t old_size = (ptr) ? mem_region_block_size(mr, ptr) : 0;
     if (old_size != new_size) {
         np = __lsta_alloc(self, new_size);
-
-        memcpy(np, ptr, __min(old_size, new_size));
-        __lsta_dealloc(self, ptr);
+        if (np) {
+            memcpy(np, ptr, __min(old_size, new_size));
+            __lsta_dealloc(self, ptr);
+        }
     }
     else {
         np = ptr;
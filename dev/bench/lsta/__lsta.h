@@ -20,8 +20,8 @@ __CPP_BEGIN
 struct lsta;
 typedef struct lsta* lsta_t;
 
-#ifndef _LSTA_MEM_DESC_DEFINED
-#define _LSTA_MEM_DESC_DEFINED 1
+#ifndef _MEM_DESC_DEFINED
+#define _MEM_DESC_DEFINED 1
 // A memory descriptor describes a contiguous range of RAM that should be managed
 // by the allocator.
 typedef struct mem_desc_t {
@@ -41,6 +41,13 @@ typedef struct mem_desc_t {
 // ENOMEM error.
 typedef bool (*lsta_grow_func_t)(lsta_t _Nonnull allocator, size_t minByteCount);
 
+// Callback that is invoked by the allocator when a memory region that was added
+// with __lsta_add_memregion() has become completely free. 'md' is the memory
+// region with its bounds aligned to the allocator's word size. Should return
+// true if the memory region was handed back to its owner and false if the
+// allocator should keep it.
+typedef bool (*lsta_release_func_t)(lsta_t _Nonnull allocator, const mem_desc_t* _Nonnull md);
+
 // Invoked when the memory allocator has detected some kind of heap corruption
 // or severe API misuse.
 typedef void (*lsta_error_func_t)(int err, const char* _Nonnull funcName, void* _Nullable ptr);
@@ -49,7 +56,7 @@ typedef void (*lsta_error_func_t)(int err, const char* _Nonnull funcName, void*
 extern unsigned int    __g_lsta_debug;
 
 
-extern lsta_t _Nullable __lsta_create(const mem_desc_t* _Nonnull md, lsta_grow_func_t _Nullable growFunc, lsta_error_func_t _Nonnull errFunc);
+extern lsta_t _Nullable __lsta_create(const mem_desc_t* _Nonnull md, lsta_grow_func_t _Nullable growFunc, lsta_release_func_t _Nullable releaseFunc, lsta_error_func_t _Nonnull errFunc);
 
 // Adds the given memory region to the allocator's available memory pool.
 extern errno_t __lsta_add_memregion(lsta_t _Nonnull self, const mem_desc_t* _Nonnull md);
@@ -58,7 +65,9 @@ extern void* _Nullable __lsta_alloc(lsta_t _Nonnull self, size_t nbytes);
 extern void* _Nullable __lsta_realloc(lsta_t _Nonnull self, void * _Nullable ptr, size_t new_size);
 
 // Attempts to deallocate the given memory block. Returns EOK on success and
-// ENOTBLK if the allocator does not manage the given memory block.
+// ENOTBLK if the allocator does not manage the given memory block. Invokes the
+// release function if the memory block was the last allocated block in a
+// memory region that was added with __lsta_add_memregion().
 extern errno_t __lsta_dealloc(lsta_t _Nonnull self, void* _Nullable ptr);
 
 // Returns the size of the given memory block. This is the size minus the block
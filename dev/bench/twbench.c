@@ -0,0 +1,237 @@
+//
+//  twbench.c
+//  twbench
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <kern/timerwheel.h>
+
+// Host-side verification and benchmark of the kernel timer wheel. The benchmark
+// compares the wheel against the sorted singly-linked deadline list that the
+// kernel clock used before.
+
+#define MAX_TIMERS  4096
+#define ROUNDS      200
+
+typedef struct Timer {
+    tw_timer_t          tw;
+    struct Timer* _Nullable next;   // Sorted list linkage
+    bool                isArmed;
+} Timer;
+
+static Timer gTimers[MAX_TIMERS];
+
+
+static void fatal(const char* msg, int i)
+{
+    fprintf(stderr, "twbench: %s (timer %d)\n", msg, i);
+    exit(EXIT_FAILURE);
+}
+
+static ticks_t random_delay(void)
+{
+    switch (rand() % 4) {
+        case 0:     return rand() % 32;             // < 32ms
+        case 1:     return rand() % 1024;           // < 1s
+        case 2:     return rand() % 60000;          // < 1min
+        default:    return rand() % 3600000;        // < 1h
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Verification
+////////////////////////////////////////////////////////////////////////////////
+
+// Inserts, cancels and advances timers at random and checks that every timer
+// fires exactly at its deadline and that tw_next_deadline() never overshoots.
+// Runs from 'start' for 'duration' ticks. Pass a 'start' close to TICKS_MAX to
+// check that the wheel handles the tick count wrapping around.
+static void verify(int ntimers, ticks_t start, ticks_t duration)
+{
+    timerwheel_t wheel;
+    ticks_t now = start;
+
+    tw_init(&wheel, now + 1);
+    for (int i = 0; i < ntimers; i++) {
+        gTimers[i].isArmed = false;
+    }
+
+    while (now - start < duration) {
+        // Randomly arm and cancel some timers
+        for (int n = 0; n < 8; n++) {
+            Timer* t = &gTimers[rand() % ntimers];
+
+            if (t->isArmed) {
+                tw_remove(&wheel, &t->tw);
+                t->isArmed = false;
+            }
+            else {
+                t->tw.deadline = now + 1 + random_delay();
+                t->isArmed = true;
+                tw_insert(&wheel, &t->tw);
+            }
+        }
+
+
+        // Jump ahead like a tickless clock would
+        ticks_t earliest = TICKS_MAX;
+        bool hasEarliest = false;
+        for (int i = 0; i < ntimers; i++) {
+            if (gTimers[i].isArmed && (!hasEarliest || ticks_before(gTimers[i].tw.deadline, earliest))) {
+                earliest = gTimers[i].tw.deadline;
+                hasEarliest = true;
+            }
+        }
+
+        const ticks_t next = tw_next_deadline(&wheel);
+        if (hasEarliest && next != TICKS_MAX && ticks_before(earliest, next)) {
+            fatal("next deadline overshoots", -1);
+        }
+        if (next == TICKS_MAX) {
+            now += 1 + rand() % 100;
+        }
+        else {
+            now = (ticks_before(now, next)) ? next : now + 1;
+        }
+
+
+        tw_timer_t* tp = tw_advance(&wheel, now);
+        while (tp) {
+            Timer* t = (Timer*)tp;
+
+            if (!t->isArmed) {
+                fatal("cancelled timer fired", (int)(t - gTimers));
+            }
+            if (t->tw.deadline != now) {
+                fatal("timer fired at the wrong time", (int)(t - gTimers));
+            }
+            t->isArmed = false;
+            tp = tp->next;
+        }
+
+        for (int i = 0; i < ntimers; i++) {
+            if (gTimers[i].isArmed && !ticks_before(now, gTimers[i].tw.deadline)) {
+                fatal("timer did not fire", i);
+            }
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark
+////////////////////////////////////////////////////////////////////////////////
+
+static void list_insert(Timer* _Nullable * _Nonnull pHead, Timer* _Nonnull t)
+{
+    Timer* pp = NULL;
+    Timer* cp = *pHead;
+
+    while (cp && cp->tw.deadline <= t->tw.deadline) {
+        pp = cp;
+        cp = cp->next;
+    }
+
+    if (pp) {
+        t->next = pp->next;
+        pp->next = t;
+    }
+    else {
+        t->next = *pHead;
+        *pHead = t;
+    }
+}
+
+static void list_remove(Timer* _Nullable * _Nonnull pHead, Timer* _Nonnull t)
+{
+    Timer* pp = NULL;
+    Timer* cp = *pHead;
+
+    while (cp) {
+        if (cp == t) {
+            if (pp) {
+                pp->next = cp->next;
+            }
+            else {
+                *pHead = cp->next;
+            }
+            break;
+        }
+
+        pp = cp;
+        cp = cp->next;
+    }
+    t->next = NULL;
+}
+
+static double elapsed_ns_per_op(clock_t start, long nops)
+{
+    return ((double)(clock() - start) / CLOCKS_PER_SEC) * 1.0e9 / nops;
+}
+
+// Measures the cost of inserting and then cancelling 'ntimers' timers with
+// random deadlines. This is the pattern of wait timeouts: most of them are
+// cancelled before they fire.
+static void bench(int ntimers)
+{
+    timerwheel_t wheel;
+    Timer* head = NULL;
+    const long nops = (long)ntimers * ROUNDS * 2;
+    clock_t start;
+
+    for (int i = 0; i < ntimers; i++) {
+        gTimers[i].tw.deadline = 1 + random_delay();
+    }
+
+
+    tw_init(&wheel, 1);
+    start = clock();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (int i = 0; i < ntimers; i++) {
+            tw_insert(&wheel, &gTimers[i].tw);
+        }
+        for (int i = 0; i < ntimers; i++) {
+            tw_remove(&wheel, &gTimers[i].tw);
+        }
+    }
+    const double wheel_ns = elapsed_ns_per_op(start, nops);
+
+
+    start = clock();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (int i = 0; i < ntimers; i++) {
+            list_insert(&head, &gTimers[i]);
+        }
+        for (int i = 0; i < ntimers; i++) {
+            list_remove(&head, &gTimers[i]);
+        }
+    }
+    const double list_ns = elapsed_ns_per_op(start, nops);
+
+    printf("%8d  %12.1f  %12.1f\n", ntimers, wheel_ns, list_ns);
+}
+
+
+int main(int argc, char* argv[])
+{
+    srand(42);
+
+    verify(64, 1000, 4000000);
+    verify(1024, 1000, 400000);
+    verify(64, TICKS_MAX - 2000000, 4000000);
+    puts("verify: ok\n");
+
+    puts("  timers    wheel [ns]     list [ns]");
+    for (int n = 16; n <= MAX_TIMERS; n *= 4) {
+        bench(n);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -623,12 +623,263 @@ static void listLibrary(const char* libPath)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+// Convert Executable
+////////////////////////////////////////////////////////////////////////////////
+
+// GemDOS executable format. See kern/src/process/ldr_gemdos.h
+#define GEMDOS_HDR_SIZE         28
+#define GEMDOS_EXEC_MAGIC       0x601a
+
+// Serena executable format. See kern/h/kpi/sef.h
+#define SEF_SIGNATURE           0x53454620u
+#define SEF_VERSION             1
+#define SEF_HDR_SIZE            104
+#define SEF_SEG_ALIGN_MAX       16
+#define SEF_SEG_TEXT            0
+#define SEF_SEG_DATA            1
+#define SEF_SEG_BSS             2
+#define SEF_SEG_COUNT           3
+#define SEF_RELOC_COUNT         4
+#define SEF_RELOC_SKIP          0xffff
+
+
+typedef struct RelocTable {
+    uint8_t*    bytes;          // First site (32 bit) followed by 16 bit deltas. Big endian
+    size_t      size;
+    size_t      capacity;
+    uint32_t    deltaCount;
+    uint32_t    lastSite;
+    uint32_t    fileOffset;
+} RelocTable;
+
+
+static uint32_t rd16(const uint8_t* p)
+{
+    return ((uint32_t)p[0] << 8) | p[1];
+}
+
+static uint32_t rd32(const uint8_t* p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static void wr32(uint8_t* p, uint32_t val)
+{
+    p[0] = (uint8_t)(val >> 24);
+    p[1] = (uint8_t)(val >> 16);
+    p[2] = (uint8_t)(val >> 8);
+    p[3] = (uint8_t)val;
+}
+
+static uint32_t align_up(uint32_t n, uint32_t align)
+{
+    return (n + align - 1) & ~(align - 1);
+}
+
+static void RelocTable_Append(RelocTable* pTable, uint32_t val, size_t nbytes)
+{
+    if (pTable->size + nbytes > pTable->capacity) {
+        const size_t newCapacity = (pTable->capacity > 0) ? pTable->capacity * 2 : 256;
+        uint8_t* newBytes = malloc_require(newCapacity, false);
+
+        if (pTable->bytes) {
+            memcpy(newBytes, pTable->bytes, pTable->size);
+            free(pTable->bytes);
+        }
+        pTable->bytes = newBytes;
+        pTable->capacity = newCapacity;
+    }
+
+    if (nbytes == 4) {
+        wr32(&pTable->bytes[pTable->size], val);
+    }
+    else {
+        pTable->bytes[pTable->size] = (uint8_t)(val >> 8);
+        pTable->bytes[pTable->size + 1] = (uint8_t)val;
+    }
+    pTable->size += nbytes;
+}
+
+// Adds the relocation site 'site'. Sites must be added in ascending order.
+static void RelocTable_AddSite(RelocTable* pTable, uint32_t site)
+{
+    if (pTable->size == 0) {
+        RelocTable_Append(pTable, site, 4);
+    }
+    else {
+        uint32_t dist = site - pTable->lastSite;
+
+        while (dist > SEF_RELOC_SKIP) {
+            RelocTable_Append(pTable, 0, 2);
+            pTable->deltaCount++;
+            dist -= SEF_RELOC_SKIP;
+        }
+        RelocTable_Append(pTable, dist, 2);
+        pTable->deltaCount++;
+    }
+    pTable->lastSite = site;
+}
+
+// Converts the relocatable GemDOS executable at 'gemdosPath' to a Serena
+// executable and writes it to 'sefPath'. The data segment is placed at the
+// next 2^segAlign boundary following the text segment.
+static void convertExecutable(const char* gemdosPath, const char* sefPath, int segAlign, int stackSize, int heapSize)
+{
+    FILE* fp = open_require(gemdosPath, "rb");
+    fseek(fp, 0, SEEK_END);
+    const long fileSize = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    if (fileSize < GEMDOS_HDR_SIZE) {
+        fatal("'%s': not a GemDOS executable", gemdosPath);
+        // NOT REACHED
+    }
+    if (segAlign < 0 || segAlign > SEF_SEG_ALIGN_MAX || stackSize < 0 || heapSize < 0) {
+        fatal("invalid segment alignment, stack or heap size");
+        // NOT REACHED
+    }
+
+    uint8_t* exe = malloc_require(fileSize, false);
+    fread_require(exe, fileSize, fp);
+    fclose(fp);
+
+
+    // Validate the GemDOS header
+    const uint32_t textSize = rd32(&exe[2]);
+    const uint32_t dataSize = rd32(&exe[6]);
+    const uint32_t bssSize = rd32(&exe[10]);
+    const uint32_t symSize = rd32(&exe[14]);
+    const size_t relocOffset = (size_t)GEMDOS_HDR_SIZE + textSize + dataSize + symSize;
+
+    if (rd16(&exe[0]) != GEMDOS_EXEC_MAGIC || rd16(&exe[26]) != 0 || textSize == 0 || relocOffset + 4 > (size_t)fileSize) {
+        fatal("'%s': not a relocatable GemDOS executable", gemdosPath);
+        // NOT REACHED
+    }
+
+
+    // Re-link the image: text at 0 and data at the next 2^segAlign boundary.
+    // Sort the relocation sites into tables by site and target segment
+    uint8_t* img = &exe[GEMDOS_HDR_SIZE];
+    const uint32_t imgSize = textSize + dataSize;
+    const uint32_t dataLinkAddr = align_up(textSize, 1u << segAlign);
+    const uint8_t* p = &exe[relocOffset];
+    const uint8_t* pe = &exe[fileSize];
+    RelocTable tabs[SEF_RELOC_COUNT];
+    uint32_t site = rd32(p);
+    bool done = (site == 0);
+
+    memset(tabs, 0, sizeof(tabs));
+    p += 4;
+
+    while (!done) {
+        if ((site & 1) != 0 || site + 4 > imgSize) {
+            fatal("'%s': bad relocation site", gemdosPath);
+            // NOT REACHED
+        }
+
+        const int siteSeg = (site < textSize) ? SEF_SEG_TEXT : SEF_SEG_DATA;
+        const uint32_t target = rd32(&img[site]);
+        const int targetSeg = (target < textSize) ? SEF_SEG_TEXT : SEF_SEG_DATA;
+
+        if (targetSeg == SEF_SEG_DATA) {
+            wr32(&img[site], dataLinkAddr + (target - textSize));
+        }
+        RelocTable_AddSite(&tabs[siteSeg * 2 + targetSeg], (siteSeg == SEF_SEG_TEXT) ? site : site - textSize);
+
+
+        // Find the next site
+        for (;;) {
+            if (p == pe) {
+                fatal("'%s': bad relocation information", gemdosPath);
+                // NOT REACHED
+            }
+
+            const uint8_t b = *p++;
+            if (b == 0) {
+                done = true;
+                break;
+            }
+            else if (b == 1) {
+                site += 254;
+            }
+            else {
+                site += b;
+                break;
+            }
+        }
+    }
+
+
+    // Lay out the file: header, text, data, relocation tables
+    const uint32_t textOffset = SEF_HDR_SIZE;
+    const uint32_t dataOffset = align_up(textOffset + textSize, 4);
+    uint32_t offset = align_up(dataOffset + dataSize, 4);
+
+    for (int i = 0; i < SEF_RELOC_COUNT; i++) {
+        if (tabs[i].size > 0) {
+            tabs[i].fileOffset = offset;
+            offset = align_up(offset + tabs[i].size, 4);
+        }
+    }
+
+
+    // Write the Serena executable
+    const uint32_t segs[SEF_SEG_COUNT][3] = {
+        { textOffset, textSize, textSize },
+        { dataOffset, dataSize, dataSize },
+        { 0, 0, bssSize }
+    };
+    uint8_t* sef = malloc_require(offset, true);
+    uint8_t* hp = sef;
+
+    wr32(hp, SEF_SIGNATURE); hp += 4;
+    wr32(hp, SEF_VERSION); hp += 4;
+    wr32(hp, SEF_HDR_SIZE); hp += 4;
+    wr32(hp, 0); hp += 4;               // flags
+    wr32(hp, segAlign); hp += 4;
+    wr32(hp, 0); hp += 4;               // load address
+    wr32(hp, 0); hp += 4;               // entry offset
+    wr32(hp, stackSize); hp += 4;
+    wr32(hp, heapSize); hp += 4;
+    for (int i = 0; i < SEF_SEG_COUNT; i++) {
+        for (int j = 0; j < 3; j++) {
+            wr32(hp, segs[i][j]); hp += 4;
+        }
+    }
+    for (int i = 0; i < SEF_RELOC_COUNT; i++) {
+        wr32(hp, tabs[i].fileOffset); hp += 4;
+        wr32(hp, tabs[i].deltaCount); hp += 4;
+    }
+    assert(hp - sef == SEF_HDR_SIZE);
+
+    memcpy(&sef[textOffset], img, textSize);
+    memcpy(&sef[dataOffset], img + textSize, dataSize);
+    for (int i = 0; i < SEF_RELOC_COUNT; i++) {
+        if (tabs[i].size > 0) {
+            memcpy(&sef[tabs[i].fileOffset], tabs[i].bytes, tabs[i].size);
+        }
+        free(tabs[i].bytes);
+    }
+
+    fp = open_require(sefPath, "wb");
+    fwrite_require(sef, offset, fp);
+    fclose(fp);
+
+    free(sef);
+    free(exe);
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 // main
 ////////////////////////////////////////////////////////////////////////////////
 
 clap_string_array_t paths = {NULL, 0};
 const char* cmd_id = "";
+int seg_align = 2;
+int stack_size = 0;
+int heap_size = 0;
 
 CLAP_DECL(params,
     CLAP_VERSION("1.0"),
@@ -638,6 +889,11 @@ CLAP_DECL(params,
     CLAP_REQUIRED_COMMAND("create", &cmd_id, "<lib_path> <obj_path ...>", "Builds a new static library from a list of object files. Replaces the library file at 'lib_path' if it already exists."),
         CLAP_VARARG(&paths),
     CLAP_REQUIRED_COMMAND("list", &cmd_id, "<lib_path>", "Lists all object files stored in the library file."),
+        CLAP_VARARG(&paths),
+    CLAP_REQUIRED_COMMAND("convert", &cmd_id, "<gemdos_path> <sef_path>", "Converts a relocatable GemDOS executable to a Serena executable."),
+        CLAP_INT('a', "align", &seg_align, "Align the data segment at a 2^n byte boundary (default: 2)"),
+        CLAP_INT('s', "stack-size", &stack_size, "Main vcpu stack size hint in bytes (default: system default)"),
+        CLAP_INT('m', "heap-size", &heap_size, "Initial heap size hint in bytes (default: system default)"),
         CLAP_VARARG(&paths)
 );
 
@@ -665,6 +921,13 @@ int main(int argc, char* argv[])
             listLibrary(paths.strings[i]);
         }
     }
+    else if (!strcmp("convert", cmd_id)) {
+        if (paths.count != 2) {
+            fatal("expected a GemDOS executable path and a Serena executable path");
+            // not reached
+        }
+        convertExecutable(paths.strings[0], paths.strings[1], seg_align, stack_size, heap_size);
+    }
 
     return EXIT_SUCCESS;
 }
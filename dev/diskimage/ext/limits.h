@@ -25,7 +25,7 @@
 #define SIZE_WIDTH  64
 #endif
 
-#if defined(__APPLE__)
+#if defined(__APPLE__) || defined(__linux__)
 #if defined(__LP64__)
 #define SSIZE_MIN   0x8000000000000000l
 #define SSIZE_MAX   0x7fffffffffffffffl
@@ -9,6 +9,7 @@
 #ifndef _DI_TYPES_H
 #define _DI_TYPES_H 1
 
+#include <limits.h>
 #include <stddef.h>
 #include <kpi/_time.h>
 #ifdef _WIN32
@@ -16,7 +17,7 @@
 typedef SSIZE_T ssize_t;
 #endif
 
-#if defined(__APPLE__)
+#if defined(__APPLE__) || defined(__linux__)
 #if defined(__LP64__)
 typedef signed long long ssize_t;
 #else
@@ -70,9 +71,11 @@ typedef struct chs {
 
 // Time unit of the scheduler clock which increments monotonically and once per clock interrupt
 #if defined(__LLP64__) || defined(__LP64__)
-typedef long long   ticks_t;
+typedef unsigned long long  ticks_t;
+#define TICKS_MAX   ULLONG_MAX
 #else
-typedef long    ticks_t;
+typedef unsigned long   ticks_t;
+#define TICKS_MAX   ULONG_MAX
 #endif
 
 #endif /* _DI_TYPES_H */
@@ -10,9 +10,11 @@
 #define _KERN_KALLOC_H 1
 
 #include <stddef.h>
+#include <stdint.h>
 #include <ext/try.h>
 
 struct mem_desc;
+struct mtx_stats;
 struct sys_desc;
 
 
@@ -21,11 +23,80 @@ struct sys_desc;
 #define KALLOC_OPTION_UNIFIED    1
 // Clear the allocated memory block
 #define KALLOC_OPTION_CLEAR      2
+// Charge the allocated memory block to the subsystem '__tag'
+#define KALLOC_OPTION_TAG(__tag) (((unsigned int)(__tag)) << 8)
+
+#define KALLOC_OPTION_GETTAG(__options) \
+((int)(((__options) >> 8) & 0xff))
+
+
+// Memory tags. A tagged block is charged to its subsystem from the time it is
+// allocated until it is freed. A tagged block records its tag instead of its
+// allocation site.
+#define KALLOC_TAG_NONE         0
+#define KALLOC_TAG_DISK_CACHE   1
+#define KALLOC_TAG_PROCESS      2
+#define KALLOC_TAG_GRAPHICS     3
+#define KALLOC_TAG_DISPATCH     4
+#define KALLOC_TAG_FILESYSTEM   5
+#define KALLOC_TAG_COUNT        6
+
+
+// Set to 1 to record the source location of every kalloc() call in the block
+// that it allocates. The locations show up in the heap dump. Costs one word per
+// block.
+#ifndef KALLOC_TRACK_SITES
+#define KALLOC_TRACK_SITES  0
+#endif
+
+#define __KALLOC_STR(__x) #__x
+#define __KALLOC_XSTR(__x) __KALLOC_STR(__x)
+
+#if KALLOC_TRACK_SITES
+#define KALLOC_SITE __FILE__ ":" __KALLOC_XSTR(__LINE__)
+#else
+#define KALLOC_SITE NULL
+#endif
+
+
+// Number of request size classes in kalloc_stats_t. Class i counts requests of
+// [2^i, 2^(i+1)) bytes and the last class counts all bigger requests.
+#define KALLOC_SIZE_CLASS_COUNT 16
+
+typedef struct kalloc_stats {
+    size_t      used_bytes;         // Allocated bytes including block headers
+    size_t      peak_used_bytes;
+    size_t      free_bytes;
+    size_t      largest_free_size;  // Biggest block that can be allocated
+    size_t      used_block_count;
+    size_t      free_block_count;
+    int         region_count;
+    uint32_t    allocs;
+    uint32_t    frees;
+    uint32_t    fallback_allocs;    // CPU-only requests that had to be placed in unified memory
+    uint32_t    allocs_per_class[KALLOC_SIZE_CLASS_COUNT];
+} kalloc_stats_t;
+
+typedef struct kalloc_tag_stats {
+    size_t      unified_bytes;      // Allocated bytes in unified memory
+    size_t      cpu_bytes;          // Allocated bytes in CPU-only memory
+    size_t      peak_bytes;
+    size_t      block_count;
+    uint32_t    allocs;
+    uint32_t    failures;
+} kalloc_tag_stats_t;
 
 
 // Allocates memory from the kernel heap. Returns NULL if the memory could not be
 // allocated. 'options' is a combination of the HEAP_ALLOC_OPTION_XXX flags.
-extern errno_t kalloc_options(size_t nbytes, unsigned int options, void* _Nullable * _Nonnull pOutPtr);
+// Requests that don't ask for unified memory are placed in CPU-only memory if
+// possible and fall back to unified memory. A fallback leaves a quarter of the
+// unified memory to the chipset unless the kernel runs out of memory otherwise.
+// 'site' is recorded in the block if it isn't NULL.
+extern errno_t kalloc_options_site(size_t nbytes, unsigned int options, const char* _Nullable site, void* _Nullable * _Nonnull pOutPtr);
+
+#define kalloc_options(__nbytes, __options, __pOutPtr) \
+kalloc_options_site(__nbytes, __options, KALLOC_SITE, __pOutPtr)
 
 // Allocates uninitialized CPU-accessible memory from the kernel heap. Returns
 // NULL if the memory could not be allocated. The returned memory is not
@@ -42,6 +113,10 @@ kalloc_options(__nbytes, KALLOC_OPTION_CLEAR, __pOutPtr)
 #define kalloc_unified(__nbytes, __pOutPtr) \
 kalloc_options(__nbytes, KALLOC_OPTION_UNIFIED, __pOutPtr)
 
+// Same as kalloc() but charges the allocated memory to the subsystem '__tag'.
+#define kalloc_tagged(__nbytes, __tag, __pOutPtr) \
+kalloc_options(__nbytes, KALLOC_OPTION_TAG(__tag), __pOutPtr)
+
 // Frees kernel memory allocated with the kalloc() function.
 extern void kfree(void* _Nullable ptr);
 
@@ -49,6 +124,27 @@ extern void kfree(void* _Nullable ptr);
 // bigger than what was originally requested, because of alignment constraints.
 extern size_t ksize(void* _Nullable ptr);
 
+// Returns the statistics of the unified memory heap if 'options' includes
+// KALLOC_OPTION_UNIFIED and the statistics of the CPU-only memory heap
+// otherwise. Returns ENODEV if the machine has no CPU-only memory.
+extern errno_t kalloc_getstats(unsigned int options, kalloc_stats_t* _Nonnull pOutStats);
+
+// Returns the memory that is currently charged to the subsystem 'tag'. Returns
+// EINVAL if 'tag' is not a valid memory tag.
+extern errno_t kalloc_gettagstats(int tag, kalloc_tag_stats_t* _Nonnull pOutStats);
+
+// Returns the name of the memory tag 'tag'.
+extern const char* _Nonnull kalloc_tagname(int tag);
+
+// Returns the contention statistics of the kernel heap lock.
+extern void kalloc_getlockstats(struct mtx_stats* _Nonnull pOutStats);
+
+// Invokes 'func' for every allocated block of the kernel heap. 'site' is the
+// name of the memory tag of a tagged block, the location of the kalloc() call
+// if KALLOC_TRACK_SITES is enabled and NULL otherwise. The kernel heap is
+// locked while this function runs and 'func' must not allocate or free memory.
+extern void kalloc_visit(void (*func)(void* _Nullable ctx, void* _Nonnull ptr, size_t size, const char* _Nullable site), void* _Nullable ctx);
+
 // Adds the given memory region as a CPU-only access memory region to the kalloc
 // heap.
 extern errno_t kalloc_add_memory_region(const struct mem_desc* _Nonnull md);
@@ -0,0 +1,91 @@
+//
+//  kern/kcache.h
+//  kernel
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#ifndef _KERN_KCACHE_H
+#define _KERN_KCACHE_H 1
+
+#include <stddef.h>
+#include <stdint.h>
+#include <ext/try.h>
+#include <kern/kalloc.h>
+
+
+// An object cache hands out fixed-size objects that are carved out of slabs.
+// A slab is a single kalloc() block that holds a number of objects. Allocating
+// and freeing an object just pops/pushes it from/to the free list of its slab.
+// Slabs that have become completely free are kept around for reuse until the
+// cache holds more than KCACHE_MAX_EMPTY_SLABS of them or the kernel heap runs
+// out of memory and asks all caches to give their empty slabs back.
+//
+// The optional constructor is invoked once for every object when its slab is
+// created. Objects should be returned to the cache in their constructed state.
+typedef struct kcache* kcache_t;
+
+typedef void (*kcache_ctor_t)(void* _Nonnull obj);
+
+
+// kcache_create options
+// Allocate slabs from unified memory (accessible to CPU and the chipset)
+#define KCACHE_OPTION_UNIFIED   1
+// Charge the slabs to the subsystem '__tag' (see KALLOC_TAG_XXX)
+#define KCACHE_OPTION_TAG(__tag) KALLOC_OPTION_TAG(__tag)
+
+
+// Number of completely free slabs that a cache keeps around
+#define KCACHE_MAX_EMPTY_SLABS  1
+
+// Preferred slab size. A slab holds at least KCACHE_MIN_SLAB_OBJS objects
+#define KCACHE_SLAB_SIZE        4096
+#define KCACHE_MIN_SLAB_OBJS    8
+
+
+typedef struct kcache_stats {
+    size_t      obj_size;           // Object size as requested
+    size_t      slab_size;          // Gross size of a slab
+    int         objs_per_slab;
+    int         slab_count;         // Slabs currently owned by the cache
+    int         empty_slab_count;   // Slabs without any allocated objects
+    int         objs_in_use;
+    uint32_t    allocs;
+    uint32_t    frees;
+    uint32_t    slab_allocs;
+    uint32_t    slab_frees;
+    uint32_t    failures;           // Allocations that failed because no new slab could be allocated
+} kcache_stats_t;
+
+
+// Creates an object cache for objects of size 'objSize'. 'name' must point to
+// a string that stays valid for the lifetime of the cache.
+extern errno_t kcache_create(const char* _Nonnull name, size_t objSize, kcache_ctor_t _Nullable ctor, unsigned int options, kcache_t _Nullable * _Nonnull pOutSelf);
+
+// Destroys the cache and frees all of its slabs. All objects must have been
+// returned to the cache.
+extern void kcache_destroy(kcache_t _Nullable self);
+
+// Allocates an object from the cache. The object is in its constructed state if
+// the cache has a constructor and uninitialized otherwise.
+extern errno_t kcache_alloc(kcache_t _Nonnull self, void* _Nullable * _Nonnull pOutPtr);
+
+// Returns the object 'ptr' to the cache that it was allocated from.
+extern void kcache_free(kcache_t _Nonnull self, void* _Nullable ptr);
+
+// Frees all slabs of the cache that do not hold any allocated objects. Returns
+// the number of bytes that were given back to the kernel heap.
+extern size_t kcache_reclaim(kcache_t _Nonnull self);
+
+// Reclaims the empty slabs of all caches. Invoked by kalloc() when it runs out
+// of memory.
+extern size_t kcache_reclaim_all(void);
+
+// Returns a snapshot of the statistics of the cache.
+extern void kcache_getstats(kcache_t _Nonnull self, kcache_stats_t* _Nonnull pOutStats);
+
+// Returns the name of the cache.
+extern const char* _Nonnull kcache_name(kcache_t _Nonnull self);
+
+#endif /* _KERN_KCACHE_H */
@@ -0,0 +1,80 @@
+//
+//  timerwheel.h
+//  kernel
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#ifndef _TIMERWHEEL_H
+#define _TIMERWHEEL_H
+
+#include <stdint.h>
+#include <kpi/types.h>
+
+
+// A hierarchical timer wheel. Inserting and removing a timer are constant time
+// operations. The wheel has TW_LEVEL_COUNT levels of TW_SLOT_COUNT slots each.
+// A slot on level L covers 2^(L * TW_LEVEL_SHIFT) ticks. A timer is stored on
+// the lowest level that is able to represent its distance from the current
+// wheel time. Timers on levels > 0 are moved down to a lower level ("cascaded")
+// when the wheel time reaches the start of their slot. Timers that are due
+// further out than the wheel is able to represent are parked in the last slot
+// of the highest level and re-filed when they are cascaded.
+// See: <http://www.cs.columbia.edu/~nahum/w6998/papers/sosp87-timing-wheels.pdf>
+#define TW_LEVEL_SHIFT  5
+#define TW_SLOT_COUNT   32
+#define TW_SLOT_MASK    31
+#define TW_LEVEL_COUNT  4
+
+
+// Returns true if the tick value 'a' comes before the tick value 'b'. The tick
+// counter wraps around. Tick values are therefore compared by their distance,
+// which gives the right answer as long as they are less than TICKS_MAX / 2
+// ticks apart.
+#define ticks_before(__a, __b) \
+((ticks_t)((__a) - (__b)) > TICKS_MAX / 2)
+
+
+typedef struct tw_timer {
+    struct tw_timer* _Nullable  next;
+    struct tw_timer* _Nullable  prev;
+    ticks_t                     deadline;   // Absolute time in ticks when the timer is due
+    uint8_t                     level;      // Level and slot the timer is filed under
+    uint8_t                     slot;
+    uint8_t                     reserved[2];
+} tw_timer_t;
+
+
+typedef struct timerwheel {
+    ticks_t                 time;                                       // Next tick that tw_advance() will process
+    uint32_t                populated[TW_LEVEL_COUNT];                  // Bit (31 - i) is set if slot i on the level is not empty
+    tw_timer_t* _Nullable   slot[TW_LEVEL_COUNT][TW_SLOT_COUNT];
+} timerwheel_t;
+
+
+// Initializes the timer wheel to empty. 'now' is the first tick that the wheel
+// will process.
+extern void tw_init(timerwheel_t* _Nonnull self, ticks_t now);
+
+// Inserts the timer 't' into the wheel. The 'deadline' field of the timer must
+// have been initialized. A timer with a deadline that is in the past is due at
+// the next tick that the wheel processes.
+extern void tw_insert(timerwheel_t* _Nonnull self, tw_timer_t* _Nonnull t);
+
+// Removes the timer 't' from the wheel. 't' must be in the wheel.
+extern void tw_remove(timerwheel_t* _Nonnull self, tw_timer_t* _Nonnull t);
+
+// Advances the wheel time to 'now' and removes all timers that are due at or
+// before 'now'. Returns the due timers as a list that is linked through the
+// 'next' field. The order of the timers in the list is undefined.
+extern tw_timer_t* _Nullable tw_advance(timerwheel_t* _Nonnull self, ticks_t now);
+
+// Returns the earliest tick at which tw_advance() has to be called to ensure
+// that no timer fires late. This is a lower bound for the earliest deadline in
+// the wheel. Returns TICKS_MAX if the wheel is empty. Note that TICKS_MAX is
+// also returned if the earliest deadline happens to be the tick TICKS_MAX.
+// Callers must thus call tw_advance() at least once per wheel rotation.
+extern ticks_t tw_next_deadline(const timerwheel_t* _Nonnull self);
+
+#endif /* _TIMERWHEEL_H */
@@ -44,6 +44,11 @@
 #define FD_FOP_REMOVE   3
 
 
+// fd_sync() flags
+#define FD_SYNC_DATA    1   /* Only flush the file data and the metadata that is needed to read the data back */
+#define FD_SYNC_PURGE   2   /* Drop the file data from the disk cache once it has been written */
+
+
 // Descriptor types.
 #define FD_TYPE_INVALID     -1
 #define FD_TYPE_TERMINAL    0
@@ -12,6 +12,7 @@
 #include <_cmndef.h>
 #include <ext/nanotime.h>
 #include <kpi/types.h>
+#include <kpi/vcpu.h>
 #include <machine/cpu.h>
 
 // Information about a host
@@ -45,12 +46,40 @@ typedef struct host_rescounts_info {
 
 
 
+// One entry of a process snapshot as returned by host_procsnap(). All entries
+// of a snapshot are taken in a single pass over the process table.
+#define PROC_SNAPSHOT_NAME_MAX  32
+
+typedef struct proc_snapshot {
+    pid_t       pid;
+    pid_t       ppid;
+    pid_t       pgrp;
+    pid_t       sid;
+    uid_t       uid;
+
+    int         run_state;                      // PROC_STATE_XXX
+
+    size_t      vcpu_count;                     // number of vcpus bound to the process
+    size_t      vcpu_waiting_count;             // number of vcpus bound to the process and in waiting or suspended state
+
+    uint64_t    vm_size;                        // size of process address space in bytes
+
+    nanotime_t  creation_time;                  // time when the process was created
+    nanotime_t  user_time;                      // time the process has spent running in user mode across all its vcpus
+    nanotime_t  system_time;                    // time the process has spent running in system mode across all its vcpus
+
+    char        name[PROC_SNAPSHOT_NAME_MAX];   // same as PROC_PROP_NAME; truncated if needed
+} proc_snapshot_t;
+
+
+
 // Information about a logical CPU
 typedef void* cpu_info_ref;
 
 #define CPU_INFO_BASIC          1
 #define CPU_INFO_UTILIZATION    2
 #define CPU_INFO_LOAD_AVGS      3   /* Not yet */
+#define CPU_INFO_SCHED_STATS    4
 
 
 typedef struct cpu_basic_info {
@@ -71,6 +100,31 @@ typedef struct cpu_utilization_info {
 } cpu_utilization_info_t;
 
 
+// Number of buckets in a scheduler histogram. Bucket i counts samples with a
+// duration in the range [2^i, 2^(i+1)) clock cycles. Bucket 0 additionally
+// counts samples with a duration of 0 and the last bucket counts all samples
+// that are longer than what the buckets before it cover.
+#define SCHED_HIST_BUCKET_COUNT 24
+
+// Scheduler statistics of a single QoS grade. A vcpu is accounted to the grade
+// of its effective priority. Counters wrap around on overflow.
+typedef struct cpu_sched_qos_stats {
+    uint32_t    dispatches;             // number of times a vcpu was given the CPU
+    uint32_t    wakeups;                // number of times a vcpu was made ready after waiting
+    uint32_t    preemptions;            // number of times a running vcpu was preempted by a higher priority vcpu
+    uint32_t    quantum_expirations;    // number of times a running vcpu used up its quantum
+    uint32_t    rq_len_max;             // longest ready queue seen at dispatch time
+    uint32_t    rq_len_sum;             // sum of the ready queue lengths seen at dispatch time. Divide by 'dispatches' for the average
+    uint32_t    wakeup_latency[SCHED_HIST_BUCKET_COUNT];    // time from wakeup until the vcpu is running
+    uint32_t    run_time[SCHED_HIST_BUCKET_COUNT];          // time a vcpu ran per dispatch
+} cpu_sched_qos_stats_t;
+
+typedef struct cpu_sched_stats_info {
+    int32_t                 cycle_ns;               // duration of a histogram clock cycle in nanoseconds
+    cpu_sched_qos_stats_t   qos[VCPU_QOS_COUNT];    // indexed by QoS grade - 1
+} cpu_sched_stats_info_t;
+
+
 //XXX NOT YET
 //		-- sched info
 //          --- scheduler clock id
@@ -27,7 +27,7 @@
 #define _SPAWN_GID          4
 #define _SPAWN_SUSPENDED    8
 
-#define _SPAWNATTR_VERSION  1
+#define _SPAWNATTR_VERSION  2
 
 
 typedef struct proc_spawnattr {
@@ -40,6 +40,7 @@ typedef struct proc_spawnattr {
     unsigned int    flags;
     int             quantum_boost;
     int             nice;
+    size_t          stack_size;     // user stack size of the main vcpu; 0 -> use the size requested by the executable
 } proc_spawnattr_t;
 
 
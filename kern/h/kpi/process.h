@@ -19,9 +19,10 @@
 
 // proc_ctx_t aux array entry types. Ignore types that you don't recognize. The
 // array is terminated with a AT_END entry.
-#define AT_END      0
-#define AT_EXEC_HDR 1   /* Pointer to the executable header */
-#define AT_KEI      2   /* Pointer to the KEI function table */
+#define AT_END          0
+#define AT_EXEC_HDR     1   /* Pointer to the executable header */
+#define AT_KEI          2   /* Pointer to the KEI function table */
+#define AT_HEAP_SIZE    3   /* Initial heap size hint in bytes. 0 -> default */
 
 typedef struct proc_aux_entry {
     int     type;
@@ -90,6 +91,7 @@ typedef struct proc_basic_info {
     size_t          vcpu_count;             // number of vcpus bound to process right now
     size_t          vcpu_lifetime_count;    // number of vcpus that have been bound to the process over its whole lifetime. Includes no longer acquired vcpus
     size_t          vcpu_waiting_count;     // number of vcpus that are currently bound to the process and in waiting or suspended state
+    size_t          vcpu_stack_peak;        // largest number of user stack bytes used by a vcpu that has been relinquished by the process
 } proc_basic_info_t;
 
 
@@ -0,0 +1,64 @@
+//
+//  kpi/scring.h
+//  kpi
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#ifndef _KPI_SCRING_H
+#define _KPI_SCRING_H 1
+
+#include <_cmndef.h>
+#include <stdint.h>
+
+__CPP_BEGIN
+
+// A system call ring allows a process to queue up a sequence of system calls
+// and to have the kernel execute all of them with a single trap. The ring
+// lives in process memory. It consists of a submission queue and a completion
+// queue. Both queues have the same number of entries and this number must be a
+// power of 2.
+//
+// The process fills in submission queue entries at 'sq_tail' and then invokes
+// scring_enter(). The kernel executes the queued system calls in order,
+// advances 'sq_head' past every entry it has consumed and posts one completion
+// entry per consumed submission at 'cq_tail'. The process consumes completions
+// by advancing 'cq_head'. The kernel stops consuming submissions when the
+// completion queue is full or the calling vcpu has been aborted.
+//
+// Only system calls that do not change the execution state of the calling vcpu
+// or process may be queued. Submitting any other system call produces a
+// completion with an ENOSYS result.
+
+#define SCRING_MAX_ENTRIES  256
+#define SCRING_MAX_ARGS     6
+
+
+typedef struct scring_sqe {
+    int         scno;                       // SC_xxx system call number
+    int         reserved;
+    intptr_t    udata;                      // Copied as-is to the completion entry
+    intptr_t    args[SCRING_MAX_ARGS];      // System call arguments. Same layout as the arguments passed to _syscall(). A 64 bit argument takes up two slots
+} scring_sqe_t;
+
+
+typedef struct scring_cqe {
+    intptr_t    udata;                      // udata from the submission entry
+    intptr_t    result;                     // Error code for system calls that return an errno; return value otherwise
+} scring_cqe_t;
+
+
+typedef struct scring {
+    volatile unsigned int           sq_head;    // Next submission the kernel will consume
+    volatile unsigned int           sq_tail;    // Next submission slot the process will fill in
+    volatile unsigned int           cq_head;    // Next completion the process will consume
+    volatile unsigned int           cq_tail;    // Next completion slot the kernel will fill in
+    unsigned int                    mask;       // Number of entries - 1
+    scring_sqe_t* _Nonnull          sqes;
+    scring_cqe_t* _Nonnull          cqes;
+} scring_t;
+
+__CPP_END
+
+#endif /* _KPI_SCRING_H */
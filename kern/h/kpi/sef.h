@@ -0,0 +1,75 @@
+//
+//  sef.h
+//  kpi
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#ifndef _KPI_SEF_H
+#define _KPI_SEF_H 1
+
+#include <stdint.h>
+
+#define SEF_SIGNATURE   0x53454620ul
+#define SEF_VERSION     1
+
+
+// Segments
+// The data segment follows the text segment in memory at the next
+// 2^seg_align boundary. The BSS segment directly follows the data segment. The
+// BSS segment occupies no bytes in the file. A segment is zero-filled from
+// 'file_size' up to 'mem_size'.
+#define SEF_SEG_TEXT    0
+#define SEF_SEG_DATA    1
+#define SEF_SEG_BSS     2
+#define SEF_SEG_COUNT   3
+
+typedef struct sef_seg {
+    uint32_t    file_offset;
+    uint32_t    file_size;
+    uint32_t    mem_size;
+} sef_seg_t;
+
+
+// Relocation tables
+// Relocations are grouped by the segment that contains the relocation site and
+// the segment the site points to. A site is a 32 bit word that holds the link
+// address of its target. The loader adds the difference between the load and
+// link address of the target segment to it. The text segment is linked at
+// 'load_addr' and the data segment at the following 2^seg_align boundary.
+// Sites that point to the BSS segment are data segment sites.
+//
+// A relocation table consists of a 32 bit offset of the first site relative to
+// the start of its segment, followed by 'delta_count' 16 bit deltas. Each delta
+// is the distance from the previous site. A delta of 0 advances by 0xffff
+// bytes without relocating anything.
+#define SEF_RELOC_TEXT_TO_TEXT  0
+#define SEF_RELOC_TEXT_TO_DATA  1
+#define SEF_RELOC_DATA_TO_TEXT  2
+#define SEF_RELOC_DATA_TO_DATA  3
+#define SEF_RELOC_COUNT         4
+
+typedef struct sef_reloc {
+    uint32_t    file_offset;    // 0 -> no relocations
+    uint32_t    delta_count;
+} sef_reloc_t;
+
+
+// Serena executable file header
+// Data is stored big endian (network byte order)
+typedef struct sef_hdr {
+    uint32_t    signature;
+    uint32_t    version;
+    uint32_t    hdr_size;                   // Size including the signature
+    uint32_t    flags;
+    uint32_t    seg_align;                  // log2 of the alignment of the data segment
+    uint32_t    load_addr;                  // Preferred load address. Relocation is skipped if the executable lands there
+    uint32_t    entry_offset;               // Offset of the entry point relative to the start of the text segment
+    uint32_t    stack_size;                 // Main vcpu stack size hint. 0 -> system default
+    uint32_t    heap_size;                  // Initial heap size hint. 0 -> system default
+    sef_seg_t   seg[SEF_SEG_COUNT];
+    sef_reloc_t reloc[SEF_RELOC_COUNT];
+} sef_hdr_t;
+
+#endif /* _KPI_SEF_H */
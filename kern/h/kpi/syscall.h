@@ -59,14 +59,14 @@ enum {
     SC_fs_settimes,         // errno_t fs_settimes(int, const char* _Nonnull path, const nanotime_t times[_Nullable 2])
     SC_vcpu_yield,          // void vcpu_yield(void)
     SC_fd_type,             // errno_t fd_type(int fd, int* _Nonnull type)
-    SC_unused_3,            // UNUSED
-    SC_unused_4,            // UNUSED
-    SC_unused_5,            // UNUSED
+    SC_fd_sync,             // errno_t fd_sync(int fd, int flags)
+    SC_scring_enter,        // errno_t scring_enter(scring_t* _Nonnull ring, int* _Nonnull pOutCount)
+    SC_vm_deallocate,       // errno_t vm_deallocate(void* _Nonnull ptr, size_t nbytes)
     SC_proc_info,           // int proc_info(pid_t id, int flavor, proc_info_ref _Nonnull info)
     SC_sig_route,           // int sig_route(int op, int signo, int target, id_t id)
     SC_vcpu_getdata,        // intptr_t __vcpu_getdata(void)
     SC_vcpu_setdata,        // void __vcpu_setdata(intptr_t data)
-    SC_unused_6,            // UNUSED
+    SC_host_procsnap,       // errno_t host_procsnap(proc_snapshot_t* _Nonnull buf, size_t bufSize, size_t* _Nonnull pOutCount, int* _Nonnull out_hasMore)
     SC_sig_wait,            // int sig_wait(const sigset_t* _Nonnull set, int flags, const nanotime_t* _Nonnull wtp, int* _Nonnull signo)
     SC_unused_7,            // UNUSED
     SC_sig_pending,         // int sig_pending(sigset_t* _Nonnull set)
@@ -95,6 +95,7 @@ enum {
     SC_fd_flags,            // errno_t fd_flags(int fd, fd_flags_t* _Nonnull flags)
     SC_fd_dup,              // errno_t fd_dup(int fd, int min_fd, int* _Nonnull new_fd)
     SC_proc_self,           // pid_t proc_self(void)
+    SC_woa_wait_pi,         // int woa_wait_pi(volatile atomic_int* _Nonnull addr, int expected, vcpuid_t owner, int flags, const nanotime_t* _Nullable wtp)
 };
 
 
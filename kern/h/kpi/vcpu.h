@@ -119,6 +119,7 @@ typedef void* vcpu_info_ref;
 typedef struct vcpu_stack_info {
     void*   base_ptr;
     size_t  size;
+    size_t  high_water;     // number of bytes at the top of the stack that the vcpu has used so far
 } vcpu_stack_info_t;
 
 
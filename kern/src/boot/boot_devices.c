@@ -10,6 +10,7 @@
 #include <driver/hid/IOHIDManager.h>
 #include <driver/IOLib.h>
 #include <handler/ConsoleHandler.h>
+#include <handler/HeapHandler.h>
 #include <handler/IOHIDHandler.h>
 #include <handler/LogHandler.h>
 #include <handler/NullHandler.h>
@@ -42,6 +43,15 @@ errno_t init_pseudo_devices(void)
     try(devfs_add(&en, NULL));
 
 
+    en.name = "kheap";
+    en.resource = NULL;
+    en.func = HeapHandler_Create;
+    en.uid = UID_ROOT;
+    en.gid = GID_ROOT;
+    en.perms = fs_perms_from_octal(0444);
+    try(devfs_add(&en, NULL));
+
+
     try(IOHIDManager_Create(&gIOHIDManager));
     try(IOHIDManager_Start(gIOHIDManager));
 
@@ -6,6 +6,7 @@
 //  Copyright © 2021 Dietmar Planitzer. All rights reserved.
 //
 
+#include <__crt.h>
 #include <string.h>
 #include <console/Console.h>
 #include <diskcache/DiskCache.h>
@@ -16,9 +17,11 @@
 #include <hal/clock.h>
 #include <hal/irq.h>
 #include <hal/sched.h>
+#include <kdispatch/kdispatch.h>
 #include <kei/kei.h>
 #include <kern/log.h>
 #include <kpi/filesystem.h>
+#include <process/img_cache.h>
 #include <process/kerneld.h>
 #include <process/ProcessManager.h>
 #include <sched/sched.h>
@@ -54,8 +57,9 @@ _Noreturn void OnBoot(sys_desc_t* _Nonnull pSysDesc)
     const size_t data_size = &_edata - &_data;
     const size_t bss_size = &_ebss - &_bss;
 
-    // Copy the kernel data segment from ROM to RAM
-    memcpy(&_data, &_etext, data_size);
+    // Copy the kernel data segment from ROM to RAM. memcpy() can't be used
+    // here because it dispatches through the KEI table which lives in BSS
+    _memcpy_020(&_data, &_etext, data_size);
 
     // Initialize the BSS segment
     memset(&_bss, 0, bss_size);
@@ -127,10 +131,18 @@ static _Noreturn void OnStartup(const sys_desc_t* _Nonnull pSysDesc)
     log_init();
 
 
+    // Initialize the kernel dispatch queue package
+    try(kdispatch_init());
+
+
     // Create the process manager
     try(ProcessManager_Create(&gProcessManager));
 
 
+    // Create the executable image cache
+    img_cache_init(sys_desc_getramsize(pSysDesc) >> 4);
+
+
     // Create the filesystem manager
     try(FilesystemManager_Create(&gFilesystemManager));
 
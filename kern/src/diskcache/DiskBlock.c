@@ -7,16 +7,17 @@
 //
 
 #include "DiskBlock.h"
-#include <kern/kalloc.h>
+#include <string.h>
 
 
-errno_t DiskBlock_Create(int sessionId, blkno_t lba, size_t blockSize, DiskBlockRef _Nullable * _Nonnull pOutSelf)
+errno_t DiskBlock_Create(kcache_t _Nonnull cache, int sessionId, blkno_t lba, size_t blockSize, DiskBlockRef _Nullable * _Nonnull pOutSelf)
 {
     decl_try_err();
     DiskBlock* self = NULL;
     
-    err = kalloc_cleared(sizeof(DiskBlock) + blockSize - 1, (void**) &self);
+    err = kcache_alloc(cache, (void**) &self);
     if (err == EOK) {
+        memset(self, 0, sizeof(DiskBlock) + blockSize - 1);
         self->sessionId = sessionId;
         self->lba = lba;
     }
@@ -25,7 +26,7 @@ errno_t DiskBlock_Create(int sessionId, blkno_t lba, size_t blockSize, DiskBlock
     return err;
 }
 
-void DiskBlock_Destroy(DiskBlockRef _Nullable self)
+void DiskBlock_Destroy(kcache_t _Nonnull cache, DiskBlockRef _Nullable self)
 {
-    kfree(self);
+    kcache_free(cache, self);
 }
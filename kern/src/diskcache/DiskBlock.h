@@ -11,6 +11,7 @@
 
 #include <ext/queue.h>
 #include <filesystem/FSBlock.h>
+#include <kern/kcache.h>
 #include <kobj/Object.h>
 #include <kpi/types.h>
 
@@ -45,8 +46,13 @@ typedef struct DiskBlock {
 } DiskBlock;
 
 
-extern errno_t DiskBlock_Create(int sessionId, blkno_t lba, size_t blockSize, DiskBlockRef _Nullable * _Nonnull pOutSelf);
-extern void DiskBlock_Destroy(DiskBlockRef _Nullable self);
+// Allocates a disk block from 'cache'. The cache must have been created with an
+// object size of DiskBlock_GetAllocationSize(blockSize).
+extern errno_t DiskBlock_Create(kcache_t _Nonnull cache, int sessionId, blkno_t lba, size_t blockSize, DiskBlockRef _Nullable * _Nonnull pOutSelf);
+extern void DiskBlock_Destroy(kcache_t _Nonnull cache, DiskBlockRef _Nullable self);
+
+#define DiskBlock_GetAllocationSize(__blockSize) \
+(sizeof(DiskBlock) + (__blockSize) - 1)
 
 #define DiskBlock_InUse(__self) \
     ((__self)->shareCount > 0 || (__self)->flags.exclusive)
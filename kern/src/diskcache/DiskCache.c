@@ -23,13 +23,14 @@ DiskCacheRef _Nonnull  gDiskCache;
 errno_t DiskCache_Create(size_t blockSize, size_t maxBlockCount, DiskCacheRef _Nullable * _Nonnull pOutSelf)
 {
     decl_try_err();
-    DiskCache* self;
+    DiskCache* self = NULL;
     
     assert(__ELAST <= UCHAR_MAX);
     assert(blockSize > 0 && ispow2_sz(blockSize));
     assert(maxBlockCount > 0);
     
     try(kalloc_cleared(sizeof(DiskCache), (void**) &self));
+    try(kcache_create("DiskBlock", DiskBlock_GetAllocationSize(blockSize), NULL, KCACHE_OPTION_TAG(KALLOC_TAG_DISK_CACHE), &self->blockCache));
 
     mtx_init(&self->interlock);
     cnd_init(&self->condition);
@@ -44,6 +45,7 @@ errno_t DiskCache_Create(size_t blockSize, size_t maxBlockCount, DiskCacheRef _N
     return EOK;
 
 catch:
+    kfree(self);
     *pOutSelf = NULL;
     return err;
 }
@@ -200,7 +202,7 @@ static errno_t _DiskCache_CreateBlock(DiskCacheRef _Nonnull _Locked self, const
     DiskBlockRef pBlock;
 
     // We can still grow the disk block list
-    err = DiskBlock_Create(s->sessionId, lba, self->blockSize, &pBlock);
+    err = DiskBlock_Create(self->blockCache, s->sessionId, lba, self->blockSize, &pBlock);
     if (err == EOK) {
         _DiskCache_RegisterBlock(self, pBlock);
         self->blockCount++;
@@ -326,6 +328,18 @@ void _DiskCache_UnlockContentAndPutBlock(DiskCacheRef _Nonnull _Locked self, Dis
     _DiskCache_PutBlock(self, pBlock);
 }
 
+// Removes the block from the cache and frees it. The block must not be in use,
+// dirty, pinned or have an I/O operation in flight.
+void _DiskCache_PurgeBlock(DiskCacheRef _Nonnull _Locked self, DiskBlockRef _Nonnull pBlock)
+{
+    assert(!DiskBlock_InUse(pBlock));
+    assert(pBlock->flags.op == kDiskBlockOp_Idle);
+
+    _DiskCache_DeregisterBlock(self, pBlock);
+    self->blockCount--;
+    DiskBlock_Destroy(self->blockCache, pBlock);
+}
+
 
 //
 // API
@@ -335,3 +349,8 @@ size_t DiskCache_GetBlockSize(DiskCacheRef _Nonnull self)
 {
     return self->blockSize;
 }
+
+void DiskCache_GetLockStats(DiskCacheRef _Nonnull self, mtx_stats_t* _Nonnull pOutStats)
+{
+    mtx_getstats(&self->interlock, pOutStats);
+}
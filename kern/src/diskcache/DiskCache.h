@@ -16,6 +16,8 @@
 #include <filesystem/FSBlock.h>
 #include <kpi/disk.h>
 
+struct mtx_stats;
+
 
 typedef struct DiskSession {
     DiskDriverRef _Nullable disk;
@@ -39,6 +41,9 @@ extern errno_t DiskCache_Create(size_t blockSize, size_t maxBlockCount, DiskCach
 // Returns the number of bytes that a single block in the disk cache can hold.
 extern size_t DiskCache_GetBlockSize(DiskCacheRef _Nonnull self);
 
+// Returns the contention statistics of the disk cache interlock.
+extern void DiskCache_GetLockStats(DiskCacheRef _Nonnull self, struct mtx_stats* _Nonnull pOutStats);
+
 
 // Opens a new disk cache session. The session will be backed by the given disk
 // and the session will automatically map a disk cache (logical) block to one or
@@ -59,6 +64,19 @@ extern errno_t DiskCache_SyncBlock(DiskCacheRef _Nonnull self, DiskSession* _Non
 extern errno_t DiskCache_MapBlock(DiskCacheRef _Nonnull self, DiskSession* _Nonnull s, blkno_t lba, MapBlock mode, FSBlock* _Nonnull blk);
 extern errno_t DiskCache_UnmapBlock(DiskCacheRef _Nonnull self, DiskSession* _Nonnull s, intptr_t token, WriteBlock mode);
 
+// Reads 'nBlocks' consecutive blocks starting at 'lba' into 'buf'. Blocks that
+// are resident in the cache are copied from the cache. This includes blocks
+// that are dirty or have an I/O operation in flight. Runs of blocks that are
+// not resident are read by the disk driver directly into 'buf' without
+// allocating cache blocks for them. The caller must guarantee that no one
+// writes to the blocks in the range while the read is in progress.
+extern errno_t DiskCache_ReadBlocks(DiskCacheRef _Nonnull self, DiskSession* _Nonnull s, blkno_t lba, blkcnt_t nBlocks, void* _Nonnull buf);
+
+// Drops the 'nBlocks' consecutive blocks starting at 'lba' from the cache.
+// Blocks that are in use, dirty, pinned or have an I/O operation in flight are
+// left alone. The next access of a dropped block reads it from the disk again.
+extern errno_t DiskCache_PurgeBlocks(DiskCacheRef _Nonnull self, DiskSession* _Nonnull s, blkno_t lba, blkcnt_t nBlocks);
+
 // Pins and unpins the block (disk, media, lba). Pin a block to prevent it from
 // being written to disk. A pinned block that is dirty will be retained in
 // memory until it is unpinned and a sync of the block is triggered. 
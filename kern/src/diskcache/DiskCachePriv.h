@@ -165,6 +165,7 @@ typedef struct DiskCache {
     size_t                      lruChainGeneration;     // Incremented every time the LRU chain is modified
     deque_t/*<DiskBlock>*/      lruChain;               // Cached disk blocks stored in a LRU chain; first -> most recently used; last -> least recently used
     size_t                      blockSize;
+    kcache_t _Nonnull           blockCache;             // Disk blocks are allocated from this cache
     size_t                      blockCount;             // Number of disk blocks owned and managed by the disk cache (blocks in use + blocks held on the cache lru chain)
     size_t                      blockCapacity;          // Maximum number of disk blocks that may exist at any given time
     size_t                      dirtyBlockCount;        // Number of blocks in the cache that are currently marked dirty
@@ -183,6 +184,7 @@ extern void _DiskCache_DowngradeBlockContentLock(DiskCacheRef _Nonnull _Locked s
 extern errno_t _DiskCache_GetBlock(DiskCacheRef _Nonnull _Locked self, const DiskSession* _Nonnull s, blkno_t lba, unsigned int options, DiskBlockRef _Nullable * _Nonnull pOutBlock);
 extern void _DiskCache_PutBlock(DiskCacheRef _Nonnull _Locked self, DiskBlockRef _Nonnull pBlock);
 extern void _DiskCache_UnlockContentAndPutBlock(DiskCacheRef _Nonnull _Locked self, DiskBlockRef _Nullable pBlock);
+extern void _DiskCache_PurgeBlock(DiskCacheRef _Nonnull _Locked self, DiskBlockRef _Nonnull pBlock);
 
 extern errno_t _DiskCache_SyncBlock(DiskCacheRef _Nonnull _Locked self, DiskSession* _Nonnull s, DiskBlockRef pBlock);
 
@@ -28,7 +28,7 @@ errno_t DiskOp_Create(blkcnt_t clusterSize, DiskCacheRef _Nonnull cache, DiskOp*
     const size_t op_size = sizeof(struct DiskOp) + blk_size + iov_size;
     DiskOp* p = NULL;
 
-    err = kalloc(op_size, (void*)&p);
+    err = kalloc_tagged(op_size, KALLOC_TAG_DISK_CACHE, (void*)&p);
     if (err == EOK) {
         p->qe = QUEUE_NODE_INIT;
         p->completion.f = (IOCompletionFunc)_on_disk_op_done;
@@ -151,9 +151,19 @@ errno_t DiskCache_SyncBlock(DiskCacheRef _Nonnull self, DiskSession* _Nonnull s,
     mtx_lock(&self->interlock);
 
     if (s->isOpen) {
-        // Find the block and only sync it if no one else is currently using it
-        if ((err = _DiskCache_GetBlock(self, s, lba, kGetBlock_Exclusive, &pBlock)) == EOK) {
-            err = _DiskCache_SyncBlock(self, s, pBlock);
+        // Find the block. There's nothing to do if the block isn't cached. Note
+        // that we do not skip a block that is in use. The caller expects that
+        // the block is on the disk once we return. _DiskCache_SyncBlock() waits
+        // for an exclusive user to unlock the block and we wait for an ongoing
+        // write to finish.
+        if ((err = _DiskCache_GetBlock(self, s, lba, 0, &pBlock)) == EOK && pBlock) {
+            while (pBlock->flags.op == kDiskBlockOp_Write && err == EOK) {
+                err = cnd_wait(&self->condition, &self->interlock);
+            }
+
+            if (err == EOK && !pBlock->flags.isPinned) {
+                err = _DiskCache_SyncBlock(self, s, pBlock);
+            }
             _DiskCache_PutBlock(self, pBlock);
         }
     }
@@ -362,6 +372,111 @@ catch:
     return err;
 }
 
+// Reads the blocks [lba, lba + nBlocks) straight from the disk into 'buf'.
+// Expects that none of these blocks is resident in the cache.
+static errno_t _DiskCache_ReadDirect(DiskCacheRef _Nonnull self, DiskSession* _Nonnull s, blkno_t lba, blkcnt_t nBlocks, uint8_t* _Nonnull buf)
+{
+    decl_try_err();
+    off_t offset = (off_t)lba * s->s2bFactor * s->sectorSize;
+    const ssize_t nBytesToRead = (ssize_t)nBlocks * self->blockSize;
+    ssize_t nBytesRead = 0;
+
+    err = DiskDriver_Read(s->disk, 0, &offset, buf, nBytesToRead, &nBytesRead);
+    if (err == EOK && nBytesRead < nBytesToRead) {
+        err = EIO;
+    }
+
+    return err;
+}
+
+errno_t DiskCache_ReadBlocks(DiskCacheRef _Nonnull self, DiskSession* _Nonnull s, blkno_t lba, blkcnt_t nBlocks, void* _Nonnull buf)
+{
+    decl_try_err();
+    uint8_t* dp = buf;
+
+    while (nBlocks > 0 && err == EOK) {
+        blkcnt_t nUncached = 0;
+        DiskBlockRef pBlock = NULL;
+
+        mtx_lock(&self->interlock);
+        if (!s->isOpen) {
+            mtx_unlock(&self->interlock);
+            return ENODEV;
+        }
+
+        // Find the run of blocks at 'lba' that are not in the cache. A block
+        // with a trailing pad can not be read directly because the caller
+        // expects the pad to be zero filled.
+        if (s->trailPadSize == 0) {
+            while (nUncached < nBlocks) {
+                _DiskCache_GetBlock(self, s, lba + nUncached, 0, &pBlock);
+                if (pBlock) {
+                    _DiskCache_PutBlock(self, pBlock);
+                    break;
+                }
+                nUncached++;
+            }
+        }
+
+        // Keeps the session from closing while we're reading without holding
+        // the interlock
+        if (nUncached > 0) {
+            s->activeMappingsCount++;
+        }
+        mtx_unlock(&self->interlock);
+
+
+        if (nUncached > 0) {
+            err = _DiskCache_ReadDirect(self, s, lba, nUncached, dp);
+
+            mtx_lock(&self->interlock);
+            s->activeMappingsCount--;
+            mtx_unlock(&self->interlock);
+        }
+        else {
+            // The block is resident. Go through the cache so that we see the
+            // latest data even if the block is dirty or is being read in.
+            FSBlock blk;
+
+            nUncached = 1;
+            err = DiskCache_MapBlock(self, s, lba, kMapBlock_ReadOnly, &blk);
+            if (err == EOK) {
+                memcpy(dp, blk.data, self->blockSize);
+                DiskCache_UnmapBlock(self, s, blk.token, kWriteBlock_None);
+            }
+        }
+
+        lba += nUncached;
+        nBlocks -= nUncached;
+        dp += nUncached * self->blockSize;
+    }
+
+    return err;
+}
+
+errno_t DiskCache_PurgeBlocks(DiskCacheRef _Nonnull self, DiskSession* _Nonnull s, blkno_t lba, blkcnt_t nBlocks)
+{
+    decl_try_err();
+
+    mtx_lock(&self->interlock);
+    if (!s->isOpen) {
+        throw(ENODEV);
+    }
+
+    for (blkcnt_t i = 0; i < nBlocks; i++) {
+        DiskBlockRef pBlock = NULL;
+
+        _DiskCache_GetBlock(self, s, lba + i, 0, &pBlock);
+        if (pBlock && !DiskBlock_InUse(pBlock) && !pBlock->flags.isDirty && !pBlock->flags.isPinned && pBlock->flags.op == kDiskBlockOp_Idle) {
+            _DiskCache_PurgeBlock(self, pBlock);
+        }
+    }
+
+catch:
+    mtx_unlock(&self->interlock);
+    return err;
+}
+
 // Synchronously writes all dirty disk blocks belonging to the session 's' to
 // disk.
 errno_t DiskCache_Sync(DiskCacheRef _Nonnull self, DiskSession* _Nonnull s)
@@ -27,7 +27,7 @@ errno_t copper_prog_create(size_t instr_count, copper_prog_t _Nullable * _Nonnul
         return err;
     }
 
-    err = kalloc_options(sizeof(copper_instr_t) * instr_count, KALLOC_OPTION_UNIFIED, (void**)&prog->prog);
+    err = kalloc_options(sizeof(copper_instr_t) * instr_count, KALLOC_OPTION_UNIFIED | KALLOC_OPTION_TAG(KALLOC_TAG_GRAPHICS), (void**)&prog->prog);
     if (err != EOK) {
         kfree(prog);
         return err;
@@ -33,7 +33,7 @@ errno_t gdcInit(void)
 
 
     // Create a null sprite
-    try(kalloc_options(sizeof(uint16_t) * 6, KALLOC_OPTION_UNIFIED, (void**)&g_null_sprite_data));
+    try(kalloc_options(sizeof(uint16_t) * 6, KALLOC_OPTION_UNIFIED | KALLOC_OPTION_TAG(KALLOC_TAG_GRAPHICS), (void**)&g_null_sprite_data));
     g_null_sprite_data[0] = 0x1905;
     g_null_sprite_data[1] = 0x1a00;
     g_null_sprite_data[2] = 0;
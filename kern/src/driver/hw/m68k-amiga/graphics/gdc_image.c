@@ -33,7 +33,7 @@ static errno_t _alloc_single_plane(image_t* _Nonnull self)
             break;
     }
 
-    try(kalloc_options(nbytes, KALLOC_OPTION_UNIFIED, (void**) &self->plane[0]));
+    try(kalloc_options(nbytes, KALLOC_OPTION_UNIFIED | KALLOC_OPTION_TAG(KALLOC_TAG_GRAPHICS), (void**) &self->plane[0]));
 
     if (self->pixelFormat == GD_RGB_SPRITE_2) {
         uint16_t* p = (uint16_t*)self->plane[0];
@@ -62,7 +62,7 @@ static errno_t _alloc_multi_plane(image_t* _Nonnull self)
     // too fragmented to pull this off. Individual planes in a clustered planes
     // configuration are aligned on an 4 byte boundary.
 
-    err = kalloc_options(clusteredSize, KALLOC_OPTION_UNIFIED, (void**) &self->plane[0]);
+    err = kalloc_options(clusteredSize, KALLOC_OPTION_UNIFIED | KALLOC_OPTION_TAG(KALLOC_TAG_GRAPHICS), (void**) &self->plane[0]);
     if (err == EOK) {
         for (int8_t i = 1; i < self->planeCount; i++) {
             self->plane[i] = self->plane[i - 1] + bytesPerClusteredPlane;
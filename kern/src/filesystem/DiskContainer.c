@@ -88,6 +88,16 @@ errno_t DiskContainer_prefetchBlock(DiskContainerRef _Nonnull self, blkno_t lba)
     return DiskCache_PrefetchBlock(self->diskCache, &self->session, lba);
 }
 
+errno_t DiskContainer_readBlocks(DiskContainerRef _Nonnull self, blkno_t lba, blkcnt_t count, void* _Nonnull buf)
+{
+    return DiskCache_ReadBlocks(self->diskCache, &self->session, lba, count, buf);
+}
+
+errno_t DiskContainer_purgeBlocks(DiskContainerRef _Nonnull self, blkno_t lba, blkcnt_t count)
+{
+    return DiskCache_PurgeBlocks(self->diskCache, &self->session, lba, count);
+}
+
 
 errno_t DiskContainer_syncBlock(DiskContainerRef _Nonnull self, blkno_t lba)
 {
@@ -130,6 +140,8 @@ override_func_def(disconnect, DiskContainer, FSContainer)
 override_func_def(mapBlock, DiskContainer, FSContainer)
 override_func_def(unmapBlock, DiskContainer, FSContainer)
 override_func_def(prefetchBlock, DiskContainer, FSContainer)
+override_func_def(readBlocks, DiskContainer, FSContainer)
+override_func_def(purgeBlocks, DiskContainer, FSContainer)
 override_func_def(syncBlock, DiskContainer, FSContainer)
 override_func_def(sync, DiskContainer, FSContainer)
 override_func_def(getInfo, DiskContainer, FSContainer)
@@ -10,6 +10,7 @@
 #include "FSUtilities.h"
 #include <assert.h>
 #include <stddef.h>
+#include <string.h>
 #include <ext/bit.h>
 #include <kern/kernlib.h>
 
@@ -54,6 +55,29 @@ errno_t FSContainer_prefetchBlock(FSContainerRef _Nonnull self, blkno_t lba)
     return EOK;
 }
 
+errno_t FSContainer_readBlocks(FSContainerRef _Nonnull self, blkno_t lba, blkcnt_t count, void* _Nonnull buf)
+{
+    decl_try_err();
+    uint8_t* dp = buf;
+    FSBlock blk;
+
+    for (blkcnt_t i = 0; i < count && err == EOK; i++) {
+        err = FSContainer_MapBlock(self, lba + i, kMapBlock_ReadOnly, &blk);
+        if (err == EOK) {
+            memcpy(dp, blk.data, self->blockSize);
+            FSContainer_UnmapBlock(self, blk.token, kWriteBlock_None);
+            dp += self->blockSize;
+        }
+    }
+
+    return err;
+}
+
+errno_t FSContainer_purgeBlocks(FSContainerRef _Nonnull self, blkno_t lba, blkcnt_t count)
+{
+    return EOK;
+}
+
 
 errno_t FSContainer_syncBlock(FSContainerRef _Nonnull self, blkno_t lba)
 {
@@ -82,6 +106,8 @@ func_def(disconnect, FSContainer)
 func_def(mapBlock, FSContainer)
 func_def(unmapBlock, FSContainer)
 func_def(prefetchBlock, FSContainer)
+func_def(readBlocks, FSContainer)
+func_def(purgeBlocks, FSContainer)
 func_def(syncBlock, FSContainer)
 func_def(sync, FSContainer)
 func_def(getInfo, FSContainer)
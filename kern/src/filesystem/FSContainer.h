@@ -54,6 +54,21 @@ open_class_funcs(FSContainer, Object,
     // whether the read operation as such was successful or not.
     errno_t (*prefetchBlock)(void* _Nonnull self, blkno_t lba);
 
+    // Reads the contents of the 'count' consecutive blocks starting at 'lba'
+    // into 'buf'. 'buf' must be big enough to hold 'count' blocks. Subclasses
+    // may read blocks that aren't cached directly from the storage into 'buf'.
+    // The caller must prevent writes to the blocks while the read is ongoing.
+    // Override: Optional
+    // Default: Maps and copies one block at a time
+    errno_t (*readBlocks)(void* _Nonnull self, blkno_t lba, blkcnt_t count, void* _Nonnull buf);
+
+    // Drops the 'count' consecutive blocks starting at 'lba' from the cache, if
+    // the container caches blocks. Blocks that are in use or hold unwritten
+    // data are kept.
+    // Override: Optional
+    // Default: Does nothing
+    errno_t (*purgeBlocks)(void* _Nonnull self, blkno_t lba, blkcnt_t count);
+
 
     // Synchronously flushes the block at the logical block address 'lba' to
     // disk if it contains unwritten (dirty) data. Does nothing if the block is
@@ -109,6 +124,12 @@ invoke_n(unmapBlock, FSContainer, __self, __token, __mode)
 #define FSContainer_PrefetchBlock(__self, __lba) \
 invoke_n(prefetchBlock, FSContainer, __self, __lba)
 
+#define FSContainer_ReadBlocks(__self, __lba, __count, __buf) \
+invoke_n(readBlocks, FSContainer, __self, __lba, __count, __buf)
+
+#define FSContainer_PurgeBlocks(__self, __lba, __count) \
+invoke_n(purgeBlocks, FSContainer, __self, __lba, __count)
+
 
 #define FSContainer_SyncBlock(__self, __lba) \
 invoke_n(syncBlock, FSContainer, __self, __lba)
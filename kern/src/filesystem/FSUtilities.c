@@ -23,13 +23,13 @@ void FSGetCurrentTime(nanotime_t* _Nonnull ts)
 // Allocates a memory block. Note that the allocated block is not cleared.
 errno_t FSAllocate(size_t nbytes, void* _Nullable * _Nonnull pOutPtr)
 {
-    return kalloc(nbytes, pOutPtr);
+    return kalloc_tagged(nbytes, KALLOC_TAG_FILESYSTEM, pOutPtr);
 }
 
 // Allocates a memory block.
 errno_t FSAllocateCleared(size_t nbytes, void* _Nullable * _Nonnull pOutPtr)
 {
-    return kalloc_cleared(nbytes,  pOutPtr);
+    return kalloc_options(nbytes, KALLOC_OPTION_CLEAR | KALLOC_OPTION_TAG(KALLOC_TAG_FILESYSTEM), pOutPtr);
 }
 
 // Frees a memory block allocated by FSAllocate().
@@ -249,6 +249,31 @@ errno_t Inode_truncate(InodeRef _Nonnull _Locked self, off_t length)
     return EINVAL;
 }
 
+errno_t Inode_sync(InodeRef _Nonnull _Locked self, int flags)
+{
+    decl_try_err();
+    FSContainerRef fsContainer = Filesystem_GetContainer(self->filesystem);
+
+    if (Filesystem_IsReadOnly(self->filesystem)) {
+        return EOK;
+    }
+
+    if ((flags & FD_SYNC_DATA) == 0 && Inode_IsModified(self)) {
+        err = Inode_Writeback(self);
+    }
+
+    // We don't know which blocks belong to this inode. Sync everything.
+    if (fsContainer) {
+        const errno_t err1 = FSContainer_Sync(fsContainer);
+
+        if (err == EOK) {
+            err = err1;
+        }
+    }
+
+    return err;
+}
+
 
 any_subclass_func_defs(Inode,
 func_def(deinit, Inode)
@@ -261,4 +286,5 @@ func_def(setTimes, Inode)
 func_def(read, Inode)
 func_def(write, Inode)
 func_def(truncate, Inode)
+func_def(sync, Inode)
 );
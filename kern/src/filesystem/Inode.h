@@ -113,6 +113,17 @@ any_subclass_funcs(Inode,
     // new blocks until an attempt is made to read or write them.
     errno_t (*truncate)(void* _Nonnull _Locked self, off_t length);
 
+    // Synchronously writes the modified data and metadata of the inode to the
+    // underlying storage. Only the file data and the metadata that is required
+    // to read the file data back (eg file size and block map) are written if
+    // 'flags' includes FD_SYNC_DATA. The file data is dropped from the disk
+    // cache after it has been written if 'flags' includes FD_SYNC_PURGE. Does
+    // not return before all data has been written.
+    // Override: Advised
+    // Default: Writes the inode metadata back and then syncs the whole
+    //          filesystem container. Ignores FD_SYNC_PURGE
+    errno_t (*sync)(void* _Nonnull _Locked self, int flags);
+
 
     //
     // Handlers
@@ -328,6 +339,9 @@ invoke_n(write, Inode, __self, __pOffset, __pBuffer, __nBytesToWrite, __nOutByte
 #define Inode_Truncate(__self, __length) \
 invoke_n(truncate, Inode, __self, __length)
 
+#define Inode_Sync(__self, __flags) \
+invoke_n(sync, Inode, __self, __flags)
+
 
 //
 // Only filesystem implementations should call the following functions.
@@ -195,3 +195,20 @@ errno_t SfsAllocator_CommitToDisk(SfsAllocator* _Nonnull self, FSContainerRef _N
 
     return err;
 }
+
+errno_t SfsAllocator_Sync(SfsAllocator* _Nonnull self, FSContainerRef _Nonnull fsContainer)
+{
+    decl_try_err();
+
+    err = SfsAllocator_CommitToDisk(self, fsContainer);
+
+    for (blkno_t i = 0; i < self->bitmapBlockCount; i++) {
+        const errno_t err1 = FSContainer_SyncBlock(fsContainer, self->bitmapLba + i);
+
+        if (err == EOK) {
+            err = err1;
+        }
+    }
+
+    return err;
+}
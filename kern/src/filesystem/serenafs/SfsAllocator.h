@@ -43,6 +43,10 @@ extern void SfsAllocator_Deallocate(SfsAllocator* _Nonnull self, blkno_t lba);
 
 extern errno_t SfsAllocator_CommitToDisk(SfsAllocator* _Nonnull self, FSContainerRef _Nonnull fsContainer);
 
+// Commits the allocation bitmap to the disk cache and then synchronously writes
+// the allocation bitmap blocks to disk.
+extern errno_t SfsAllocator_Sync(SfsAllocator* _Nonnull self, FSContainerRef _Nonnull fsContainer);
+
 extern blkcnt_t SfsAllocator_GetAllocatedBlockCount(SfsAllocator* _Nonnull self);
 
 #endif /* SfsAllocator_h */
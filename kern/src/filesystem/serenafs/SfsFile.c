@@ -10,8 +10,10 @@
 #include "SerenaFSPriv.h"
 #include <assert.h>
 #include <ext/endian.h>
+#include <ext/math.h>
 #include <ext/nanotime.h>
 #include <filesystem/FSUtilities.h>
+#include <kpi/fd.h>
 
 
 errno_t SfsFile_Create(Class* _Nonnull pClass, SerenaFSRef _Nonnull fs, ino_t inid, const sfs_inode_t* _Nonnull ip, InodeRef _Nullable * _Nonnull pOutNode)
@@ -45,6 +47,7 @@ errno_t SfsFile_Create(Class* _Nonnull pClass, SerenaFSRef _Nonnull fs, ino_t in
         for (size_t i = 0; i < kSFSDirectBlockPointersCount; i++) {
             self->bmap.direct[i] = ip->bmap.direct[i];
         }
+        self->syncedSize = Inode_GetFileSize(self);
     }
     *pOutNode = (InodeRef)self;
 
@@ -151,10 +154,16 @@ errno_t SfsFile_MapBlock(SfsFileRef _Nonnull _Locked self, sfs_bno_t fba, MapBlo
     FSContainerRef fsContainer = Filesystem_GetContainer(fs);
     sfs_bmap_t* bmap = &self->bmap;
 
+    blk->fba = fba;
+
     if (fba < kSFSDirectBlockPointersCount) {
         blkno_t dat_lba = be32toh(bmap->direct[fba]);
 
-        return map_disk_block(fs, dat_lba, mode, &bmap->direct[fba], blk);
+        err = map_disk_block(fs, dat_lba, mode, &bmap->direct[fba], blk);
+        if (blk->wasAlloced) {
+            self->isBmapDirty = true;
+        }
+        return err;
     }
     fba -= kSFSDirectBlockPointersCount;
 
@@ -172,6 +181,10 @@ errno_t SfsFile_MapBlock(SfsFileRef _Nonnull _Locked self, sfs_bno_t fba, MapBlo
         blkno_t dat_lba = be32toh(i0_bmap[fba]);
 
         err = map_disk_block(fs, dat_lba, mode, &i0_bmap[fba], blk);
+        blk->fba = fba + kSFSDirectBlockPointersCount;
+        if (blk->wasAlloced || i0_block.wasAlloced) {
+            self->isBmapDirty = true;
+        }
         
         FSContainer_UnmapBlock(fsContainer, i0_block.b.token, (blk->wasAlloced) ? kWriteBlock_Deferred : kWriteBlock_None);
         return err;
@@ -196,9 +209,82 @@ errno_t SfsFile_UnmapBlock(SfsFileRef _Nonnull _Locked self, SfsFileBlock* _Nonn
         abort();
     }
 
+    if (mode == kWriteBlock_Deferred) {
+        // Remember the block so that a sync of this file will flush it
+        if (self->dirtyFba >= self->dirtyFbaEnd) {
+            self->dirtyFba = blk->fba;
+            self->dirtyFbaEnd = blk->fba + 1;
+        }
+        else if (blk->fba < self->dirtyFba) {
+            self->dirtyFba = blk->fba;
+        }
+        else if (blk->fba >= self->dirtyFbaEnd) {
+            self->dirtyFbaEnd = blk->fba + 1;
+        }
+    }
+
     return FSContainer_UnmapBlock(fsContainer, blk->b.token, mode);
 }
 
+// Returns the disk address of the file block 'fba' and the number of file blocks
+// starting at 'fba' that are stored in consecutive disk blocks. The count is
+// limited to 'maxCount'. Returns a count of 0 if 'fba' is a hole. Never
+// allocates blocks.
+errno_t SfsFile_GetBlockRun(SfsFileRef _Nonnull _Locked self, sfs_bno_t fba, sfs_bno_t maxCount, blkno_t* _Nonnull pOutLba, sfs_bno_t* _Nonnull pOutCount)
+{
+    decl_try_err();
+    SerenaFSRef fs = Inode_GetFilesystemAs(self, SerenaFS);
+    FSContainerRef fsContainer = Filesystem_GetContainer(fs);
+    const sfs_bmap_t* bmap = &self->bmap;
+    const sfs_bno_t* i0_bmap = NULL;
+    FSBlock i0_block = {0};
+    blkno_t firstLba = 0;
+    sfs_bno_t n = 0;
+
+    while (n < maxCount) {
+        const sfs_bno_t idx = fba + n;
+        blkno_t lba;
+
+        if (idx < kSFSDirectBlockPointersCount) {
+            lba = be32toh(bmap->direct[idx]);
+        }
+        else if (idx - kSFSDirectBlockPointersCount < fs->indirectBlockEntryCount) {
+            if (i0_bmap == NULL) {
+                const blkno_t i0_lba = be32toh(bmap->indirect);
+
+                if (i0_lba == 0) {
+                    break;
+                }
+                err = FSContainer_MapBlock(fsContainer, i0_lba, kMapBlock_ReadOnly, &i0_block);
+                if (err != EOK) {
+                    break;
+                }
+                i0_bmap = (const sfs_bno_t*)i0_block.data;
+            }
+            lba = be32toh(i0_bmap[idx - kSFSDirectBlockPointersCount]);
+        }
+        else {
+            break;
+        }
+
+        if (lba == 0 || (n > 0 && lba != firstLba + n)) {
+            break;
+        }
+        if (n == 0) {
+            firstLba = lba;
+        }
+        n++;
+    }
+
+    if (i0_bmap) {
+        FSContainer_UnmapBlock(fsContainer, i0_block.token, kWriteBlock_None);
+    }
+
+    *pOutLba = firstLba;
+    *pOutCount = n;
+    return err;
+}
+
 // Trims (shortens) the size of the file to the new (and smaller) size 'newLength'.
 // Note that this function may free blocks but it does not commit the changes to
 // the allocation bitmap to the disk and doesn't set the inode modification flags.
@@ -269,9 +355,161 @@ bool SfsFile_Trim(SfsFileRef _Nonnull _Locked self, off_t newLength)
 
     Inode_SetFileSize(self, newLength);
 
+    if (didTrim) {
+        self->isBmapDirty = true;
+    }
+
     return didTrim;
 }
 
+// Synchronously writes the file blocks in the dirty range to disk. Blocks that
+// have been freed in the meantime are skipped.
+static errno_t sync_data_blocks(SfsFileRef _Nonnull _Locked self, SerenaFSRef _Nonnull fs, FSContainerRef _Nonnull fsContainer)
+{
+    decl_try_err();
+    const sfs_bmap_t* bmap = &self->bmap;
+    const sfs_bno_t fbaEnd = self->dirtyFbaEnd;
+    sfs_bno_t fba = self->dirtyFba;
+
+    while (fba < fbaEnd && fba < kSFSDirectBlockPointersCount) {
+        const blkno_t lba = be32toh(bmap->direct[fba]);
+
+        if (lba > 0) {
+            const errno_t err1 = FSContainer_SyncBlock(fsContainer, lba);
+
+            if (err == EOK) {
+                err = err1;
+            }
+        }
+        fba++;
+    }
+
+
+    const blkno_t i0_lba = be32toh(bmap->indirect);
+
+    if (fba < fbaEnd && i0_lba > 0) {
+        FSBlock blk = {0};
+        const errno_t err1 = FSContainer_MapBlock(fsContainer, i0_lba, kMapBlock_ReadOnly, &blk);
+
+        if (err1 == EOK) {
+            const sfs_bno_t* i0_bmap = (const sfs_bno_t*)blk.data;
+            const size_t i0_end = __min(fbaEnd - kSFSDirectBlockPointersCount, fs->indirectBlockEntryCount);
+
+            for (size_t i = fba - kSFSDirectBlockPointersCount; i < i0_end; i++) {
+                const blkno_t lba = be32toh(i0_bmap[i]);
+
+                if (lba > 0) {
+                    const errno_t err2 = FSContainer_SyncBlock(fsContainer, lba);
+
+                    if (err == EOK) {
+                        err = err2;
+                    }
+                }
+            }
+            FSContainer_UnmapBlock(fsContainer, blk.token, kWriteBlock_None);
+        }
+        else if (err == EOK) {
+            err = err1;
+        }
+    }
+
+    return err;
+}
+
+// Drops the data blocks of the file from the disk cache. Holes are skipped.
+static errno_t purge_data_blocks(SfsFileRef _Nonnull _Locked self, SerenaFSRef _Nonnull fs, FSContainerRef _Nonnull fsContainer)
+{
+    decl_try_err();
+    const off_t fileSize = Inode_GetFileSize(self);
+    const sfs_bno_t fbaEnd = (sfs_bno_t)((fileSize + (off_t)fs->blockSize - 1) >> fs->blockShift);
+    sfs_bno_t fba = 0;
+
+    while (fba < fbaEnd && err == EOK) {
+        blkno_t lba;
+        sfs_bno_t nBlocks;
+
+        err = SfsFile_GetBlockRun(self, fba, fbaEnd - fba, &lba, &nBlocks);
+        if (err == EOK && nBlocks > 0) {
+            err = FSContainer_PurgeBlocks(fsContainer, lba, nBlocks);
+            fba += nBlocks;
+        }
+        else {
+            fba++;
+        }
+    }
+
+    return err;
+}
+
+errno_t SfsFile_sync(SfsFileRef _Nonnull _Locked self, int flags)
+{
+    decl_try_err();
+    SerenaFSRef fs = Inode_GetFilesystemAs(self, SerenaFS);
+    FSContainerRef fsContainer = Filesystem_GetContainer(fs);
+    const bool isMetaChanged = self->isBmapDirty || self->syncedSize != Inode_GetFileSize(self);
+    const bool doMeta = ((flags & FD_SYNC_DATA) == 0 || isMetaChanged) ? true : false;
+    errno_t err1;
+
+    if (Filesystem_IsReadOnly(fs)) {
+        return EOK;
+    }
+
+
+    // Write the data blocks first so that the on-disk inode never refers to
+    // blocks with stale content
+    if (self->dirtyFba < self->dirtyFbaEnd) {
+        err = sync_data_blocks(self, fs, fsContainer);
+    }
+
+
+    if (doMeta) {
+        if (Inode_IsModified(self) || isMetaChanged) {
+            err1 = Inode_Writeback((InodeRef)self);
+            if (err == EOK) {
+                err = err1;
+            }
+        }
+
+        if (self->isBmapDirty) {
+            const blkno_t i0_lba = be32toh(self->bmap.indirect);
+
+            if (i0_lba > 0) {
+                err1 = FSContainer_SyncBlock(fsContainer, i0_lba);
+                if (err == EOK) {
+                    err = err1;
+                }
+            }
+
+            err1 = SfsAllocator_Sync(&fs->blockAllocator, fsContainer);
+            if (err == EOK) {
+                err = err1;
+            }
+        }
+
+        err1 = FSContainer_SyncBlock(fsContainer, (blkno_t)Inode_GetId(self));
+        if (err == EOK) {
+            err = err1;
+        }
+    }
+
+
+    if (err == EOK) {
+        self->dirtyFba = 0;
+        self->dirtyFbaEnd = 0;
+
+        if (doMeta) {
+            self->syncedSize = Inode_GetFileSize(self);
+            self->isBmapDirty = false;
+        }
+    }
+
+    if (err == EOK && (flags & FD_SYNC_PURGE) != 0) {
+        err = purge_data_blocks(self, fs, fsContainer);
+    }
+
+    return err;
+}
+
 sfs_itype_t SfsITypeFromFileType(fs_ftype_t ftype)
 {
     switch (ftype) {
@@ -292,4 +530,5 @@ fs_ftype_t SfsFileTypeFromIType(sfs_itype_t itype)
 
 
 class_func_defs(SfsFile, Inode,
+override_func_def(sync, SfsFile, Inode)
 );
@@ -27,14 +27,22 @@ extern fs_ftype_t SfsFileTypeFromIType(sfs_itype_t itype);
 
 typedef struct SfsFileBlock {
     FSBlock     b;
+    sfs_bno_t   fba;
     blkno_t     lba;
     bool        wasAlloced;
     bool        isZeroFill;
 } SfsFileBlock;
 
 
+// The file tracks the range of file blocks that it has written to the disk
+// cache since the last sync. This allows a sync of the file to flush just the
+// blocks of this file rather than every dirty block of the whole volume.
 open_class(SfsFile, Inode,
     sfs_bmap_t  bmap;
+    sfs_bno_t   dirtyFba;       // First file block written since the last sync
+    sfs_bno_t   dirtyFbaEnd;    // One past the last file block written since the last sync. Range is empty if dirtyFba >= dirtyFbaEnd
+    off_t       syncedSize;     // File size as of the last sync
+    bool        isBmapDirty;    // Blocks have been allocated or freed since the last sync
 );
 open_class_funcs(SfsFile, Inode,
 );
@@ -48,6 +56,8 @@ extern void SfsFile_ConvertOffset(SfsFileRef _Nonnull _Locked self, off_t offset
 extern errno_t SfsFile_MapBlock(SfsFileRef _Nonnull _Locked self, sfs_bno_t fba, MapBlock mode, SfsFileBlock* _Nonnull blk);
 extern errno_t SfsFile_UnmapBlock(SfsFileRef _Nonnull _Locked self, SfsFileBlock* _Nonnull blk, WriteBlock mode);
 
+extern errno_t SfsFile_GetBlockRun(SfsFileRef _Nonnull _Locked self, sfs_bno_t fba, sfs_bno_t maxCount, blkno_t* _Nonnull pOutLba, sfs_bno_t* _Nonnull pOutCount);
+
 extern bool SfsFile_Trim(SfsFileRef _Nonnull _Locked self, off_t newLength);
 
 #define SfsFile_GetIType(__self) \
@@ -15,10 +15,17 @@
 #include <kpi/file.h>
 
 
+// A read of at least this many whole blocks that are consecutive on disk is
+// handed to the FS container in one go. The container reads blocks that aren't
+// cached straight into the caller's buffer.
+#define MIN_DIRECT_READ_BLOCKS  4
+
+
 errno_t SfsRegularFile_read(SfsRegularFileRef _Nonnull _Locked self, off_t* _Nonnull pOffset, void* _Nonnull buf, ssize_t nBytesToRead, ssize_t* _Nonnull pOutBytesRead)
 {
     decl_try_err();
     SerenaFSRef fs = Inode_GetFilesystemAs(self, SerenaFS);
+    FSContainerRef fsContainer = Filesystem_GetContainer(fs);
     const off_t offset = *pOffset;
     uint8_t* dp = buf;
     ssize_t nBytesRead = 0;
@@ -53,8 +60,30 @@ errno_t SfsRegularFile_read(SfsRegularFileRef _Nonnull _Locked self, off_t* _Non
 
 
     // Iterate through a contiguous sequence of blocks until we've read all
-    // required bytes.
+    // required bytes. Note that no one can write to the file while we're
+    // reading because we hold the inode lock.
     while (nBytesToRead > 0) {
+        if (blockOffset == 0 && nBytesToRead >= ((ssize_t)MIN_DIRECT_READ_BLOCKS << fs->blockShift)) {
+            blkno_t lba;
+            sfs_bno_t nBlocks;
+
+            if (SfsFile_GetBlockRun((SfsFileRef)self, blockIdx, nBytesToRead >> fs->blockShift, &lba, &nBlocks) == EOK && nBlocks >= MIN_DIRECT_READ_BLOCKS) {
+                const ssize_t nBytesInRun = (ssize_t)nBlocks << fs->blockShift;
+                const errno_t e1 = FSContainer_ReadBlocks(fsContainer, lba, nBlocks, dp);
+
+                if (e1 != EOK) {
+                    err = (nBytesRead == 0) ? e1 : EOK;
+                    break;
+                }
+
+                nBytesToRead -= nBytesInRun;
+                nBytesRead += nBytesInRun;
+                dp += nBytesInRun;
+                blockIdx += nBlocks;
+                continue;
+            }
+        }
+
         const ssize_t nRemainderBlockSize = fs->blockAllocator.blockSize - blockOffset;
         const ssize_t nBytesToReadInBlock = (nBytesToRead > nRemainderBlockSize) ? nRemainderBlockSize : nBytesToRead;
         SfsFileBlock blk;
@@ -11,6 +11,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <kern/timerwheel.h>
 #include <kpi/types.h>
 
 #define kTicks_Infinity     UINT32_MAX
@@ -21,24 +22,28 @@ typedef void (*deadline_func_t)(void* _Nullable arg);
 
 // Note: Keep in sync with machine/hw/m68k/lowmem.i
 typedef struct clock_deadline {
-    struct clock_deadline* _Nullable    next;
-    ticks_t                             deadline;
+    tw_timer_t                          timer;      // 'timer.deadline' is the absolute time in ticks when the deadline fires
     deadline_func_t _Nonnull            func;
     void* _Nullable                     arg;
     bool                                isArmed;
     char                                reserved[3];
 } clock_deadline_t;
 
-#define CLOCK_DEADLINE_INIT (clock_deadline_t){NULL, 0, NULL, NULL, false, 0, 0, 0}
+#define CLOCK_DEADLINE_INIT (clock_deadline_t){{NULL, NULL, 0, 0, 0, {0, 0}}, NULL, NULL, false, {0, 0, 0}}
 
 
 // Note: Keep in sync with machine/hw/m68k/lowmem.i
 struct clock {
     volatile ticks_t            tick_count;             // current clock time in terms of ticks since clock start
-    clock_deadline_t* _Nullable deadline_queue;
     int32_t                     ns_per_tick;            // duration of a single clock tick in terms of nanoseconds
     int16_t                     cia_cycles_per_tick;    // duration of a single clock tick in terms of CIA chip cycles 
     int16_t                     ns_per_cia_cycle;       // length of a CIA cycle in nanoseconds
+    uint32_t                    counter;                // free-running counter value at the time 'tick_count' was last brought up to date
+    int32_t                     cycles;                 // CIA cycles that have elapsed in the current tick (< cia_cycles_per_tick)
+    ticks_t                     quantum_deadline;       // when the next scheduler quantum tick is due; kTicks_Infinity while the idle vcpu is running
+    int32_t                     ticks_per_quantum;      // duration of a scheduler quantum tick in terms of clock ticks
+    timerwheel_t                deadlines;              // armed deadlines
+    uint32_t                    tick_epoch;             // number of times 'tick_count' has wrapped around
 };
 typedef struct clock* clock_ref_t;
 
@@ -52,9 +57,20 @@ extern void clock_init_mono(clock_ref_t _Nonnull self);
 
 extern void clock_start(clock_ref_t _Nonnull self);
 
-// Returns the current time in terms of clock ticks
-#define clock_getticks(__self) \
-((__self)->tick_count)
+// The clock does not deliver scheduler quantum ticks while the idle vcpu is
+// running. The scheduler calls this function when it is about to switch from
+// the idle vcpu to some other vcpu to resume the delivery of quantum ticks.
+extern void clock_resume_quantum(clock_ref_t _Nonnull self);
+
+// Returns the current time in terms of clock ticks. Note that the tick count
+// wraps around. Use ticks_before() to compare tick values.
+extern ticks_t clock_getticks(clock_ref_t _Nonnull self);
+
+// Returns the current value of a free-running counter that counts up in units
+// of CIA cycles (see 'ns_per_cia_cycle'). The counter wraps around. Meant for
+// cheaply measuring short time spans: does not mask interrupts and does not
+// update the clock time.
+extern uint32_t clock_getcycles(clock_ref_t _Nonnull self);
 
 // Returns the duration of a single clock tick in terms of seconds and nanoseconds.
 #define clock_getresolution(__self, __res) \
@@ -78,16 +94,19 @@ extern ticks_t clock_time2ticks_ceil(clock_ref_t _Nonnull self, const nanotime_t
 // Converts a clock tick value to a timespec.
 extern void clock_ticks2time(clock_ref_t _Nonnull self, ticks_t ticks, nanotime_t* _Nonnull ts);
 
+// Converts a number of clock cycles (see clock_getcycles()) to a timespec.
+extern void clock_cycles2time(clock_ref_t _Nonnull self, uint64_t cycles, nanotime_t* _Nonnull ts);
+
 
-// Registers the deadline timer 'deadline' with the clock 'self'. The deadline
-// field in the deadline structure must have been initialized to the absolute
-// time when the deadline should fire. A deadline that has fired is automatically
+// Registers the deadline timer 'deadline' with the clock 'self'. The
+// 'timer.deadline' field in the deadline structure must have been initialized
+// to the absolute time when the deadline should fire. A deadline that has fired is automatically
 // removed from the clock. The caller is responsible for keeping the deadline
 // structure alive and valid until it has fired or is cancelled.
 extern void clock_deadline(clock_ref_t _Nonnull self, clock_deadline_t* _Nonnull deadline);
 
 // Cancels the deadline timer 'deadline'. This function preserves the current
-// values of the 'deadline', 'func' and 'arg' fields. Returns true if the timer
+// values of the 'timer.deadline', 'func' and 'arg' fields. Returns true if the timer
 // was armed and has been canceled; false if the timer was already canceled.
 extern bool clock_cancel_deadline(clock_ref_t _Nonnull self, clock_deadline_t* _Nonnull deadline);
 
@@ -15,12 +15,6 @@
 #include <kern/kernlib.h>
 #include <sched/sched.h>
 
-struct ticks_ns {
-    ticks_t ticks;
-    long    ns;
-};
-
-extern void _clock_getticks_ns(const clock_ref_t _Nonnull self, struct ticks_ns* _Nonnull tnp);
 void clock_irq(clock_ref_t _Nonnull self, excpt_frame_t* _Nonnull efp);
 
 
@@ -29,7 +23,17 @@ clock_ref_t g_mono_clock = &g_mono_clock_storage;
 
 
 // Hardware timer usage:
-// Amiga: CIA_A_TIMER_B -> monotonic clock ticks
+// Amiga: CIA_A_TIMER_B -> one-shot event timer (deadlines & scheduler quantum)
+//        CIA_B_TIMER_A -> free-running counter (low word)
+//        CIA_B_TIMER_B -> free-running counter (high word). Counts CIA_B_TIMER_A underflows
+
+// Number of clock ticks per scheduler quantum tick (~17ms)
+#define CLOCK_TICKS_PER_QUANTUM 17
+
+// Shortest and longest time span that the event timer supports in terms of
+// CIA cycles
+#define CLOCK_MIN_EVENT_CYCLES  16
+#define CLOCK_MAX_EVENT_CYCLES  0xffff
 
 
 // Initializes the monotonic clock.
@@ -43,56 +47,172 @@ void clock_init_mono(clock_ref_t _Nonnull self)
     //  NTSC    28.63636 MHz
     //  PAL     28.37516 MHz
     //
-    // CIA A timer B clock:
+    // CIA clock:
     //   NTSC    0.715909 MHz (1/10th CPU clock)     [1.3968255 us]
     //   PAL     0.709379 MHz                        [1.4096836 us]
     //
     // Clock tick duration:
-    //   NTSC    16.666922 ms    [11932 timer clock cycles]     11932
-    //   PAL     16.666689 ms    [11823 timer clock cycles]     11823
+    //   NTSC    1.000127 ms    [716 timer clock cycles]
+    //   PAL     0.999466 ms    [709 timer clock cycles]
     //
     // The clock time resolution is chosen such that:
-    // - it is approx 16.667ms (60Hz)
+    // - it is approx 1ms
     // - the value is a positive integer in terms of nanoseconds to avoid accumulating / rounding errors as time progresses
     //
     // The ns_per_cia_cycle value is rounded such that:
     // ns_per_cia_cycle * cia_cycles_per_tick <= ns_per_tick
+    //
+    // The clock does not interrupt the CPU at a fixed rate. Instead the event
+    // timer is programmed as a one-shot timer that fires when the earliest
+    // deadline or the next scheduler quantum tick is due. The current time is
+    // derived from the free-running counter.
 
     self->tick_count = 0;
-    self->deadline_queue = NULL;
-    self->ns_per_tick = (is_ntsc) ? 16666922 : 16666689;
-    self->cia_cycles_per_tick = (is_ntsc) ? 11932 : 11823;
+    self->tick_epoch = 0;
+    self->ns_per_tick = (is_ntsc) ? 1000127 : 999466;
+    self->cia_cycles_per_tick = (is_ntsc) ? 716 : 709;
     self->ns_per_cia_cycle = (is_ntsc) ? 1396 : 1409;
+    self->counter = UINT32_MAX;
+    self->cycles = 0;
+    self->quantum_deadline = CLOCK_TICKS_PER_QUANTUM;
+    self->ticks_per_quantum = CLOCK_TICKS_PER_QUANTUM;
+    tw_init(&self->deadlines, 0);
+}
+
+// Returns the current value of the free-running counter. Note that the counter
+// counts down.
+static uint32_t _clock_read_counter(void)
+{
+    register uint8_t hi, lo, hi2;
+    register uint16_t hw, lw;
+
+    do {
+        hi = hw_cia_b->tbhi;
+        lo = hw_cia_b->tblo;
+        hw = (hi << 8) | lo;
+
+        hi = hw_cia_b->tahi;
+        lo = hw_cia_b->talo;
+        hi2 = hw_cia_b->tahi;
+        if (hi != hi2) {
+            lo = hw_cia_b->talo;
+        }
+        lw = (hi2 << 8) | lo;
+
+        hi = hw_cia_b->tbhi;
+        lo = hw_cia_b->tblo;
+    } while (hw != ((hi << 8) | lo));
+
+    return ((uint32_t)hw << 16) | lw;
+}
+
+// Brings 'tick_count' up to date with the free-running counter.
+// @Entry Condition: CIA A irqs masked
+static void _clock_update(clock_ref_t _Nonnull self)
+{
+    const uint32_t counter = _clock_read_counter();
+    register uint32_t cycles = self->cycles + (self->counter - counter);
+
+    self->counter = counter;
+    if (cycles >= self->cia_cycles_per_tick) {
+        const uint32_t nticks = cycles / self->cia_cycles_per_tick;
+        const ticks_t old_tick_count = self->tick_count;
+
+        self->tick_count += nticks;
+        if (self->tick_count < old_tick_count) {
+            self->tick_epoch++;
+        }
+        cycles -= nticks * self->cia_cycles_per_tick;
+    }
+    self->cycles = cycles;
+}
+
+// Returns true if the deadline 'a' is due before the deadline 'b'. Either one
+// may be kTicks_Infinity.
+static bool _clock_is_earlier(ticks_t a, ticks_t b)
+{
+    return (a != kTicks_Infinity) && (b == kTicks_Infinity || ticks_before(a, b));
+}
+
+// Returns the quantum deadline that follows 'now'
+static ticks_t _clock_next_quantum(clock_ref_t _Nonnull self, ticks_t now)
+{
+    const ticks_t deadline = now + self->ticks_per_quantum;
+
+    return (deadline != kTicks_Infinity) ? deadline : deadline + 1;
+}
+
+// Programs the event timer to fire when the earliest deadline or the next
+// quantum tick is due, whichever comes first. Expects that 'tick_count' is up
+// to date. The event timer fires at least every CLOCK_MAX_EVENT_CYCLES cycles.
+// This guarantees that the timer wheel advances often enough.
+// @Entry Condition: CIA A irqs masked
+static void _clock_arm(clock_ref_t _Nonnull self)
+{
+    const ticks_t now = self->tick_count;
+    const ticks_t next_deadline = tw_next_deadline(&self->deadlines);
+    const ticks_t deadline = (_clock_is_earlier(next_deadline, self->quantum_deadline)) ? next_deadline : self->quantum_deadline;
+    int32_t ncycles;
+
+    if (deadline == kTicks_Infinity) {
+        ncycles = CLOCK_MAX_EVENT_CYCLES;
+    }
+    else if (!ticks_before(now, deadline)) {
+        ncycles = CLOCK_MIN_EVENT_CYCLES;
+    }
+    else if (deadline - now > CLOCK_MAX_EVENT_CYCLES / self->cia_cycles_per_tick) {
+        ncycles = CLOCK_MAX_EVENT_CYCLES;
+    }
+    else {
+        ncycles = (int32_t)(deadline - now) * self->cia_cycles_per_tick - self->cycles;
+        if (ncycles < CLOCK_MIN_EVENT_CYCLES) {
+            ncycles = CLOCK_MIN_EVENT_CYCLES;
+        }
+    }
+
+
+    // Stop the timer, load the new count and restart it in one-shot mode
+    hw_cia_a->crb = 0x08;
+    hw_cia_a->tblo = ncycles & 0xff;
+    hw_cia_a->tbhi = ncycles >> 8;
+    hw_cia_a->crb = 0x19;
 }
 
 void clock_start(clock_ref_t _Nonnull self)
 {
+    // Start the free-running counter
+    hw_cia_b->talo = 0xff;
+    hw_cia_b->tahi = 0xff;
+    hw_cia_b->tblo = 0xff;
+    hw_cia_b->tbhi = 0xff;
+    hw_cia_b->crb = 0x51;
+    hw_cia_b->cra = 0x11;
+
+
+    // Start the event timer
     irq_set_direct_handler(IRQ_ID_MONOTONIC_CLOCK, (irq_direct_func_t)clock_irq, self);
     irq_enable_src(IRQ_ID_CIA_A_TIMER_B);
 
-    // Start the clock timer
-    hw_cia_a->tblo = self->cia_cycles_per_tick & 0xff;
-    hw_cia_a->tbhi = self->cia_cycles_per_tick >> 8;
-    hw_cia_a->crb = 0x11;
+    const unsigned sim = irq_set_mask(IRQ_MASK_CIA_A);
+    _clock_update(self);
+    _clock_arm(self);
+    irq_restore_mask(sim);
 }
 
 void clock_irq(clock_ref_t _Nonnull self, excpt_frame_t* _Nonnull efp)
 {
-    // update the scheduler clock
-    self->tick_count++;
+    // update the clock
+    _clock_update(self);
 
 
     // execute one-shot timers
     register const ticks_t now = self->tick_count;
-    for (;;) {
-        register clock_deadline_t* cp = self->deadline_queue;
-        
-        if (cp == NULL || cp->deadline > now) {
-            break;
-        }
-        
-        self->deadline_queue = cp->next;
-        cp->next = NULL;
+    register tw_timer_t* tp = tw_advance(&self->deadlines, now);
+    while (tp) {
+        register clock_deadline_t* cp = (clock_deadline_t*)tp;
+
+        tp = tp->next;
+        cp->timer.next = NULL;
         cp->isArmed = false;
 
         cp->func(cp->arg);
@@ -100,32 +220,75 @@ void clock_irq(clock_ref_t _Nonnull self, excpt_frame_t* _Nonnull efp)
 
 
     // run the scheduler
-    sched_on_tick_irq(g_sched, efp);
+    const bool isQuantumTick = (self->quantum_deadline != kTicks_Infinity && !ticks_before(now, self->quantum_deadline));
+
+    sched_on_tick_irq(g_sched, isQuantumTick);
+
+    if (g_sched->running == g_sched->idle_vp) {
+        self->quantum_deadline = kTicks_Infinity;
+    }
+    else if (isQuantumTick) {
+        self->quantum_deadline = _clock_next_quantum(self, now);
+    }
+
+
+    // schedule the next event
+    _clock_arm(self);
+}
+
+void clock_resume_quantum(clock_ref_t _Nonnull self)
+{
+    const unsigned sim = irq_set_mask(IRQ_MASK_CIA_A);
+
+    if (self->quantum_deadline == kTicks_Infinity) {
+        _clock_update(self);
+        self->quantum_deadline = _clock_next_quantum(self, self->tick_count);
+        _clock_arm(self);
+    }
+
+    irq_restore_mask(sim);
+}
+
+ticks_t clock_getticks(clock_ref_t _Nonnull self)
+{
+    const unsigned sim = irq_set_mask(IRQ_MASK_CIA_A);
+    _clock_update(self);
+    const ticks_t now = self->tick_count;
+    irq_restore_mask(sim);
+
+    return now;
+}
+
+uint32_t clock_getcycles(clock_ref_t _Nonnull self)
+{
+    return ~_clock_read_counter();
+}
+
+void clock_cycles2time(clock_ref_t _Nonnull self, uint64_t cycles, nanotime_t* _Nonnull ts)
+{
+    const uint64_t ns = cycles * (uint64_t)self->ns_per_cia_cycle;
+
+    ts->tv_sec = ns / (uint64_t)NSEC_PER_SEC;
+    ts->tv_nsec = ns - ((uint64_t)ts->tv_sec * (uint64_t)NSEC_PER_SEC);
 }
 
 void clock_deadline(clock_ref_t _Nonnull self, clock_deadline_t* _Nonnull deadline)
 {
     const unsigned sim = irq_set_mask(IRQ_MASK_CIA_A);
-    register clock_deadline_t* pp = NULL;
-    register clock_deadline_t* cp = self->deadline_queue;
+    const ticks_t next_deadline = tw_next_deadline(&self->deadlines);
 
     assert(!deadline->isArmed);
 
-    while (cp && cp->deadline <= deadline->deadline) {
-        pp = cp;
-        cp = cp->next;
-    }
-    
-    if (pp) {
-        deadline->next = pp->next;
-        pp->next = deadline;
-    }
-    else {
-        deadline->next = self->deadline_queue;
-        self->deadline_queue = deadline;
-    }
+    tw_insert(&self->deadlines, &deadline->timer);
     deadline->isArmed = true;
 
+    // Re-arm the event timer if it would otherwise fire too late for the new
+    // deadline
+    if (_clock_is_earlier(deadline->timer.deadline, next_deadline) && _clock_is_earlier(deadline->timer.deadline, self->quantum_deadline)) {
+        _clock_update(self);
+        _clock_arm(self);
+    }
+
     irq_restore_mask(sim);
 }
 
@@ -135,25 +298,7 @@ bool clock_cancel_deadline(clock_ref_t _Nonnull self, clock_deadline_t* _Nonnull
     bool r = false;
 
     if (deadline->isArmed) {
-        register clock_deadline_t* pp = NULL;
-        register clock_deadline_t* cp = self->deadline_queue;
-
-        while (cp) {
-            if (cp == deadline) {
-                if (pp) {
-                    pp->next = cp->next;
-                }
-                else {
-                    self->deadline_queue = cp->next;
-                }
-                break;
-            }
-
-            pp = cp;
-            cp = cp->next;
-        }
-
-        deadline->next = NULL;
+        tw_remove(&self->deadlines, &deadline->timer);
         deadline->isArmed = false;
         r = true;
     }
@@ -163,18 +308,38 @@ bool clock_cancel_deadline(clock_ref_t _Nonnull self, clock_deadline_t* _Nonnull
     return r;
 }
 
+// Converts the tick count 'ticks' of the tick epoch 'epoch' to a timespec. The
+// time keeps counting up when the tick count wraps around.
+static void _clock_epoch_ticks2time(clock_ref_t _Nonnull self, uint32_t epoch, ticks_t ticks, nanotime_t* _Nonnull ts)
+{
+    const uint64_t ns = (((uint64_t)epoch << 32) + (uint64_t)ticks) * (uint64_t)self->ns_per_tick;
+
+    ts->tv_sec = ns / (uint64_t)NSEC_PER_SEC;
+    ts->tv_nsec = ns - ((uint64_t)ts->tv_sec * (uint64_t)NSEC_PER_SEC);
+}
+
 void clock_gettime(clock_ref_t _Nonnull self, nanotime_t* _Nonnull ts)
 {
-    clock_ticks2time(self, self->tick_count, ts);
+    const unsigned sim = irq_set_mask(IRQ_MASK_CIA_A);
+    _clock_update(self);
+    const ticks_t ticks = self->tick_count;
+    const uint32_t epoch = self->tick_epoch;
+    irq_restore_mask(sim);
+
+    _clock_epoch_ticks2time(self, epoch, ticks, ts);
 }
 
 void clock_gettime_hires(clock_ref_t _Nonnull self, nanotime_t* _Nonnull ts)
 {
-    struct ticks_ns ticks_ns;
-    
-    _clock_getticks_ns(self, &ticks_ns);
-    clock_ticks2time(self, ticks_ns.ticks, ts);
-    ts->tv_nsec += ticks_ns.ns;
+    const unsigned sim = irq_set_mask(IRQ_MASK_CIA_A);
+    _clock_update(self);
+    const ticks_t ticks = self->tick_count;
+    const uint32_t epoch = self->tick_epoch;
+    const long ns = self->cycles * self->ns_per_cia_cycle;
+    irq_restore_mask(sim);
+
+    _clock_epoch_ticks2time(self, epoch, ticks, ts);
+    ts->tv_nsec += ns;
     if (ts->tv_nsec >= NSEC_PER_SEC) {
         ts->tv_sec++;
         ts->tv_nsec -= NSEC_PER_SEC;
@@ -10,48 +10,11 @@
     include <hal/hw/m68k/lowmem.i>
 
 
-    xdef __clock_getticks_ns
     xdef _clock_time2ticks_floor
     xdef _clock_time2ticks_ceil
     xdef _clock_ticks2time
 
 
-;-------------------------------------------------------------------------------
-; void _clock_getticks_ns(const clock_ref_t _Nonnull self, struct ticks_ns* _Nonnull tnp)
-; Returns the current tick and the amount of nanoseconds that have elapsed so
-; far in the current clock tick.
-__clock_getticks_ns:
-    cargs cgtn_clock_ptr.l, cgtn_tn_ptr.l
-
-    move.l  cgtn_clock_ptr(sp), a0
-    move.l  cgtn_tn_ptr(sp), a1
-    move.l  d2, -(sp)
-
-.1:
-    move.l  mtc_tick_count(a0), d0
-
-    ; read the current timer value
-    moveq.l #0, d1
-    move.b  CIAATBHI, d1
-    lsl.w   #8, d1
-    move.b  CIAATBLO, d1
-
-    cmp.l   mtc_tick_count(a0), d0
-    bne.s   .1
-
-    ; elapsed_ns = (cia_cycles_per_tick - current_cycles) * ns_per_cycle
-    moveq.l #0, d2
-    move.w  mtc_cia_cycles_per_tick(a0), d2
-    sub.w   d1, d2
-    mulu.w  mtc_ns_per_cia_cycle(a0), d2
-
-    move.l  d0, 0(a1)
-    move.l  d2, 4(a1)
-
-    move.l  (sp)+, d2
-    rts
-
-
 ;-------------------------------------------------------------------------------
 ; ticks_t clock_time2ticks_floor(clock_ref_t _Nonnull self, const nanotime_t* _Nonnull ts)
 ;
@@ -81,12 +81,17 @@ sd_SIZEOF                       so
 ; The struct clock object
     clrso
 mtc_tick_count                  so.l    1       ; 4
-mtc_deadline_queue              so.l    1       ; 4
 mtc_ns_per_tick                 so.l    1       ; 4
 mtc_cia_cycles_per_tick         so.w    1       ; 2
 mtc_ns_per_cia_cycle            so.w    1       ; 2
+mtc_counter                     so.l    1       ; 4
+mtc_cycles                      so.l    1       ; 4
+mtc_quantum_deadline            so.l    1       ; 4
+mtc_ticks_per_quantum           so.l    1       ; 4
+mtc_deadlines                   so.b    532     ; 532
+mtc_tick_epoch                  so.l    1       ; 4
 mtc_SIZEOF                      so
-    ifeq (mtc_SIZEOF == 16)
+    ifeq (mtc_SIZEOF == 564)
         fail "clock_ref_t structure size is incorrect."
     endif
 
@@ -106,13 +111,14 @@ sched_irq_nest_count                so.b    1       ; 1
 sched_reserved2                     so.b    1       ; 1
 sched_idle_virtual_processor        so.l    1       ; 4
 sched_boot_virtual_processor        so.l    1       ; 4
-sched_sys_ticks                     so.l    1       ; 4
-sched_usr_ticks                     so.l    1       ; 4
-sched_idle_ticks                    so.l    1       ; 4
+sched_sys_cycles                    so.l    2       ; 8
+sched_usr_cycles                    so.l    2       ; 8
+sched_idle_cycles                   so.l    2       ; 8
 sched_ready_queue                   so.l    SCHED_PRI_COUNT * 2 ; 640
 sched_ready_queue_populated         so.l    3       ; 3
+sched_stats                         so.b    1092    ; 1092
 sched_SIZEOF                        so
-    ifeq (sched_SIZEOF == 684)
+    ifeq (sched_SIZEOF == 1788)
         fail "sched_t structure size is incorrect."
     endif
 
@@ -154,7 +160,11 @@ vp_excpt_state_cpu_code                 so.w    1           ; 2
 vp_pending_sigs                         so.l    1           ; 4
 vp_wait_sigs                            so.l    1           ; 4
 vp_timeout_next                         so.l    1           ; 4
+vp_timeout_prev                         so.l    1           ; 4
 vp_timeout_deadline                     so.l    1           ; 4
+vp_timeout_level                        so.b    1           ; 1
+vp_timeout_slot                         so.b    1           ; 1
+vp_timeout_reserved2                    so.b    2           ; 2
 vp_timeout_func                         so.l    1           ; 4
 vp_timeout_arg                          so.l    1           ; 4
 vp_timeout_is_armed                     so.b    1           ; 1
@@ -172,16 +182,22 @@ vp_flags                                so.b    1           ; 1
 vp_quantum_countdown                    so.b    1           ; 1
 vp_suspension_count                     so.w    1           ; 2
 vp_tag                                  so.b    1           ; 1
-vp_reserved                             so.b    1           ; 1
+vp_inherited_priority                   so.b    1           ; 1
 vp_acquisition_time_secs                so.l    1           ; 4
 vp_acquisition_time_nanos               so.l    1           ; 4
-vp_usr_ticks                           so.l    1           ; 4
-vp_sys_ticks                         so.l    1           ; 4
+vp_usr_cycles                           so.l    2           ; 8
+vp_sys_cycles                           so.l    2           ; 8
 vp_wait_ticks                           so.l    1           ; 4
+vp_ready_stamp                          so.l    1           ; 4
+vp_dispatch_stamp                       so.l    1           ; 4
+vp_acct_stamp                           so.l    1           ; 4
 vp_proc                                 so.l    1           ; 4
 vp_dispatch_worker                      so.l    1           ; 4
+vp_pi_locks_first                       so.l    1           ; 4
+vp_pi_locks_last                        so.l    1           ; 4
+vp_pi_blocked_on                        so.l    1           ; 4
 vp_SIZEOF                               so
-    ifeq (vp_SIZEOF == 158)
+    ifeq (vp_SIZEOF == 198)
         fail "vcpu structure size is incorrect."
     endif
 
@@ -10,7 +10,7 @@
     include "lowmem.i"
 
     xref _g_sched
-    xref _mtx_onwait
+    xref _mtx_oncontended
     xref _mtx_wake
     xref _mtx_wake_then_wait
 
@@ -26,6 +26,15 @@ mtx_value               so.l    1    ; bit #7 == 1 -> lock is in acquired state;
 mtx_wait_queue_first    so.l    1
 mtx_wait_queue_last     so.l    1
 mtx_owner               so.l    1
+mtx_pi_qe_next          so.l    1
+mtx_pi_qe_prev          so.l    1
+mtx_pi_is_linked        so.b    1
+mtx_pi_reserved         so.b    3
+mtx_acquisitions        so.l    1
+mtx_contentions         so.l    1
+mtx_yields              so.l    1
+mtx_waits               so.l    1
+mtx_wait_cycles         so.l    2
 mtx_SIZEOF              so
 
 
@@ -46,6 +55,7 @@ _mtx_trylock:
     ; update mutex ownership info
     GET_CURRENT_VP a1
     move.l  a1, mtx_owner(a0)
+    addq.l  #1, mtx_acquisitions(a0)
 
     ; return EOK
     moveq.l #1, d0
@@ -74,31 +84,27 @@ _mtx_lock:
     bset    #7, mtx_value(a0)
     beq.s   .l_acquired_mutex
 
-    ; The mutex is held by someone else - wait and then retry.
-    ; First recheck the mutex after we have disable preemption. we have to do this
-    ; because the VP who held the mutex may have dropped it by now but we are not
-    ; yet on the wait queue and thus the other VP isn't able to wake us up and
-    ; cause us to retry.
+    ; The mutex is held by someone else - let mtx_oncontended() acquire it with
+    ; preemption disabled. It retries the mutex before it yields or waits because
+    ; the VP who held the mutex may have dropped it by now. It records the owner
+    ; before we reenable preemption so that a vcpu which blocks on the mutex
+    ; right after us is able to lend its priority to us
     DISABLE_PREEMPTION d7
 
-.l_retry:
-    move.l  l_mtx_ptr(sp), a0
-    bset    #7, mtx_value(a0)
-    beq.s   .l_acquired_slow
-
-    move.l  a0, -(sp)
-    jsr     _mtx_onwait
+    move.l  l_mtx_ptr(sp), -(sp)
+    jsr     _mtx_oncontended
     addq.l  #4, sp
 
-    bra.s   .l_retry
-
-.l_acquired_slow:
     RESTORE_PREEMPTION d7
 
+    move.l  (sp)+, d7
+    rts
+
 .l_acquired_mutex:
     GET_CURRENT_VP a1
     move.l  l_mtx_ptr(sp), a0
     move.l  a1, mtx_owner(a0)
+    addq.l  #1, mtx_acquisitions(a0)
 
     move.l  (sp)+, d7
     rts
@@ -118,6 +118,11 @@ errno_t Handler_truncate(HandlerRef _Nonnull self, off_t length)
     return EINVAL;
 }
 
+errno_t Handler_sync(HandlerRef _Nonnull self, int flags)
+{
+    return EINVAL;
+}
+
 
 class_func_defs(Handler, Object,
 func_def(read, Handler)
@@ -126,4 +131,5 @@ func_def(seek, Handler)
 func_def(control, Handler)
 func_def(getAttributes, Handler)
 func_def(truncate, Handler)
+func_def(sync, Handler)
 );
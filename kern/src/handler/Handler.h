@@ -83,6 +83,14 @@ open_class_funcs(Handler, Object,
     // Default: Returns EBADF
     errno_t (*truncate)(void* _Nonnull self, off_t length);
 
+    // Synchronously writes all cached and modified data of the Inode to which
+    // the channel is connected to the underlying storage. Only writes the file
+    // data and the metadata that is required to read the data back if 'flags'
+    // includes FD_SYNC_DATA.
+    // Override: Optional
+    // Default: Returns EINVAL
+    errno_t (*sync)(void* _Nonnull self, int flags);
+
     // Execute a resource specific command.
     errno_t (*control)(void* _Nonnull self, int cmd, va_list ap);
 );
@@ -116,6 +124,9 @@ invoke_n(getAttributes, Handler, __self, __attr)
 #define Handler_Truncate(__self, __length) \
 invoke_n(truncate, Handler, __self, __length)
 
+#define Handler_Sync(__self, __flags) \
+invoke_n(sync, Handler, __self, __flags)
+
 #define Handler_Control(__self, __cmd, __ap) \
 invoke_n(control, Handler, __self, __cmd, __ap)
 
@@ -14,6 +14,7 @@
 #include <kern/kalloc.h>
 #include <kpi/fd.h>
 #include <kpi/syslimits.h>
+#include <sched/sched.h>
 
 
 #define FDTAB_PAGE_SHIFT    7
@@ -22,8 +23,7 @@
 
 void HandlerTable_Init(HandlerTable* _Nonnull self)
 {
-    self->table = NULL;
-    self->table_size = 0;
+    self->tab = NULL;
     self->max_fd_num = -1;
     mtx_init(&self->mtx);
 }
@@ -37,9 +37,10 @@ void HandlerTable_Deinit(HandlerTable* _Nonnull self)
 static errno_t _ensure_fd_slot_exists(HandlerTable* _Nonnull _Locked self, int fd_slot)
 {
     decl_try_err();
-    void* new_table;
+    fdtab_t* old_tab = self->tab;
+    fdtab_t* new_tab;
 
-    if (self->table_size > fd_slot) {
+    if (old_tab && old_tab->size > fd_slot) {
         return EOK;
     }
     if (fd_slot > _FDNO_MAX) {
@@ -49,22 +50,25 @@ static errno_t _ensure_fd_slot_exists(HandlerTable* _Nonnull _Locked self, int f
 
     const int new_page_count = (fd_slot >> FDTAB_PAGE_SHIFT) + 1;
     const int new_table_size = new_page_count * FDTAB_PAGE_SIZE;
-    const int new_memblk_size = new_table_size * sizeof(HandlerRef);
+    const int new_memblk_size = sizeof(fdtab_t) + (new_table_size - 1) * sizeof(HandlerRef);
     if (new_memblk_size < 0) {
         // overflow
         return EMFILE;
     }
 
 
-    err = kalloc_cleared(new_memblk_size, &new_table);
+    err = kalloc_cleared(new_memblk_size, (void**)&new_tab);
     if (err == EOK) {
-        if (self->table) {
-            memcpy(new_table, self->table, sizeof(HandlerRef) * (self->max_fd_num + 1));
-            kfree(self->table);
+        new_tab->size = new_table_size;
+        if (old_tab) {
+            memcpy(new_tab->slot, old_tab->slot, sizeof(HandlerRef) * (self->max_fd_num + 1));
         }
 
-        self->table = new_table;
-        self->table_size = new_table_size;
+        // Readers pick up either the old or the new table. Both hold the same
+        // handlers at this point. No reader can still be looking at the old
+        // table once we get to run, so it can be freed right away.
+        self->tab = new_tab;
+        kfree(old_tab);
     }
 
     return err;
@@ -76,15 +80,18 @@ static errno_t _alloc_fd_slot(HandlerTable* _Nonnull _Locked self, int min_fd, i
     int new_fd = -1;
 
     do {
-        for (int i = min_fd; i < self->table_size; i++) {
-            if (self->table[i] == NULL) {
+        fdtab_t* tab = self->tab;
+        const int tab_size = (tab) ? tab->size : 0;
+
+        for (int i = min_fd; i < tab_size; i++) {
+            if (tab->slot[i] == NULL) {
                 *out_fd = i;
                 self->max_fd_num = __max(self->max_fd_num, i);
                 return EOK;
             }
         }
 
-        err = _ensure_fd_slot_exists(self, self->table_size);
+        err = _ensure_fd_slot_exists(self, __max(tab_size, min_fd));
     } while (err == EOK);
 
     return err;
@@ -92,15 +99,24 @@ static errno_t _alloc_fd_slot(HandlerTable* _Nonnull _Locked self, int min_fd, i
 
 static void _clear_fd_slot(HandlerTable* _Nonnull _Locked self, int fd)
 {
-    self->table[fd] = NULL;
+    fdtab_t* tab = self->tab;
+
+    tab->slot[fd] = NULL;
 
     if (fd == self->max_fd_num) {
-        while (self->max_fd_num >= 0 && self->table[self->max_fd_num] == NULL) {
+        while (self->max_fd_num >= 0 && tab->slot[self->max_fd_num] == NULL) {
             self->max_fd_num--;
         }
     }
 }
 
+// Returns the handler at 'fd' if it exists and NULL otherwise. Does not retain
+// the handler.
+static HandlerRef _Nullable _get_fd_slot(HandlerTable* _Nonnull _Locked self, int fd)
+{
+    return (fd >= 0 && fd <= self->max_fd_num) ? self->tab->slot[fd] : NULL;
+}
+
 errno_t HandlerTable_AdoptHandler(HandlerTable* _Nonnull self, HandlerRef _Consuming _Nonnull hnd, int * _Nonnull pOutIoc)
 {
     decl_try_err();
@@ -110,7 +126,7 @@ errno_t HandlerTable_AdoptHandler(HandlerTable* _Nonnull self, HandlerRef _Consu
 
     err = _alloc_fd_slot(self, 0, &new_fd);
     if (err == EOK) {
-        self->table[new_fd] = hnd;
+        self->tab->slot[new_fd] = hnd;
     }
 
     mtx_unlock(&self->mtx);
@@ -121,19 +137,25 @@ errno_t HandlerTable_AdoptHandler(HandlerTable* _Nonnull self, HandlerRef _Consu
 
 errno_t HandlerTable_CopyHandler(HandlerTable* _Nonnull self, int fd, HandlerRef _Nullable * _Nonnull pOutHandler)
 {
-    decl_try_err();
-
-    mtx_lock(&self->mtx);
+    HandlerRef hnd = NULL;
 
-    if (fd >= 0 && fd <= self->max_fd_num && self->table[fd]) {
-        *pOutHandler = Object_Retain(self->table[fd]);
-    }
-    else {
-        err = EBADF;
+    // Lock-free lookup. A slot owns a strong reference to its handler and a
+    // writer can not clear the slot or swap out the table while we are running
+    // with preemption disabled. So the handler is guaranteed to be alive while
+    // we retain it.
+    const int sps = preempt_disable();
+    const fdtab_t* tab = self->tab;
+
+    if (tab && fd >= 0 && fd < tab->size) {
+        hnd = tab->slot[fd];
+        if (hnd) {
+            Object_Retain(hnd);
+        }
     }
-    
-    mtx_unlock(&self->mtx);
-    return err;
+    preempt_restore(sps);
+
+    *pOutHandler = hnd;
+    return (hnd) ? EOK : EBADF;
 }
 
 errno_t HandlerTable_DupHandler(HandlerTable* _Nonnull self, int fd, int min_fd, int * _Nonnull pOutNewIoc)
@@ -143,12 +165,16 @@ errno_t HandlerTable_DupHandler(HandlerTable* _Nonnull self, int fd, int min_fd,
 
     mtx_lock(&self->mtx);
 
-    if (fd >= 0 && fd <= self->max_fd_num && self->table[fd]) {
+    HandlerRef hnd = _get_fd_slot(self, fd);
+    if (hnd) {
         err = _alloc_fd_slot(self, min_fd, &new_fd);
         if (err == EOK) {
-            self->table[new_fd] = Object_Retain(self->table[fd]);
+            self->tab->slot[new_fd] = Object_Retain(hnd);
         }
     }
+    else {
+        err = EBADF;
+    }
 
     mtx_unlock(&self->mtx);
 
@@ -160,13 +186,15 @@ errno_t HandlerTable_DupHandlerTo(HandlerTable* _Nonnull self, int fd, HandlerTa
 {
     decl_try_err();
     HandlerRef hnd_to_close = NULL;
+    HandlerRef hnd;
 
     mtx_lock(&self->mtx);
     if (self != other) {
         mtx_lock(&other->mtx);
     }
 
-    if (fd < 0 || fd > self->max_fd_num || self->table[fd] == NULL) {
+    hnd = _get_fd_slot(self, fd);
+    if (hnd == NULL) {
         throw(EBADF);
     }
     if (target_fd < 0) {
@@ -176,14 +204,14 @@ errno_t HandlerTable_DupHandlerTo(HandlerTable* _Nonnull self, int fd, HandlerTa
 
     if (target_fd <= other->max_fd_num) {
         // target-fd slot exists: close the existing fd and replace with the new one
-        hnd_to_close = other->table[target_fd];
+        hnd_to_close = other->tab->slot[target_fd];
     }
     else {
         // target_fd slot does not exist: allocate it
         try(_ensure_fd_slot_exists(other, target_fd));
     }
 
-    other->table[target_fd] = Object_Retain(self->table[fd]);
+    other->tab->slot[target_fd] = Object_Retain(hnd);
     other->max_fd_num = __max(other->max_fd_num, target_fd);
 
 
@@ -214,8 +242,8 @@ errno_t HandlerTable_CloseHandler(HandlerTable* _Nonnull self, int fd)
     // data.
     mtx_lock(&self->mtx);
 
-    if (fd >= 0 && fd <= self->max_fd_num && self->table[fd]) {
-        hnd = self->table[fd];
+    hnd = _get_fd_slot(self, fd);
+    if (hnd) {
         _clear_fd_slot(self, fd);
     }
 
@@ -233,26 +261,27 @@ errno_t HandlerTable_CloseHandler(HandlerTable* _Nonnull self, int fd)
 
 void HandlerTable_CloseAll(HandlerTable* _Nonnull self)
 {
-    HandlerRef* table;
+    fdtab_t* tab;
     int max_fd_num;
 
     mtx_lock(&self->mtx);
-    table = self->table;
+    tab = self->tab;
     max_fd_num = self->max_fd_num;
 
-    self->table = NULL;
-    self->table_size = 0;
+    self->tab = NULL;
     self->max_fd_num = -1;
     mtx_unlock(&self->mtx);
 
 
-    for (int i = 0; i < max_fd_num; i++) {
-        if (table[i]) {
-            Object_Release(table[i]);
-            table[i] = NULL;
+    if (tab) {
+        for (int i = 0; i <= max_fd_num; i++) {
+            if (tab->slot[i]) {
+                Object_Release(tab->slot[i]);
+                tab->slot[i] = NULL;
+            }
         }
+        kfree(tab);
     }
-    kfree(table);
 }
 
 void HandlerTable_CloseHandlersOnExec(HandlerTable* _Nonnull self)
@@ -263,16 +292,18 @@ void HandlerTable_CloseHandlersOnExec(HandlerTable* _Nonnull self)
     fd = self->max_fd_num;
 
     while (fd >= 0) {
-        HandlerRef hnd = self->table[fd];
+        HandlerRef hnd = self->tab->slot[fd];
 
         if (hnd && (Handler_GetFlags(hnd) & O_PRSVEXEC) == 0) {
+            // Clear the slot before the release because the release may block
+            // and a lock-free reader must not find a dead handler in the table
+            self->tab->slot[fd] = NULL;
             Object_Release(hnd);
-            self->table[fd] = NULL;
         }
         fd--;
     }
 
-    while (self->max_fd_num >= 0 && self->table[self->max_fd_num] == NULL) {
+    while (self->max_fd_num >= 0 && self->tab->slot[self->max_fd_num] == NULL) {
         self->max_fd_num--;
     }
 
@@ -13,11 +13,25 @@
 #include <sched/mtx.h>
 
 
+// The descriptor slots and the number of slots live in a single memory block
+// so that a reader always sees a size that matches the slot array it is
+// indexing.
+typedef struct fdtab {
+    int                             size;
+    HandlerRef _Nullable            slot[1];
+} fdtab_t;
+
+
+// Descriptor lookups (HandlerTable_CopyHandler) do not take the table lock.
+// They run with preemption disabled and pick up the current table with a single
+// pointer load. Everything that modifies the table takes the lock. Growing the
+// table replaces 'tab' with a larger copy. The old table is freed right away
+// because a writer can only run while no reader is inside its preemption-
+// disabled section (uniprocessor kernel).
 typedef struct HandlerTable {
-    HandlerRef _Nullable * _Nonnull table;
-    int                             table_size;
-    int                             max_fd_num;
-    mtx_t                           mtx;
+    fdtab_t* _Nullable volatile     tab;
+    int                             max_fd_num;     // protected by 'mtx'
+    mtx_t                           mtx;            // serializes adopt, dup, close and table growth
 } HandlerTable;
 
 
@@ -32,7 +46,8 @@ extern errno_t HandlerTable_AdoptHandler(HandlerTable* _Nonnull self, HandlerRef
 // Returns the handler that is named by the descriptor 'fd'. The handler is
 // guaranteed to stay alive until it is released. You should release the handler
 // by calling Object_Release() once done. Returns the handler and EOK on success
-// and a suitable error and NULL otherwise.
+// and a suitable error and NULL otherwise. This function does not take the
+// table lock.
 extern errno_t HandlerTable_CopyHandler(HandlerTable* _Nonnull self, int fd, HandlerRef _Nullable * _Nonnull pOutHandler);
 
 // Creates a new named reference of the handler 'fd'. The new descriptor/name
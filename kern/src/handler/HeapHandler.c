@@ -0,0 +1,196 @@
+//
+//  HeapHandler.c
+//  kernel
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#include "HeapHandler.h"
+#include <string.h>
+#include <ext/__fmt.h>
+#include <ext/math.h>
+#include <diskcache/DiskCache.h>
+#include <hal/clock.h>
+#include <kern/kalloc.h>
+#include <process/ProcessPriv.h>
+
+#define REPORT_SIZE         2048
+#define REPORT_LINE_SIZE    80
+
+
+typedef struct report {
+    fmt_t       fmt;
+    char*       buf;
+    ssize_t     capacity;
+    ssize_t     length;
+} report_t;
+
+
+static ssize_t _report_write(report_t* _Nonnull self, const void* _Nonnull buf, ssize_t nbytes)
+{
+    const ssize_t n = __min(nbytes, self->capacity - self->length);
+
+    memcpy(&self->buf[self->length], buf, n);
+    self->length += n;
+    return n;
+}
+
+static ssize_t _report_putc(char ch, report_t* _Nonnull self)
+{
+    return _report_write(self, &ch, 1);
+}
+
+static void _report_printf(report_t* _Nonnull self, const char* _Nonnull format, ...)
+{
+    va_list ap;
+
+    va_start(ap, format);
+    __fmt_print(&self->fmt, format, ap);
+    va_end(ap);
+}
+
+static void _report_heap(report_t* _Nonnull self, const char* _Nonnull name, unsigned int options)
+{
+    kalloc_stats_t st;
+
+    if (kalloc_getstats(options, &st) != EOK) {
+        return;
+    }
+
+    const size_t frag = (st.free_bytes > 0) ? 100 - (st.largest_free_size * 100) / st.free_bytes : 0;
+
+    _report_printf(self, "%s:\n", name);
+    _report_printf(self, "  used: %zu bytes in %zu blocks, peak %zu bytes\n", st.used_bytes, st.used_block_count, st.peak_used_bytes);
+    _report_printf(self, "  free: %zu bytes in %zu blocks, largest %zu bytes, %zu%% fragmented\n", st.free_bytes, st.free_block_count, st.largest_free_size, frag);
+    _report_printf(self, "  regions: %d, allocs: %u, frees: %u, fallbacks: %u\n", st.region_count, st.allocs, st.frees, st.fallback_allocs);
+    _report_printf(self, "  allocs per size class:");
+    for (int i = 0; i < KALLOC_SIZE_CLASS_COUNT; i++) {
+        _report_printf(self, " %u", st.allocs_per_class[i]);
+    }
+    _report_printf(self, "\n");
+}
+
+static void _report_tags(report_t* _Nonnull self)
+{
+    kalloc_tag_stats_t ts;
+
+    _report_printf(self, "tags:\n");
+    for (int tag = KALLOC_TAG_NONE + 1; tag < KALLOC_TAG_COUNT; tag++) {
+        if (kalloc_gettagstats(tag, &ts) == EOK) {
+            _report_printf(self, "  %s: unified %zu, cpu %zu bytes in %zu blocks, peak %zu bytes, allocs: %u, failures: %u\n", kalloc_tagname(tag), ts.unified_bytes, ts.cpu_bytes, ts.block_count, ts.peak_bytes, ts.allocs, ts.failures);
+        }
+    }
+}
+
+static void _report_lock(report_t* _Nonnull self, const char* _Nonnull name, const mtx_stats_t* _Nonnull st)
+{
+    const uint32_t wait_us = (uint32_t)((st->wait_cycles * g_mono_clock->ns_per_cia_cycle) / 1000);
+
+    _report_printf(self, "  %s: %u acq, %u cont, %u yields, %u waits, %u us waited\n", name, st->acquisitions, st->contentions, st->yields, st->waits, wait_us);
+}
+
+// Reports the contention statistics of the hot kernel locks. The handler table
+// is the one of the process that opened the device.
+static void _report_locks(report_t* _Nonnull self)
+{
+    ProcessRef pp = vcpu_current()->proc;
+    mtx_stats_t st;
+
+    _report_printf(self, "locks:\n");
+    kalloc_getlockstats(&st);
+    _report_lock(self, "kalloc", &st);
+    DiskCache_GetLockStats(gDiskCache, &st);
+    _report_lock(self, "disk cache", &st);
+    mtx_getstats(&pp->HandlerTable.mtx, &st);
+    _report_lock(self, "handler table", &st);
+}
+
+static void _report_block(void* _Nullable ctx, void* _Nonnull ptr, size_t size, const char* _Nullable site)
+{
+    report_t* self = ctx;
+
+    if (site) {
+        _report_printf(self, "  %p %zu %s\n", ptr, size, site);
+    }
+}
+
+
+errno_t HeapHandler_Create(InodeRef _Nonnull ip, fd_flags_t flags, HandlerRef _Nullable * _Nonnull pOutHandler)
+{
+    decl_try_err();
+    struct HeapHandler* self = NULL;
+    report_t r;
+
+    try(PseudoHandler_Create(class(HeapHandler), FD_TYPE_DEVICE, ip, flags, (HandlerRef*)&self));
+    mtx_init(&self->mtx);
+
+
+    // Leave room for one line per allocated block if blocks carry their
+    // allocation site
+    r.capacity = REPORT_SIZE;
+    if (KALLOC_TRACK_SITES) {
+        kalloc_stats_t st;
+
+        if (kalloc_getstats(KALLOC_OPTION_UNIFIED, &st) == EOK) {
+            r.capacity += st.used_block_count * REPORT_LINE_SIZE;
+        }
+        if (kalloc_getstats(0, &st) == EOK) {
+            r.capacity += st.used_block_count * REPORT_LINE_SIZE;
+        }
+    }
+    r.length = 0;
+    try(kalloc(r.capacity, (void**)&r.buf));
+    __fmt_init_i(&r.fmt, &r, (fmt_putc_t)_report_putc, (fmt_write_t)_report_write, false);
+
+    _report_heap(&r, "unified", KALLOC_OPTION_UNIFIED);
+    _report_heap(&r, "cpu", 0);
+    _report_tags(&r);
+    _report_locks(&r);
+    if (KALLOC_TRACK_SITES) {
+        _report_printf(&r, "blocks:\n");
+        kalloc_visit(_report_block, &r);
+    }
+    __fmt_deinit(&r.fmt);
+
+    self->text = r.buf;
+    self->textLength = r.length;
+
+catch:
+    if (err != EOK && self) {
+        Object_Release(self);
+        self = NULL;
+    }
+    *pOutHandler = (HandlerRef)self;
+    return err;
+}
+
+void HeapHandler_deinit(struct HeapHandler* _Nonnull self)
+{
+    kfree(self->text);
+    self->text = NULL;
+    mtx_deinit(&self->mtx);
+}
+
+errno_t HeapHandler_read(struct HeapHandler* _Nonnull self, void* _Nonnull buf, ssize_t nBytesToRead, ssize_t* _Nonnull nOutBytesRead)
+{
+    if ((Handler_GetFlags(self) & O_RDONLY) == 0) {
+        return EBADF;
+    }
+
+    mtx_lock(&self->mtx);
+    const ssize_t n = __min(nBytesToRead, self->textLength - self->offset);
+
+    memcpy(buf, &self->text[self->offset], n);
+    self->offset += n;
+    mtx_unlock(&self->mtx);
+
+    *nOutBytesRead = n;
+    return EOK;
+}
+
+
+class_func_defs(HeapHandler, PseudoHandler,
+override_func_def(deinit, HeapHandler, Object)
+override_func_def(read, HeapHandler, Handler)
+);
@@ -0,0 +1,33 @@
+//
+//  HeapHandler.h
+//  kernel
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#ifndef HeapHandler_h
+#define HeapHandler_h
+
+#include <handler/PseudoHandler.h>
+#include <sched/mtx.h>
+
+
+// Reads return a text report of the kernel heap statistics and of the
+// contention statistics of the hot kernel locks. The report is taken when the
+// handler is created and reading it doesn't take the heap lock. The report
+// lists every allocated block with its allocation site if the kernel is built
+// with KALLOC_TRACK_SITES.
+open_class(HeapHandler, PseudoHandler,
+    mtx_t               mtx;
+    char* _Nullable     text;
+    ssize_t             textLength;
+    ssize_t             offset;         // Protected by 'mtx'
+);
+open_class_funcs(HeapHandler, PseudoHandler,
+);
+
+
+extern errno_t HeapHandler_Create(InodeRef _Nonnull ip, fd_flags_t flags, HandlerRef _Nullable * _Nonnull pOutHandler);
+
+#endif /* HeapHandler_h */
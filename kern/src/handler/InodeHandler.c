@@ -137,6 +137,21 @@ errno_t InodeHandler_truncate(InodeHandlerRef _Nonnull self, off_t length)
     return err;
 }
 
+errno_t InodeHandler_sync(InodeHandlerRef _Nonnull self, int flags)
+{
+    decl_try_err();
+
+    if ((flags & ~(FD_SYNC_DATA | FD_SYNC_PURGE)) != 0) {
+        return EINVAL;
+    }
+
+    Inode_Lock(self->ino);
+    err = Inode_Sync(self->ino, flags);
+    Inode_Unlock(self->ino);
+    
+    return err;
+}
+
 
 class_func_defs(InodeHandler, Handler,
 override_func_def(deinit, InodeHandler, Object)
@@ -145,4 +160,5 @@ override_func_def(write, InodeHandler, Handler)
 override_func_def(seek, InodeHandler, Handler)
 override_func_def(getAttributes, InodeHandler, Handler)
 override_func_def(truncate, InodeHandler, Handler)
+override_func_def(sync, InodeHandler, Handler)
 );
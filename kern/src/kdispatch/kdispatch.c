@@ -11,6 +11,21 @@
 #include <process/kerneld.h>
 
 
+kcache_t _Nonnull   g_kdispatch_item_cache;
+kcache_t _Nonnull   g_kdispatch_timer_cache;
+
+
+errno_t kdispatch_init(void)
+{
+    decl_try_err();
+
+    try(kcache_create("kdispatch_conv_item", sizeof(struct kdispatch_conv_item), NULL, KCACHE_OPTION_TAG(KALLOC_TAG_DISPATCH), &g_kdispatch_item_cache));
+    try(kcache_create("kdispatch_timer", sizeof(struct kdispatch_timer), NULL, KCACHE_OPTION_TAG(KALLOC_TAG_DISPATCH), &g_kdispatch_timer_cache));
+
+catch:
+    return err;
+}
+
 // Expects:
 // - 'self' points to sizeof(struct kdispatch) 0 bytes
 static errno_t _kdispatch_init(kdispatch_t _Nonnull self, const kdispatch_attr_t* _Nonnull attr)
@@ -56,7 +71,7 @@ errno_t kdispatch_create(const kdispatch_attr_t* _Nonnull attr, kdispatch_t _Nul
     decl_try_err();
     kdispatch_t self = NULL;
     
-    err = kalloc_cleared(sizeof(struct kdispatch), (void**)&self);
+    err = kalloc_options(sizeof(struct kdispatch), KALLOC_OPTION_CLEAR | KALLOC_OPTION_TAG(KALLOC_TAG_DISPATCH), (void**)&self);
     if (err == EOK) {
         err = _kdispatch_init(self, attr);
         if (err != EOK) {
@@ -78,13 +93,13 @@ errno_t kdispatch_destroy(kdispatch_t _Nullable self)
 
 
         queue_for_each(&self->timer_cache, queue_node_t, it,
-            kfree(it);
+            kcache_free(g_kdispatch_timer_cache, it);
         )
         self->timer_cache = QUEUE_INIT;
 
 
         queue_for_each(&self->item_cache, queue_node_t, it,
-            kfree(it);
+            kcache_free(g_kdispatch_item_cache, it);
         )
         self->item_cache = QUEUE_INIT;
 
@@ -356,7 +371,7 @@ kdispatch_item_t _Nullable _kdispatch_acquire_cached_conv_item(kdispatch_t _Nonn
         self->item_cache_count--;
     }
     else {
-        kalloc(sizeof(struct kdispatch_conv_item), (void**)&ip);
+        kcache_alloc(g_kdispatch_item_cache, (void**)&ip);
     }
 
     if (ip) {
@@ -380,7 +395,7 @@ void _kdispatch_cache_item(kdispatch_t _Nonnull _Locked self, kdispatch_item_t _
         self->item_cache_count++;
     }
     else {
-        kfree(item);
+        kcache_free(g_kdispatch_item_cache, item);
     }
 }
 
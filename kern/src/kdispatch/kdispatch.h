@@ -204,6 +204,10 @@ typedef struct kdispatch_attr {
 
 
 
+// Initializes the dispatcher package. Must be called before the first
+// dispatcher is created.
+extern errno_t kdispatch_init(void);
+
 // Creates a new dispatcher based on the provided dispatcher attributes.
 extern errno_t kdispatch_create(const kdispatch_attr_t* _Nonnull attr, kdispatch_t _Nullable * _Nonnull pOutSelf);
 
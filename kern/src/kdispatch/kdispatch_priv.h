@@ -14,6 +14,7 @@
 #include <limits.h>
 #include <ext/nanotime.h>
 #include <kern/kalloc.h>
+#include <kern/kcache.h>
 #include <kern/kernlib.h>
 #include <kern/sigset.h>
 #include <sched/cnd.h>
@@ -174,6 +175,10 @@ struct kdispatch {
 #define _dispatch_is_fixed_concurrency(__self) \
 ((__self)->attr.minConcurrency == (__self)->attr.maxConcurrency)
 
+// Object caches that back the per-dispatcher item and timer caches
+extern kcache_t _Nonnull    g_kdispatch_item_cache;
+extern kcache_t _Nonnull    g_kdispatch_timer_cache;
+
 extern void _kdispatch_retire_item(kdispatch_t _Nonnull _Locked self, kdispatch_item_t _Nonnull item);
 extern void _kdispatch_zombify_item(kdispatch_t _Nonnull _Locked self, kdispatch_item_t _Nonnull item);
 extern void _kdispatch_cache_item(kdispatch_t _Nonnull _Locked self, kdispatch_item_t _Nonnull item);
@@ -86,7 +86,7 @@ void _kdispatch_retire_timer(kdispatch_t _Nonnull _Locked self, kdispatch_timer_
         self->timer_cache_count++;
     }
     else {
-        kfree(timer);
+        kcache_free(g_kdispatch_timer_cache, timer);
     }
 
 
@@ -130,7 +130,7 @@ static errno_t _kdispatch_arm_timer(kdispatch_t _Nonnull _Locked self, int flags
         self->timer_cache_count--;
     }
     else {
-        err = kalloc(sizeof(struct kdispatch_timer), (void**)&timer);
+        err = kcache_alloc(g_kdispatch_timer_cache, (void**)&timer);
         if (err != EOK) {
             return err;
         }
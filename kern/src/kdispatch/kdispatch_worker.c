@@ -40,7 +40,7 @@ errno_t _kdispatch_worker_create(kdispatch_t _Nonnull owner, kdispatch_worker_t
     decl_try_err();
     kdispatch_worker_t self = NULL;
     
-    try(kalloc_cleared(sizeof(struct kdispatch_worker), (void**)&self));
+    try(kalloc_options(sizeof(struct kdispatch_worker), KALLOC_OPTION_CLEAR | KALLOC_OPTION_TAG(KALLOC_TAG_DISPATCH), (void**)&self));
 
     self->owner = owner;
     self->hotsigs = sig_bit(_SIG_DISPATCH);
@@ -15,9 +15,41 @@
 
 kei_func_t gKeiTable[KEI_Count];
 
+
+// The kernel's memcpy() and memmove() go through the KEI table so that the
+// kernel picks up the same CPU specific versions as user space. The table is
+// empty until kei_init() has run and the 68020 versions are used until then.
+// OnBoot() calls _memcpy_020() directly because the table lives in the BSS
+// segment which doesn't exist yet at that point.
+void* _Nonnull memcpy(void* _Nonnull _Restrict dst, const void* _Nonnull _Restrict src, size_t count)
+{
+    const kei_func_t f = gKeiTable[KEI_memcpy];
+
+    if (f) {
+        return ((void* (*)(void* _Restrict, const void* _Restrict, size_t))f)(dst, src, count);
+    }
+    else {
+        return _memcpy_020(dst, src, count);
+    }
+}
+
+void* _Nonnull memmove(void* _Nonnull _Restrict dst, const void* _Nonnull _Restrict src, size_t count)
+{
+    const kei_func_t f = gKeiTable[KEI_memmove];
+
+    if (f) {
+        return ((void* (*)(void*, const void*, size_t))f)(dst, src, count);
+    }
+    else {
+        return _memmove_020(dst, src, count);
+    }
+}
+
 void kei_init(void)
 {
-    const bool is060 = (cpu_68k_family(g_sys_desc->cpu_subtype) >= CPU_FAMILY_68060);
+    const int cpu_family = cpu_68k_family(g_sys_desc->cpu_subtype);
+    const bool is040 = (cpu_family >= CPU_FAMILY_68040);
+    const bool is060 = (cpu_family >= CPU_FAMILY_68060);
 
     gKeiTable[KEI_asr64] = (kei_func_t)_rshsint64;
     gKeiTable[KEI_lsr64] = (kei_func_t)_rshuint64;
@@ -38,7 +70,7 @@ void kei_init(void)
     gKeiTable[KEI_flt64touint64] = (kei_func_t)_flt64touint64;
     gKeiTable[KEI_flt64tosint64] = (kei_func_t)_flt64tosint64;
 
-    gKeiTable[KEI_memcpy] = (kei_func_t)memcpy;
-    gKeiTable[KEI_memmove] = (kei_func_t)memmove;
-    gKeiTable[KEI_memset] = (kei_func_t)memset;
+    gKeiTable[KEI_memcpy] = (kei_func_t)(is040 ? _memcpy_040 : _memcpy_020);
+    gKeiTable[KEI_memmove] = (kei_func_t)(is040 ? _memmove_040 : _memmove_020);
+    gKeiTable[KEI_memset] = (kei_func_t)_memset_020;
 }
@@ -6,20 +6,48 @@
 //  Copyright © 2023 Dietmar Planitzer. All rights reserved.
 //
 
-#define _LSTA_MEM_DESC_DEFINED 1
+#define _MEM_DESC_DEFINED 1
 #include <assert.h>
 #include <hal/sys_desc.h>
-#include <__lsta.h>
+#include <__tlsf.h>
 #include <string.h>
 #include <kern/kalloc.h>
+#include <kern/kcache.h>
 #include <kern/kernlib.h>
 #include <kern/log.h>
 #include <sched/mtx.h>
 
 
+#if KALLOC_SIZE_CLASS_COUNT != TLSF_SIZE_CLASS_COUNT
+#error "KALLOC_SIZE_CLASS_COUNT must match TLSF_SIZE_CLASS_COUNT"
+#endif
+
+
+// A CPU-only request that falls back to unified memory must leave at least
+// 1/2^UNIFIED_RESERVE_SHIFT of the unified memory free
+#define UNIFIED_RESERVE_SHIFT   2
+
+// Max length of a tag name including the terminating NUL
+#define TAG_NAME_SIZE   12
+
+
 static mtx_t    gLock;
-static lsta_t   gUnifiedMemory;       // CPU + Chipset access (memory range [0..<chipset_upper_dma_limit]) (Required)
-static lsta_t   gCpuOnlyMemory;       // CPU only access      (memory range [chipset_upper_dma_limit...]) (Optional - created on demand if no Fast memory exists in the machine and we later pick up a RAM expansion board)
+static tlsf_t   gUnifiedMemory;       // CPU + Chipset access (memory range [0..<chipset_upper_dma_limit]) (Required)
+static tlsf_t   gCpuOnlyMemory;       // CPU only access      (memory range [chipset_upper_dma_limit...]) (Optional - created on demand if no Fast memory exists in the machine and we later pick up a RAM expansion board)
+static size_t   gUnifiedReserve;      // Unified memory that CPU-only requests leave alone
+static uint32_t gFallbackAllocs;
+static kalloc_tag_stats_t   gTagStats[KALLOC_TAG_COUNT];
+
+// A tagged block records the name of its tag as its allocation site. The tag is
+// recovered from the address of the name.
+static const char gTagNames[KALLOC_TAG_COUNT][TAG_NAME_SIZE] = {
+    "untagged",
+    "disk cache",
+    "process",
+    "graphics",
+    "dispatch",
+    "filesystem"
+};
 
 
 static mem_desc_t adjusted_memory_descriptor(const mem_desc_t* pMemDesc, char* _Nonnull pInitialHeapBottom, char* _Nonnull pInitialHeapTop)
@@ -35,7 +63,7 @@ static mem_desc_t adjusted_memory_descriptor(const mem_desc_t* pMemDesc, char* _
 
 static void __kalloc_error(int err, const char* _Nonnull _Restrict funcName, void* _Nullable _Restrict ptr)
 {
-    if (err = MERR_DOUBLE_FREE) {
+    if (err == MERR_DOUBLE_FREE) {
         printf("** k%s: double free at: %p\n", funcName, ptr);
     }
     else {
@@ -45,11 +73,11 @@ static void __kalloc_error(int err, const char* _Nonnull _Restrict funcName, voi
     abort();
 }
 
-static errno_t create_allocator(mem_layout_t* _Nonnull pMemLayout, char* _Nonnull pInitialHeapBottom, char* _Nonnull pInitialHeapTop, int8_t memoryType, bool isOptional, lsta_t _Nullable * _Nonnull pOutAllocator)
+static errno_t create_allocator(mem_layout_t* _Nonnull pMemLayout, char* _Nonnull pInitialHeapBottom, char* _Nonnull pInitialHeapTop, int8_t memoryType, bool isOptional, tlsf_t _Nullable * _Nonnull pOutAllocator)
 {
     decl_try_err();
     int i = 0;
-    lsta_t pAllocator = NULL;
+    tlsf_t pAllocator = NULL;
     mem_desc_t adjusted_md;
 
     // Skip over memory regions that are below the kernel heap bottom
@@ -65,7 +93,7 @@ static errno_t create_allocator(mem_layout_t* _Nonnull pMemLayout, char* _Nonnul
     // First valid memory descriptor. Create the allocator based on that. We'll
     // get an ENOMEM error if this memory region isn't big enough
     adjusted_md = adjusted_memory_descriptor(&pMemLayout->desc[i], pInitialHeapBottom, pInitialHeapTop);
-    try_null(pAllocator, __lsta_create(&adjusted_md, NULL, __kalloc_error), ENOMEM);
+    try_null(pAllocator, __tlsf_create(&adjusted_md, NULL, NULL, __kalloc_error), ENOMEM);
 
 
     // Pick up all other memory regions that are at least partially below the
@@ -74,7 +102,7 @@ static errno_t create_allocator(mem_layout_t* _Nonnull pMemLayout, char* _Nonnul
     while (i < pMemLayout->desc_count && pMemLayout->desc[i].lower < pInitialHeapTop) {
         if (pMemLayout->desc[i].type == memoryType) {
             adjusted_md = adjusted_memory_descriptor(&pMemLayout->desc[i], pInitialHeapBottom, pInitialHeapTop);
-            try(__lsta_add_memregion(pAllocator, &adjusted_md));
+            try(__tlsf_add_memregion(pAllocator, &adjusted_md));
         }
         i++;
     }
@@ -95,30 +123,106 @@ errno_t kalloc_init(const sys_desc_t* _Nonnull pSysDesc, void* _Nonnull pInitial
     mtx_init(&gLock);
     try(create_allocator(&pSysDesc->motherboard_ram, pInitialHeapBottom, pInitialHeapTop, MEM_TYPE_UNIFIED_MEMORY, false, &gUnifiedMemory));
     try(create_allocator(&pSysDesc->motherboard_ram, pInitialHeapBottom, pInitialHeapTop, MEM_TYPE_MEMORY, true, &gCpuOnlyMemory));
+    gUnifiedReserve = __tlsf_getfreebytes(gUnifiedMemory) >> UNIFIED_RESERVE_SHIFT;
     return EOK;
 
 catch:
     return err;
 }
 
-// Allocates memory from the kernel heap. Returns NULL if the memory could not be
-// allocated. 'options' is a combination of the HEAP_ALLOC_OPTION_XXX flags.
-errno_t kalloc_options(size_t nbytes, unsigned int options, void* _Nullable * _Nonnull pOutPtr)
+// Returns the tag of a block with the allocation site 'site'
+static int _kalloc_sitetag(const char* _Nullable site)
 {
-    decl_try_err();
-    void* ptr = NULL;
+    const uintptr_t p = (uintptr_t)site;
+    const uintptr_t lower = (uintptr_t)&gTagNames[0][0];
+    const uintptr_t upper = (uintptr_t)&gTagNames[KALLOC_TAG_COUNT][0];
+
+    return (p >= lower && p < upper) ? (p - lower) / TAG_NAME_SIZE : KALLOC_TAG_NONE;
+}
+
+// Charges (isAlloc == true) or credits the block 'ptr' of the allocator
+// 'pAllocator' to its tag. Expects that the caller holds gLock.
+static void _kalloc_account(tlsf_t _Nonnull pAllocator, void* _Nonnull ptr, int tag, bool isAlloc)
+{
+    kalloc_tag_stats_t* ts = &gTagStats[tag];
+    size_t* pBytes = (pAllocator == gUnifiedMemory) ? &ts->unified_bytes : &ts->cpu_bytes;
+    size_t nbytes = 0;
+
+    __tlsf_getblocksize(pAllocator, ptr, &nbytes);
+    if (isAlloc) {
+        *pBytes += nbytes;
+        ts->block_count++;
+        ts->allocs++;
+        ts->peak_bytes = __max(ts->peak_bytes, ts->unified_bytes + ts->cpu_bytes);
+    }
+    else {
+        *pBytes -= nbytes;
+        ts->block_count--;
+    }
+}
+
+static void* _Nullable _kalloc(size_t nbytes, unsigned int options, const char* _Nullable site, bool canUseReserve)
+{
+    const int tag = KALLOC_OPTION_GETTAG(options);
+    const bool isTagged = (tag > KALLOC_TAG_NONE && tag < KALLOC_TAG_COUNT);
+    tlsf_t pAllocator;
+    void* ptr;
+
+    if (isTagged) {
+        site = gTagNames[tag];
+    }
 
     mtx_lock(&gLock);
     if ((options & KALLOC_OPTION_UNIFIED) != 0 || gCpuOnlyMemory == NULL) {
-        ptr = __lsta_alloc(gUnifiedMemory, nbytes);
+        pAllocator = gUnifiedMemory;
+        ptr = __tlsf_alloc_site(pAllocator, nbytes, site);
     } else {
-        ptr = __lsta_alloc(gCpuOnlyMemory, nbytes);
-        if (ptr == NULL) {
-            ptr = __lsta_alloc(gUnifiedMemory, nbytes);
+        pAllocator = gCpuOnlyMemory;
+        ptr = __tlsf_alloc_site(pAllocator, nbytes, site);
+
+        // Fall back to unified memory but leave enough of it for the chipset
+        // unless we're really out of memory
+        if (ptr == NULL && (canUseReserve || __tlsf_getfreebytes(gUnifiedMemory) >= gUnifiedReserve + nbytes)) {
+            pAllocator = gUnifiedMemory;
+            ptr = __tlsf_alloc_site(pAllocator, nbytes, site);
+            if (ptr) {
+                gFallbackAllocs++;
+            }
         }
     }
+
+    if (ptr && isTagged) {
+        _kalloc_account(pAllocator, ptr, tag, true);
+    }
     mtx_unlock(&gLock);
 
+    return ptr;
+}
+
+// Allocates memory from the kernel heap. Returns NULL if the memory could not be
+// allocated. 'options' is a combination of the HEAP_ALLOC_OPTION_XXX flags.
+errno_t kalloc_options_site(size_t nbytes, unsigned int options, const char* _Nullable site, void* _Nullable * _Nonnull pOutPtr)
+{
+    void* ptr = _kalloc(nbytes, options, site, false);
+
+    // Ask the object caches to give their empty slabs back and try again if we
+    // are out of memory. The second attempt may dip into the unified memory
+    // reserve
+    if (ptr == NULL) {
+        kcache_reclaim_all();
+        ptr = _kalloc(nbytes, options, site, true);
+    }
+
+    if (ptr == NULL) {
+        const int tag = KALLOC_OPTION_GETTAG(options);
+
+        if (tag > KALLOC_TAG_NONE && tag < KALLOC_TAG_COUNT) {
+            mtx_lock(&gLock);
+            gTagStats[tag].failures++;
+            mtx_unlock(&gLock);
+        }
+    }
+
     // Zero the memory if requested
     if (ptr && (options & KALLOC_OPTION_CLEAR) != 0) {
         memset(ptr, 0, nbytes);
@@ -131,14 +235,14 @@ errno_t kalloc_options(size_t nbytes, unsigned int options, void* _Nullable * _N
 // Frees kernel memory allocated with the kalloc() function.
 void kfree(void* _Nullable ptr)
 {
-    decl_try_err();
-
     mtx_lock(&gLock);
-    err = __lsta_dealloc(gUnifiedMemory, ptr);
+    tlsf_t pAllocator = (gCpuOnlyMemory && __tlsf_isvalidptr(gCpuOnlyMemory, ptr)) ? gCpuOnlyMemory : gUnifiedMemory;
+    const int tag = _kalloc_sitetag(__tlsf_getblocksite(pAllocator, ptr));
 
-    if (err == ENOTBLK && gCpuOnlyMemory) {
-        try_bang(__lsta_dealloc(gCpuOnlyMemory, ptr));
-    } else if (err != EOK) {
+    if (tag != KALLOC_TAG_NONE) {
+        _kalloc_account(pAllocator, ptr, tag, false);
+    }
+    if (__tlsf_dealloc(pAllocator, ptr) != EOK) {
         abort();
     }
     mtx_unlock(&gLock);
@@ -152,10 +256,10 @@ size_t ksize(void* _Nullable ptr)
     size_t nbytes = 0;
 
     mtx_lock(&gLock);
-    err = __lsta_getblocksize(gUnifiedMemory, ptr, &nbytes);
+    err = __tlsf_getblocksize(gUnifiedMemory, ptr, &nbytes);
 
     if (err == ENOTBLK && gCpuOnlyMemory) {
-        err = __lsta_getblocksize(gCpuOnlyMemory, ptr, &nbytes);
+        err = __tlsf_getblocksize(gCpuOnlyMemory, ptr, &nbytes);
     }
 
     mtx_unlock(&gLock);
@@ -163,22 +267,86 @@ size_t ksize(void* _Nullable ptr)
     return nbytes;
 }
 
+errno_t kalloc_getstats(unsigned int options, kalloc_stats_t* _Nonnull pOutStats)
+{
+    tlsf_t pAllocator = ((options & KALLOC_OPTION_UNIFIED) != 0) ? gUnifiedMemory : gCpuOnlyMemory;
+    tlsf_info_t info;
+
+    if (pAllocator == NULL) {
+        return ENODEV;
+    }
+
+    mtx_lock(&gLock);
+    __tlsf_getinfo(pAllocator, &info);
+    mtx_unlock(&gLock);
+
+    pOutStats->used_bytes = info.used_bytes;
+    pOutStats->peak_used_bytes = info.peak_used_bytes;
+    pOutStats->free_bytes = info.free_bytes;
+    pOutStats->largest_free_size = info.largest_free_size;
+    pOutStats->used_block_count = info.used_block_count;
+    pOutStats->free_block_count = info.free_block_count;
+    pOutStats->region_count = info.region_count;
+    pOutStats->allocs = info.allocs;
+    pOutStats->frees = info.frees;
+    pOutStats->fallback_allocs = gFallbackAllocs;
+    memcpy(pOutStats->allocs_per_class, info.allocs_per_class, sizeof(pOutStats->allocs_per_class));
+
+    return EOK;
+}
+
+errno_t kalloc_gettagstats(int tag, kalloc_tag_stats_t* _Nonnull pOutStats)
+{
+    if (tag < 0 || tag >= KALLOC_TAG_COUNT) {
+        return EINVAL;
+    }
+
+    mtx_lock(&gLock);
+    *pOutStats = gTagStats[tag];
+    mtx_unlock(&gLock);
+
+    return EOK;
+}
+
+const char* _Nonnull kalloc_tagname(int tag)
+{
+    return (tag >= 0 && tag < KALLOC_TAG_COUNT) ? gTagNames[tag] : gTagNames[KALLOC_TAG_NONE];
+}
+
+void kalloc_getlockstats(mtx_stats_t* _Nonnull pOutStats)
+{
+    mtx_getstats(&gLock, pOutStats);
+}
+
+void kalloc_visit(void (*func)(void* _Nullable ctx, void* _Nonnull ptr, size_t size, const char* _Nullable site), void* _Nullable ctx)
+{
+    mtx_lock(&gLock);
+    __tlsf_visit(gUnifiedMemory, func, ctx);
+    if (gCpuOnlyMemory) {
+        __tlsf_visit(gCpuOnlyMemory, func, ctx);
+    }
+    mtx_unlock(&gLock);
+}
+
 // Adds the given memory region as a CPU-only access memory region to the kalloc
 // heap.
 errno_t kalloc_add_memory_region(const mem_desc_t* _Nonnull pMemDesc)
 {
     decl_try_err();
-    lsta_t pAllocator;
+    tlsf_t pAllocator;
 
     mtx_lock(&gLock);
     if (pMemDesc->upper < g_sys_desc->chipset_upper_dma_limit) {
-        err = __lsta_add_memregion(gUnifiedMemory, pMemDesc);
+        err = __tlsf_add_memregion(gUnifiedMemory, pMemDesc);
+        if (err == EOK) {
+            gUnifiedReserve = __tlsf_getfreebytes(gUnifiedMemory) >> UNIFIED_RESERVE_SHIFT;
+        }
     }
     else if (gCpuOnlyMemory) {
-        err = __lsta_add_memregion(gCpuOnlyMemory, pMemDesc);
+        err = __tlsf_add_memregion(gCpuOnlyMemory, pMemDesc);
     }
     else {
-        gCpuOnlyMemory = __lsta_create(pMemDesc, NULL, __kalloc_error);
+        gCpuOnlyMemory = __tlsf_create(pMemDesc, NULL, NULL, __kalloc_error);
         if (gCpuOnlyMemory == NULL) {
             err = ENOMEM;
         }
@@ -0,0 +1,278 @@
+//
+//  kcache.c
+//  kernel
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#include <assert.h>
+#include <ext/math.h>
+#include <ext/queue.h>
+#include <kern/kalloc.h>
+#include <kern/kcache.h>
+#include <sched/mtx.h>
+
+
+// Every object is preceded by a slot header. The header points to the next free
+// object while the object is on the free list of its slab and it points to the
+// slab that owns the object while the object is allocated. This way the
+// constructed state of a free object is never touched by the cache.
+typedef union kslot {
+    union kslot* _Nullable  next;
+    struct kslab* _Nonnull  slab;
+} kslot_t;
+
+
+// A slab is a single kalloc() block. The slab header is followed by
+// 'objs_per_slab' object slots.
+typedef struct kslab {
+    deque_node_t            qe;         // Linkage in the partial, full or empty list of the cache
+    struct kcache* _Nonnull cache;
+    kslot_t* _Nullable      free;       // First free object slot
+    int16_t                 inuse;      // Number of allocated objects
+    int16_t                 reserved;
+} kslab_t;
+
+
+struct kcache {
+    deque_node_t            qe;         // Linkage in the list of all caches
+    mtx_t                   mtx;
+    deque_t                 partial;    // Slabs with allocated and free objects
+    deque_t                 full;       // Slabs without free objects
+    deque_t                 empty;      // Slabs without allocated objects
+    kcache_ctor_t _Nullable ctor;
+    const char* _Nonnull    name;
+    size_t                  slot_size;  // Gross size of an object slot
+    unsigned int            options;
+    kcache_stats_t          stats;      // Protected by 'mtx'
+};
+
+
+// All 0 by default by virtue of being in the BSS
+static mtx_t    g_caches_mtx;
+static deque_t  g_caches;
+
+
+errno_t kcache_create(const char* _Nonnull name, size_t objSize, kcache_ctor_t _Nullable ctor, unsigned int options, kcache_t _Nullable * _Nonnull pOutSelf)
+{
+    decl_try_err();
+    kcache_t self = NULL;
+    const size_t slotSize = sizeof(kslot_t) + __Ceil_PowerOf2(__max(objSize, 1), sizeof(void*));
+    int objsPerSlab = __max((KCACHE_SLAB_SIZE - sizeof(kslab_t)) / slotSize, KCACHE_MIN_SLAB_OBJS);
+
+    objsPerSlab = __min(objsPerSlab, INT16_MAX);
+    try(kalloc_cleared(sizeof(struct kcache), (void**)&self));
+
+    mtx_init(&self->mtx);
+    self->ctor = ctor;
+    self->name = name;
+    self->slot_size = slotSize;
+    self->options = options;
+    self->stats.obj_size = objSize;
+    self->stats.slab_size = sizeof(kslab_t) + slotSize * objsPerSlab;
+    self->stats.objs_per_slab = objsPerSlab;
+
+    mtx_lock(&g_caches_mtx);
+    deque_add_last(&g_caches, &self->qe);
+    mtx_unlock(&g_caches_mtx);
+
+catch:
+    *pOutSelf = self;
+    return err;
+}
+
+void kcache_destroy(kcache_t _Nullable self)
+{
+    if (self) {
+        assert(self->stats.objs_in_use == 0);
+
+        mtx_lock(&g_caches_mtx);
+        deque_remove(&g_caches, &self->qe);
+        mtx_unlock(&g_caches_mtx);
+
+        kcache_reclaim(self);
+        mtx_deinit(&self->mtx);
+        kfree(self);
+    }
+}
+
+// Allocates a new slab and puts all its objects on the slab's free list.
+static errno_t _kcache_create_slab(kcache_t _Nonnull self, kslab_t* _Nullable * _Nonnull pOutSlab)
+{
+    decl_try_err();
+    const unsigned int kopts = (((self->options & KCACHE_OPTION_UNIFIED) != 0) ? KALLOC_OPTION_UNIFIED : 0) | KALLOC_OPTION_TAG(KALLOC_OPTION_GETTAG(self->options));
+    const int nobjs = self->stats.objs_per_slab;
+    kslab_t* sp;
+
+    err = kalloc_options(self->stats.slab_size, kopts, (void**)&sp);
+    if (err == EOK) {
+        char* p = ((char*)sp) + sizeof(kslab_t) + (nobjs - 1) * self->slot_size;
+
+        sp->qe = DEQUE_NODE_INIT;
+        sp->cache = self;
+        sp->free = NULL;
+        sp->inuse = 0;
+        sp->reserved = 0;
+
+        // Build the free list in address order
+        for (int i = 0; i < nobjs; i++) {
+            kslot_t* op = (kslot_t*)p;
+
+            if (self->ctor) {
+                self->ctor(p + sizeof(kslot_t));
+            }
+            op->next = sp->free;
+            sp->free = op;
+            p -= self->slot_size;
+        }
+    }
+
+    *pOutSlab = sp;
+    return err;
+}
+
+errno_t kcache_alloc(kcache_t _Nonnull self, void* _Nullable * _Nonnull pOutPtr)
+{
+    decl_try_err();
+    kslab_t* sp;
+
+    mtx_lock(&self->mtx);
+    sp = (kslab_t*)self->partial.first;
+
+    if (sp == NULL) {
+        sp = (kslab_t*)deque_remove_first(&self->empty);
+
+        if (sp) {
+            self->stats.empty_slab_count--;
+        }
+        else {
+            // Don't hold the lock while we're calling into kalloc() since it may
+            // ask us to reclaim our empty slabs
+            mtx_unlock(&self->mtx);
+            err = _kcache_create_slab(self, &sp);
+            mtx_lock(&self->mtx);
+
+            if (err != EOK) {
+                self->stats.failures++;
+                mtx_unlock(&self->mtx);
+                *pOutPtr = NULL;
+                return err;
+            }
+
+            self->stats.slab_count++;
+            self->stats.slab_allocs++;
+        }
+
+        deque_add_first(&self->partial, &sp->qe);
+    }
+
+
+    kslot_t* op = sp->free;
+
+    sp->free = op->next;
+    op->slab = sp;
+    sp->inuse++;
+    if (sp->inuse == self->stats.objs_per_slab) {
+        deque_remove(&self->partial, &sp->qe);
+        deque_add_first(&self->full, &sp->qe);
+    }
+
+    self->stats.objs_in_use++;
+    self->stats.allocs++;
+    mtx_unlock(&self->mtx);
+
+    *pOutPtr = ((char*)op) + sizeof(kslot_t);
+    return EOK;
+}
+
+void kcache_free(kcache_t _Nonnull self, void* _Nullable ptr)
+{
+    if (ptr == NULL) {
+        return;
+    }
+
+    kslot_t* op = (kslot_t*)(((char*)ptr) - sizeof(kslot_t));
+    kslab_t* sp = op->slab;
+    kslab_t* dsp = NULL;
+
+    assert(sp->cache == self);
+
+    mtx_lock(&self->mtx);
+    if (sp->inuse == self->stats.objs_per_slab) {
+        deque_remove(&self->full, &sp->qe);
+        deque_add_first(&self->partial, &sp->qe);
+    }
+
+    op->next = sp->free;
+    sp->free = op;
+    sp->inuse--;
+
+    if (sp->inuse == 0) {
+        deque_remove(&self->partial, &sp->qe);
+
+        if (self->stats.empty_slab_count < KCACHE_MAX_EMPTY_SLABS) {
+            deque_add_first(&self->empty, &sp->qe);
+            self->stats.empty_slab_count++;
+        }
+        else {
+            self->stats.slab_count--;
+            self->stats.slab_frees++;
+            dsp = sp;
+        }
+    }
+
+    self->stats.objs_in_use--;
+    self->stats.frees++;
+    mtx_unlock(&self->mtx);
+
+    kfree(dsp);
+}
+
+size_t kcache_reclaim(kcache_t _Nonnull self)
+{
+    deque_t slabs;
+    int nslabs;
+
+    mtx_lock(&self->mtx);
+    slabs = self->empty;
+    nslabs = self->stats.empty_slab_count;
+    self->empty = DEQUE_INIT;
+    self->stats.empty_slab_count = 0;
+    self->stats.slab_count -= nslabs;
+    self->stats.slab_frees += nslabs;
+    mtx_unlock(&self->mtx);
+
+
+    deque_node_t* np;
+    while ((np = deque_remove_first(&slabs)) != NULL) {
+        kfree(np);
+    }
+
+    return nslabs * self->stats.slab_size;
+}
+
+size_t kcache_reclaim_all(void)
+{
+    size_t nbytes = 0;
+
+    mtx_lock(&g_caches_mtx);
+    deque_for_each(&g_caches, struct kcache, it,
+        nbytes += kcache_reclaim(it);
+    )
+    mtx_unlock(&g_caches_mtx);
+
+    return nbytes;
+}
+
+void kcache_getstats(kcache_t _Nonnull self, kcache_stats_t* _Nonnull pOutStats)
+{
+    mtx_lock(&self->mtx);
+    *pOutStats = self->stats;
+    mtx_unlock(&self->mtx);
+}
+
+const char* _Nonnull kcache_name(kcache_t _Nonnull self)
+{
+    return self->name;
+}
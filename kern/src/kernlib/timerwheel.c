@@ -0,0 +1,189 @@
+//
+//  timerwheel.c
+//  kernel
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#include <stdbool.h>
+#include <ext/bit.h>
+#include <kern/timerwheel.h>
+
+// Number of ticks that the wheel is able to represent
+#define TW_SPAN             ((ticks_t)1 << (TW_LEVEL_COUNT * TW_LEVEL_SHIFT))
+
+#define TW_SLOT_BIT(__idx)  (0x80000000u >> (__idx))
+
+// Rotates the populated bits of a level such that the slot 'idx' ends up in the
+// most significant bit
+#define TW_ROTATE(__bits, __idx) \
+(((__idx) == 0) ? (__bits) : ((__bits) << (__idx)) | ((__bits) >> (TW_SLOT_COUNT - (__idx))))
+
+
+void tw_init(timerwheel_t* _Nonnull self, ticks_t now)
+{
+    self->time = now;
+
+    for (int l = 0; l < TW_LEVEL_COUNT; l++) {
+        self->populated[l] = 0;
+
+        for (int s = 0; s < TW_SLOT_COUNT; s++) {
+            self->slot[l][s] = NULL;
+        }
+    }
+}
+
+void tw_insert(timerwheel_t* _Nonnull self, tw_timer_t* _Nonnull t)
+{
+    ticks_t d = t->deadline;
+    ticks_t delta;
+    int level = 0;
+
+    if (ticks_before(d, self->time)) {
+        d = self->time;
+    }
+    delta = d - self->time;
+    if (delta >= TW_SPAN) {
+        d = self->time + TW_SPAN - 1;
+        delta = TW_SPAN - 1;
+    }
+
+    while (delta >= ((ticks_t)1 << ((level + 1) * TW_LEVEL_SHIFT))) {
+        level++;
+    }
+
+    const int idx = (d >> (level * TW_LEVEL_SHIFT)) & TW_SLOT_MASK;
+    tw_timer_t* head = self->slot[level][idx];
+
+    t->prev = NULL;
+    t->next = head;
+    if (head) {
+        head->prev = t;
+    }
+    t->level = level;
+    t->slot = idx;
+
+    self->slot[level][idx] = t;
+    self->populated[level] |= TW_SLOT_BIT(idx);
+}
+
+void tw_remove(timerwheel_t* _Nonnull self, tw_timer_t* _Nonnull t)
+{
+    if (t->prev) {
+        t->prev->next = t->next;
+    }
+    else {
+        self->slot[t->level][t->slot] = t->next;
+        if (t->next == NULL) {
+            self->populated[t->level] &= ~TW_SLOT_BIT(t->slot);
+        }
+    }
+    if (t->next) {
+        t->next->prev = t->prev;
+    }
+
+    t->next = NULL;
+    t->prev = NULL;
+}
+
+// Re-files the timers in the slot of level 'level' that the wheel time has
+// reached. Cascades the next higher level first if the wheel time has reached
+// the start of one of its slots too.
+static void _tw_cascade(timerwheel_t* _Nonnull self, int level)
+{
+    const int idx = (self->time >> (level * TW_LEVEL_SHIFT)) & TW_SLOT_MASK;
+
+    if (idx == 0 && level < TW_LEVEL_COUNT - 1) {
+        _tw_cascade(self, level + 1);
+    }
+
+    tw_timer_t* t = self->slot[level][idx];
+
+    self->slot[level][idx] = NULL;
+    self->populated[level] &= ~TW_SLOT_BIT(idx);
+
+    while (t) {
+        tw_timer_t* nt = t->next;
+
+        tw_insert(self, t);
+        t = nt;
+    }
+}
+
+tw_timer_t* _Nullable tw_advance(timerwheel_t* _Nonnull self, ticks_t now)
+{
+    tw_timer_t* expired = NULL;
+
+    while (!ticks_before(now, self->time)) {
+        const int idx = self->time & TW_SLOT_MASK;
+
+        if (idx == 0) {
+            _tw_cascade(self, 1);
+        }
+
+        tw_timer_t* t = self->slot[0][idx];
+        if (t) {
+            tw_timer_t* lt = t;
+
+            while (lt->next) {
+                lt->prev = NULL;
+                lt = lt->next;
+            }
+            lt->prev = NULL;
+            lt->next = expired;
+            expired = t;
+
+            self->slot[0][idx] = NULL;
+            self->populated[0] &= ~TW_SLOT_BIT(idx);
+        }
+
+
+        // Skip ahead to the next populated slot in the current rotation of
+        // level 0 or the start of the next rotation, whichever comes first
+        const uint32_t later = (idx < TW_SLOT_MASK) ? self->populated[0] & (0xffffffffu >> (idx + 1)) : 0;
+        const ticks_t next = (self->time & ~(ticks_t)TW_SLOT_MASK) + leading_zeros_ui(later);
+
+        if (ticks_before(now, next)) {
+            self->time = now + 1;
+            break;
+        }
+        self->time = next;
+    }
+
+    return expired;
+}
+
+ticks_t tw_next_deadline(const timerwheel_t* _Nonnull self)
+{
+    ticks_t r = TICKS_MAX;
+    bool hasDeadline = false;
+
+    // Level 0 slots are due at the tick they represent
+    if (self->populated[0]) {
+        const int idx = self->time & TW_SLOT_MASK;
+
+        r = self->time + leading_zeros_ui(TW_ROTATE(self->populated[0], idx));
+        hasDeadline = true;
+    }
+
+
+    // Slots on higher levels are cascaded at the start of their time span. The
+    // first slot that may still be cascaded is the one that starts at or after
+    // the wheel time
+    for (int l = 1; l < TW_LEVEL_COUNT; l++) {
+        if (self->populated[l]) {
+            const int shift = l * TW_LEVEL_SHIFT;
+            const ticks_t blk = (self->time + ((ticks_t)1 << shift) - 1) >> shift;
+            const int idx = blk & TW_SLOT_MASK;
+            const ticks_t t = (blk + leading_zeros_ui(TW_ROTATE(self->populated[l], idx))) << shift;
+
+            if (!hasDeadline || ticks_before(t, r)) {
+                r = t;
+                hasDeadline = true;
+            }
+        }
+    }
+
+    return r;
+}
@@ -24,6 +24,11 @@ static void _proc_deinit(ProcessRef _Nonnull self)
     AddressSpace_Deinit(&self->addr_space);
     self->ctx_base = NULL;
 
+    for (int i = 0; i < self->stack_cache_count; i++) {
+        stk_destroy(&self->stack_cache[i]);
+    }
+    self->stack_cache_count = 0;
+
     self->pid = 0;
     self->ppid = 0;
 
@@ -181,6 +186,18 @@ static errno_t _proc_path(ProcessRef _Nonnull self, char* _Nonnull buf, size_t b
 }
 
 // 'bufSize' has to be >= 1
+// Returns the number of cycles that the process has spent running in user and
+// system space. This includes the currently acquired and all relinquished vcpus.
+// PROC_INFO_TIMES and the process snapshot both report these values.
+static void _proc_get_cpu_cycles(ProcessRef _Nonnull _Locked self, uint64_t* _Nonnull pOutUsrCycles, uint64_t* _Nonnull pOutSysCycles)
+{
+    const int sps = preempt_disable();
+    sched_charge_running_np(g_sched);
+    *pOutUsrCycles = self->usr_cycles;
+    *pOutSysCycles = self->sys_cycles;
+    preempt_restore(sps);
+}
+
 static errno_t _proc_name(ProcessRef _Nonnull self, char* _Nonnull buf, size_t bufSize)
 {
     const char* arg0 = (self->ctx_base) ? self->ctx_base->argv[0] : NULL;
@@ -269,6 +286,7 @@ errno_t Process_GetInfo(ProcessRef _Nonnull self, int flavor, proc_info_ref _Non
             ip->vcpu_count = self->vcpu_count;
             ip->vcpu_lifetime_count = self->vcpu_lifetime_count;
             ip->vcpu_waiting_count = self->vcpu_waiting_count;
+            ip->vcpu_stack_peak = self->vcpu_stack_peak;
             ip->vm_size = AddressSpace_GetVirtualSize(&self->addr_space);
             ip->cmdline_size = self->arg_size;
             ip->env_size = self->env_size;
@@ -277,19 +295,18 @@ errno_t Process_GetInfo(ProcessRef _Nonnull self, int flavor, proc_info_ref _Non
 
         case PROC_INFO_TIMES: {
             proc_times_info_t* ip = info;
-            ticks_t tt;
+            uint64_t usr_cycles, sys_cycles;
+
+            _proc_get_cpu_cycles(self, &usr_cycles, &sys_cycles);
 
             ip->creation_time = self->creation_time;
-            clock_ticks2time(g_mono_clock, self->usr_ticks, &ip->user_time);
-            clock_ticks2time(g_mono_clock, self->sys_ticks, &ip->system_time);
+            clock_cycles2time(g_mono_clock, usr_cycles, &ip->user_time);
+            clock_cycles2time(g_mono_clock, sys_cycles, &ip->system_time);
             clock_ticks2time(g_mono_clock, self->wait_ticks, &ip->wait_time);
 
-            tt = self->usr_ticks - self->rq_usr_ticks;
-            clock_ticks2time(g_mono_clock, tt, &ip->user_time);
-            tt = self->sys_ticks - self->rq_sys_ticks;
-            clock_ticks2time(g_mono_clock, tt, &ip->system_time);
-            tt = self->wait_ticks - self->rq_wait_ticks;
-            clock_ticks2time(g_mono_clock, tt, &ip->wait_time);
+            clock_cycles2time(g_mono_clock, usr_cycles - self->rq_usr_cycles, &ip->acq_user_time);
+            clock_cycles2time(g_mono_clock, sys_cycles - self->rq_sys_cycles, &ip->acq_system_time);
+            clock_ticks2time(g_mono_clock, self->wait_ticks - self->rq_wait_ticks, &ip->acq_wait_time);
             break;
         }
 
@@ -321,6 +338,35 @@ errno_t Process_GetInfo(ProcessRef _Nonnull self, int flavor, proc_info_ref _Non
     return err;
 }
 
+void Process_GetSnapshot(ProcessRef _Nonnull self, proc_snapshot_t* _Nonnull snap)
+{
+    mtx_lock(&self->mtx);
+
+    snap->pid = self->pid;
+    snap->ppid = self->ppid;
+    snap->pgrp = self->pgrp;
+    snap->sid = self->sid;
+    snap->uid = FileManager_GetRealUserId(&self->fm);
+
+    snap->run_state = self->run_state;
+
+    snap->vcpu_count = self->vcpu_count;
+    snap->vcpu_waiting_count = self->vcpu_waiting_count;
+
+    snap->vm_size = AddressSpace_GetVirtualSize(&self->addr_space);
+
+    snap->creation_time = self->creation_time;
+    uint64_t usr_cycles, sys_cycles;
+    _proc_get_cpu_cycles(self, &usr_cycles, &sys_cycles);
+    clock_cycles2time(g_mono_clock, usr_cycles, &snap->user_time);
+    clock_cycles2time(g_mono_clock, sys_cycles, &snap->system_time);
+
+    // Truncation is fine here
+    (void)_proc_name(self, snap->name, sizeof(snap->name));
+
+    mtx_unlock(&self->mtx);
+}
+
 // Suspend all vcpus in the process if the process is currently in running state.
 // Otherwise does nothing. Nesting is not supported.
 void _proc_stop(ProcessRef _Nonnull _Locked self, int reason, int arg, bool notify_parent)
@@ -14,6 +14,7 @@
 #include <kern/signal.h>
 #include <kobj/Any.h>
 #include <kpi/exception.h>
+#include <kpi/host.h>
 #include <kpi/process.h>
 #include <kpi/proc_wait.h>
 #include <kpi/proc_spawn.h>
@@ -109,6 +110,10 @@ extern errno_t Process_GetProperty(ProcessRef _Nonnull self, int flavor, char* _
 // Returns a copy of the receiver's information.
 extern errno_t Process_GetInfo(ProcessRef _Nonnull self, int flavor, proc_info_ref _Nonnull info);
 
+// Fills in the process snapshot entry 'snap' with the current state of the
+// receiver.
+extern void Process_GetSnapshot(ProcessRef _Nonnull self, proc_snapshot_t* _Nonnull snap);
+
 // Returns an array of vcpuid_t's corresponding to the currently acquired vcpus.
 extern errno_t Process_GetVirtualProcessorIds(ProcessRef _Nonnull self, vcpuid_t* _Nonnull buf, size_t bufSize, int* _Nonnull out_hasMore);
 
@@ -356,6 +356,28 @@ errno_t ProcessManager_GetProcessIds(ProcessManagerRef _Nonnull self, pid_t* _No
     return err;
 }
 
+errno_t ProcessManager_GetSnapshot(ProcessManagerRef _Nonnull self, proc_snapshot_t* _Nonnull buf, size_t bufSize, size_t* _Nonnull pOutCount, int* _Nonnull out_hasMore)
+{
+    size_t idx = 0;
+
+    mtx_lock(&self->mtx);
+    for (size_t i = 0; i < HASH_CHAIN_COUNT && idx < bufSize; i++) {
+        queue_for_each(&self->pid_table[i], queue_node_t, it,
+            if (idx == bufSize) {
+                break;
+            }
+
+            Process_GetSnapshot(proc_from_pid_qe(it), &buf[idx++]);
+        )
+    }
+
+    *pOutCount = idx;
+    *out_hasMore = (self->proc_count > idx) ? 1 : 0;
+    mtx_unlock(&self->mtx);
+
+    return EOK;
+}
+
 static errno_t _send_signal_to_proc(ProcessManagerRef _Nonnull _Locked self, const sig_dispatch_t* _Nonnull dp)
 {
     ProcessRef target_p = _get_proc_by_pid(self, dp->rcvr.id);
@@ -41,6 +41,12 @@ extern size_t ProcessManager_GetProcessCount(ProcessManagerRef _Nonnull self);
 
 extern errno_t ProcessManager_GetProcessIds(ProcessManagerRef _Nonnull self, pid_t* _Nonnull buf, size_t bufSize, int* _Nonnull out_hasMore);
 
+// Fills 'buf' with a snapshot of all processes. 'bufSize' is the number of
+// entries that 'buf' can hold. The number of entries filled in is returned in
+// 'pOutCount'. 'out_hasMore' is set to 1 if there are more processes than fit
+// in 'buf'. The process table is locked for the whole duration of the snapshot.
+extern errno_t ProcessManager_GetSnapshot(ProcessManagerRef _Nonnull self, proc_snapshot_t* _Nonnull buf, size_t bufSize, size_t* _Nonnull pOutCount, int* _Nonnull out_hasMore);
+
 extern errno_t ProcessManager_GetStatusForProcessMatchingState(ProcessManagerRef _Nonnull self, int mstate, pid_t ppid, int match, pid_t id, proc_waitres_t* _Nonnull res);
 
 
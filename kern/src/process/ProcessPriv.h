@@ -22,6 +22,13 @@
 // Default stack size for user space vcpus
 #define PROC_DEFAULT_USER_STACK_SIZE    CPU_PAGE_SIZE
 
+// Smallest user stack that a vcpu can ask for
+#define PROC_MIN_USER_STACK_SIZE        1024
+
+// Number of user stacks of relinquished vcpus that a process keeps around for
+// reuse by vcpus that it acquires later
+#define PROC_MAX_CACHED_STACKS          4
+
 
 // Signal routes
 struct sigroute {
@@ -95,6 +102,10 @@ typedef struct Process {
     size_t                          vcpu_lifetime_count;
     size_t                          vcpu_waiting_count;
     vcpuid_t                        next_avail_vcpuid;
+    size_t                          vcpu_stack_peak;    // Largest user stack high-water mark of a relinquished vcpu [mtx]
+    size_t                          user_stack_size;    // User stack size requested by the spawn attributes; 0 -> use the size from the executable
+    int                             stack_cache_count;  // [mtx]
+    stk_t                           stack_cache[PROC_MAX_CACHED_STACKS];   // User stacks of relinquished vcpus [mtx]
 
     // Scheduling parameters
     int8_t                          quantum_boost;
@@ -109,11 +120,11 @@ typedef struct Process {
 
     // Times stats
     nanotime_t                      creation_time;
-    ticks_t                         usr_ticks;         // number of clock ticks this process has spent running in user space across all vcpus (former + current)
-    ticks_t                         sys_ticks;       // number of clock ticks this process has spent running in system space across all vcpus (former + current)
+    uint64_t                        usr_cycles;         // number of clock cycles this process has spent running in user space across all vcpus (former + current)
+    uint64_t                        sys_cycles;         // number of clock cycles this process has spent running in system space across all vcpus (former + current)
     ticks_t                         wait_ticks;         // number of clock ticks this process has spent waiting or suspended across all vcpus (former + current)
-    ticks_t                         rq_usr_ticks;      // number of clock ticks this process has spent running in user space across all relinquished vcpus
-    ticks_t                         rq_sys_ticks;    // number of clock ticks this process has spent running in system space across all relinquished vcpus
+    uint64_t                        rq_usr_cycles;      // number of clock cycles this process has spent running in user space across all relinquished vcpus
+    uint64_t                        rq_sys_cycles;      // number of clock cycles this process has spent running in system space across all relinquished vcpus
     ticks_t                         rq_wait_ticks;      // number of clock ticks this process has spent waiting or suspended across all relinquished vcpus
 
     // All VPs that belong to this process and are currently in a clock_sleep()
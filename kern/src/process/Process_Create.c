@@ -9,6 +9,7 @@
 #include "ProcessPriv.h"
 #include "ProcessManager.h"
 #include <assert.h>
+#include <ext/math.h>
 #include <filemanager/FileHierarchy.h>
 #include <kern/kalloc.h>
 
@@ -56,6 +57,9 @@ void Process_Init(ProcessRef _Nonnull self, ProcessRef _Locked _Nullable parent,
 
     self->vcpu_queue = DEQUE_INIT;
     self->next_avail_vcpuid = VCPUID_MAIN;
+    for (int i = 0; i < PROC_MAX_CACHED_STACKS; i++) {
+        stk_init(&self->stack_cache[i]);
+    }
     
     HandlerTable_Init(&self->HandlerTable);
 
@@ -99,7 +103,7 @@ errno_t Process_CreateUserChild(ProcessRef _Nonnull self, const proc_spawnattr_t
     rootDir = (ovrFh) ? FileHierarchy_AcquireRootDirectory(ovrFh) : Inode_Reacquire(self->fm.rootDirectory);
     workDir = (ovrFh) ? FileHierarchy_AcquireRootDirectory(ovrFh) : Inode_Reacquire(self->fm.workingDirectory);
 
-    try(kalloc_cleared(sizeof(Process), (void**)&cp));
+    try(kalloc_options(sizeof(Process), KALLOC_OPTION_CLEAR | KALLOC_OPTION_TAG(KALLOC_TAG_PROCESS), (void**)&cp));
     Process_Init(cp, self, true, fh, rootDir, workDir);
 
 
@@ -139,6 +143,9 @@ errno_t Process_CreateUserChild(ProcessRef _Nonnull self, const proc_spawnattr_t
     if (attr->nice > 0) {
         cp->sched_nice = VCPU_CLAMPED_NICE_PRIORITY(attr->nice);
     }
+    if (attr->stack_size > 0) {
+        cp->user_stack_size = __max(attr->stack_size, PROC_MIN_USER_STACK_SIZE);
+    }
 
 
 catch:
@@ -48,6 +48,11 @@ errno_t Process_Exec(ProcessRef _Nonnull self, const char* _Nonnull execPath, co
     try(proc_img_load(pimg));
 
 
+    // The stack size from the spawn attributes overrides the one that the
+    // executable asks for
+    const size_t stackSize = (self->user_stack_size > 0) ? self->user_stack_size : pimg->stack_size;
+
+
     if (self->ctx_base == NULL) {
         // No executable image exists at this point and thus this is the first
         // time we're doing a proc_exec() in this process. Acquire a new main
@@ -56,7 +61,7 @@ errno_t Process_Exec(ProcessRef _Nonnull self, const char* _Nonnull execPath, co
         vcpu_attr_t attr;
 
         attr.version = sizeof(vcpu_attr_t);
-        attr.stack_size = PROC_DEFAULT_USER_STACK_SIZE;
+        attr.stack_size = (stackSize > 0) ? stackSize : PROC_DEFAULT_USER_STACK_SIZE;
         attr.group_id = VCPUID_MAIN_GROUP;
         attr.policy.version = sizeof(vcpu_policy_t);
         attr.policy.qos.grade = VCPU_QOS_INTERACTIVE;
@@ -84,6 +89,17 @@ errno_t Process_Exec(ProcessRef _Nonnull self, const char* _Nonnull execPath, co
         HandlerTable_CloseHandlersOnExec(&self->HandlerTable);
 
 
+        // Grow our user stack if the new executable asks for a bigger stack.
+        // We keep the existing stack if that doesn't work out
+        if (stackSize > me_vp->user_stack.size) {
+            stk_setmaxsize(&me_vp->user_stack, stackSize);
+            stk_fill(&me_vp->user_stack, me_vp->user_stack.size);
+        }
+        else {
+            stk_fill(&me_vp->user_stack, stk_gethighwater(&me_vp->user_stack));
+        }
+
+
         // Reset our user stack so that we'll start executing the new process
         // image once we return to user space
         vcpu_reset_user_stack(me_vp, (vcpu_func_t)pimg->entry_point, pimg->ctx_base, (VoidFunc_0)uproc_relinquish_vcpu_self);
@@ -12,6 +12,8 @@
 #include <ext/math.h>
 #include <kern/kalloc.h>
 #include <kpi/syscall.h>
+#include <hal/sched.h>
+#include <sched/pi.h>
 #include <sched/vcpu_pool.h>
 
 
@@ -27,6 +29,41 @@ static _Noreturn void kproc_relinquish_vcpu_self(void)
     /* NOT REACHED */
 }
 
+// Gives the vcpu 'vp' a user stack of at least 'size' bytes. Reuses the smallest
+// cached stack that is big enough and allocates a new stack otherwise. A newly
+// allocated stack is filled with the stack pattern so that its high-water mark
+// can be determined when the vcpu is relinquished.
+static errno_t _proc_setup_user_stack(ProcessRef _Nonnull _Locked self, vcpu_t _Nonnull vp, size_t size)
+{
+    decl_try_err();
+    int best = -1;
+
+    size = __Ceil_PowerOf2(size, STACK_ALIGNMENT);
+
+    for (int i = 0; i < self->stack_cache_count; i++) {
+        const size_t csize = self->stack_cache[i].size;
+
+        if (csize >= size && (best < 0 || csize < self->stack_cache[best].size)) {
+            best = i;
+        }
+    }
+
+    if (best >= 0) {
+        stk_destroy(&vp->user_stack);
+        vp->user_stack = self->stack_cache[best];
+        self->stack_cache[best] = self->stack_cache[--self->stack_cache_count];
+        stk_init(&self->stack_cache[self->stack_cache_count]);
+    }
+    else if (vp->user_stack.size != size) {
+        err = stk_setmaxsize(&vp->user_stack, size);
+        if (err == EOK) {
+            stk_fill(&vp->user_stack, size);
+        }
+    }
+
+    return err;
+}
+
 errno_t _proc_acquire_vcpu(ProcessRef _Nonnull _Locked self, vcpu_func_t _Nonnull func, void* _Nullable arg, const vcpu_attr_t* _Nonnull attr, intptr_t udata, vcpu_t _Nullable * _Nonnull pOutVp)
 {
     decl_try_err();
@@ -72,9 +109,9 @@ errno_t _proc_acquire_vcpu(ProcessRef _Nonnull _Locked self, vcpu_func_t _Nonnul
 
     // Setup user stack if this is a user process
     if (is_user) {
-        const size_t userStackSize = __max(attr->stack_size, PROC_DEFAULT_USER_STACK_SIZE);
+        const size_t userStackSize = (attr->stack_size > 0) ? __max(attr->stack_size, PROC_MIN_USER_STACK_SIZE) : PROC_DEFAULT_USER_STACK_SIZE;
 
-        try(stk_setmaxsize(&vp->user_stack, userStackSize));
+        try(_proc_setup_user_stack(self, vp, userStackSize));
     }
 
 
@@ -128,21 +165,53 @@ errno_t Process_AcquireVirtualProcessor(ProcessRef _Nonnull self, vcpu_func_t _N
 _Noreturn void Process_RelinquishCurrentVirtualProcessor(ProcessRef _Nonnull self)
 {
     vcpu_t vp = vcpu_current();
+    size_t stackUsed = 0;
 
     assert(vp->proc == self);
 
+
+    // Measure how much of the user stack the vcpu has used and restore the
+    // stack pattern in the used part so that the stack can be reused
+    if (vp->user_stack.size > 0) {
+        stackUsed = stk_gethighwater(&vp->user_stack);
+        stk_fill(&vp->user_stack, stackUsed);
+    }
+
+
     mtx_lock(&self->mtx);
     deque_remove(&self->vcpu_queue, &vp->owner_qe);
 
-    self->rq_usr_ticks += vp->usr_ticks;
-    self->rq_sys_ticks += vp->sys_ticks;
+    int sps = preempt_disable();
+    sched_charge_running_np(g_sched);
+    self->rq_usr_cycles += vp->usr_cycles;
+    self->rq_sys_cycles += vp->sys_cycles;
+    preempt_restore(sps);
     self->rq_wait_ticks += vp->wait_ticks;
     self->vcpu_count--;
 
+    if (stackUsed > self->vcpu_stack_peak) {
+        self->vcpu_stack_peak = stackUsed;
+    }
+
+    // Hand the user stack to the process for reuse by the next vcpu that it
+    // acquires. There's no point in doing this if the process is terminating
+    if (vp->user_stack.size > 0 && !_proc_is_terminating(self) && self->stack_cache_count < PROC_MAX_CACHED_STACKS) {
+        self->stack_cache[self->stack_cache_count++] = vp->user_stack;
+        stk_init(&vp->user_stack);
+    }
+
     mtx_unlock(&self->mtx);
 
 
-    // Free the user stack if we got one
+    // Detach the user space locks that we may still be registered as the owner
+    // of. A vcpu is only made the owner of a lock while the process lock is
+    // held and it is on the vcpu queue. So no new lock can show up after this.
+    sps = preempt_disable();
+    pi_disown_all_np(vp);
+    preempt_restore(sps);
+
+
+    // Free the user stack if we got one and the process didn't take it
     if (vp->user_stack.size > 0) {
         stk_setmaxsize(&vp->user_stack, 0);
     }
@@ -0,0 +1,197 @@
+//
+//  img_cache.c
+//  kernel
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#include "img_cache.h"
+#include <ext/math.h>
+#include <ext/nanotime.h>
+#include <kern/kalloc.h>
+#include <sched/mtx.h>
+
+
+static mtx_t    g_mtx;
+static deque_t  g_lru;          // Most recently used entry first
+static size_t   g_size;         // Number of bytes currently held by cached entries
+static size_t   g_capacity;
+
+
+void img_cache_init(size_t capacity)
+{
+    mtx_init(&g_mtx);
+    g_lru = DEQUE_INIT;
+    g_size = 0;
+    g_capacity = capacity;
+}
+
+static void _img_entry_destroy(img_entry_t* _Nonnull self)
+{
+    kfree(self);
+}
+
+// Removes the entry 'self' from the cache. Frees it right away if it isn't in
+// use. Otherwise the last img_cache_relinquish() will free it. Returns the
+// number of bytes that were freed right away.
+static size_t _img_cache_evict(img_entry_t* _Nonnull self)
+{
+    const size_t total_size = self->total_size;
+
+    deque_remove(&g_lru, &self->lru_qe);
+    g_size -= total_size;
+    self->is_cached = false;
+
+    if (self->use_count == 0) {
+        _img_entry_destroy(self);
+        return total_size;
+    }
+    return 0;
+}
+
+// Evicts entries starting at the LRU end of the cache until at least 'nbytes'
+// bytes have been freed or the cache is empty. Entries that are in use are
+// skipped if 'unusedOnly' is true because evicting them doesn't free memory.
+// Returns the number of bytes freed.
+static size_t _img_cache_evict_lru(size_t nbytes, bool unusedOnly)
+{
+    size_t nfreed = 0;
+
+    deque_for_each_reversed(&g_lru, deque_node_t, it,
+        if (nfreed >= nbytes) {
+            break;
+        }
+
+        img_entry_t* ep = deque_node_as(it, lru_qe, img_entry);
+
+        if (!unusedOnly || ep->use_count == 0) {
+            nfreed += _img_cache_evict(ep);
+        }
+    );
+
+    return nfreed;
+}
+
+img_entry_t* _Nullable img_cache_acquire(const fs_attr_t* _Nonnull attr)
+{
+    img_entry_t* ce = NULL;
+
+    mtx_lock(&g_mtx);
+    deque_for_each(&g_lru, deque_node_t, it,
+        img_entry_t* ep = deque_node_as(it, lru_qe, img_entry);
+
+        if (ep->ino == attr->ino && ep->fsid == attr->fsid) {
+            if (nanotime_eq(&ep->mod_time, &attr->mod_time) && ep->file_size == attr->size) {
+                ep->use_count++;
+                deque_remove(&g_lru, &ep->lru_qe);
+                deque_add_first(&g_lru, &ep->lru_qe);
+                ce = ep;
+            }
+            else {
+                // The file has changed since we cached it
+                _img_cache_evict(ep);
+            }
+            break;
+        }
+    );
+    mtx_unlock(&g_mtx);
+
+    return ce;
+}
+
+void img_cache_relinquish(img_entry_t* _Nullable self)
+{
+    if (self) {
+        bool doFree = false;
+
+        mtx_lock(&g_mtx);
+        self->use_count--;
+        doFree = (self->use_count == 0 && !self->is_cached);
+        mtx_unlock(&g_mtx);
+
+        if (doFree) {
+            _img_entry_destroy(self);
+        }
+    }
+}
+
+errno_t img_entry_create(const fs_attr_t* _Nonnull attr, size_t img_size, size_t bss_size, const ldr_reloc_t* _Nonnull rel, img_entry_t* _Nullable * _Nonnull pOutSelf)
+{
+    decl_try_err();
+    img_entry_t* self = NULL;
+
+    // Keep the image 4 byte aligned
+    const size_t delta_size = __Ceil_PowerOf2(rel->delta_count * sizeof(uint16_t), 4);
+    const size_t total_size = sizeof(img_entry_t) + delta_size + img_size;
+
+    err = kalloc_tagged(total_size, KALLOC_TAG_PROCESS, (void**)&self);
+    if (err == EOK) {
+        self->lru_qe = DEQUE_NODE_INIT;
+        self->use_count = 1;
+        self->is_cached = false;
+        self->fsid = attr->fsid;
+        self->ino = attr->ino;
+        self->mod_time = attr->mod_time;
+        self->file_size = attr->size;
+        self->total_size = total_size;
+        self->img_size = img_size;
+        self->bss_size = bss_size;
+        self->reloc = *rel;
+        self->reloc.delta = (uint16_t*)((uint8_t*)self + sizeof(img_entry_t));
+        self->img = (uint8_t*)self + sizeof(img_entry_t) + delta_size;
+    }
+
+    *pOutSelf = self;
+    return err;
+}
+
+void img_cache_insert(img_entry_t* _Nonnull self)
+{
+    mtx_lock(&g_mtx);
+    if (!self->is_cached && self->total_size <= g_capacity) {
+        bool hasDup = false;
+
+        deque_for_each(&g_lru, deque_node_t, it,
+            img_entry_t* ep = deque_node_as(it, lru_qe, img_entry);
+
+            if (ep->ino == self->ino && ep->fsid == self->fsid) {
+                if (nanotime_eq(&ep->mod_time, &self->mod_time) && ep->file_size == self->file_size) {
+                    // Someone else loaded the same executable concurrently
+                    hasDup = true;
+                }
+                else {
+                    _img_cache_evict(ep);
+                }
+                break;
+            }
+        );
+
+        if (!hasDup) {
+            if (g_size + self->total_size > g_capacity) {
+                // Make room in the cache. The memory of an evicted entry that
+                // is still in use is freed by its last img_cache_relinquish()
+                deque_for_each_reversed(&g_lru, deque_node_t, it,
+                    if (g_size + self->total_size <= g_capacity) {
+                        break;
+                    }
+                    _img_cache_evict(deque_node_as(it, lru_qe, img_entry));
+                );
+            }
+
+            deque_add_first(&g_lru, &self->lru_qe);
+            g_size += self->total_size;
+            self->is_cached = true;
+        }
+    }
+    mtx_unlock(&g_mtx);
+}
+
+size_t img_cache_trim(size_t nbytes)
+{
+    mtx_lock(&g_mtx);
+    const size_t nfreed = _img_cache_evict_lru(nbytes, true);
+    mtx_unlock(&g_mtx);
+
+    return nfreed;
+}
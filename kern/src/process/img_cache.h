@@ -0,0 +1,69 @@
+//
+//  img_cache.h
+//  kernel
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#ifndef _IMG_CACHE_H
+#define _IMG_CACHE_H
+
+#include <stdbool.h>
+#include <ext/try.h>
+#include <ext/queue.h>
+#include <kpi/attr.h>
+#include "ldr_reloc.h"
+
+
+// A cached, pre-parsed executable image. Stores the unrelocated executable
+// header, text and data segments plus the decoded relocation list. An entry is
+// identified by the filesystem, inode and modification time of the executable
+// file it was loaded from. Entries are immutable once they have been inserted
+// into the cache.
+typedef struct img_entry {
+    deque_node_t        lru_qe;
+    int                 use_count;
+    bool                is_cached;      // false once the entry has been evicted from the cache
+    fsid_t              fsid;
+    ino_t               ino;
+    nanotime_t          mod_time;
+    off_t               file_size;
+    size_t              total_size;     // size of the entry including image and relocation list
+    size_t              img_size;       // executable header + text + data
+    size_t              bss_size;
+    ldr_reloc_t         reloc;
+    uint8_t* _Nonnull   img;
+} img_entry_t;
+
+
+// Initializes the executable image cache. 'capacity' is the maximum number of
+// bytes that the cache is allowed to hold on to.
+extern void img_cache_init(size_t capacity);
+
+// Looks up the cache entry for the executable file with the attributes 'attr'.
+// Returns the entry with an extra use count or NULL if no such entry exists.
+// An entry for an older version of the file is evicted.
+extern img_entry_t* _Nullable img_cache_acquire(const fs_attr_t* _Nonnull attr);
+
+// Relinquishes a use count obtained from img_cache_acquire() or
+// img_entry_create(). Frees the entry if it is no longer in use and no longer
+// cached.
+extern void img_cache_relinquish(img_entry_t* _Nullable self);
+
+// Creates a new (uncached) entry with one use count and room for an image of
+// 'img_size' bytes and 'rel->delta_count' relocation deltas. The caller fills
+// in the image bytes and the relocation list and then calls img_cache_insert().
+extern errno_t img_entry_create(const fs_attr_t* _Nonnull attr, size_t img_size, size_t bss_size, const ldr_reloc_t* _Nonnull rel, img_entry_t* _Nullable * _Nonnull pOutSelf);
+
+// Inserts the entry 'self' into the cache. Evicts the least recently used
+// entries if necessary to make room. The entry is not inserted if it is
+// bigger than the cache or an equivalent entry already exists.
+extern void img_cache_insert(img_entry_t* _Nonnull self);
+
+// Evicts least recently used entries that are not in use until at least
+// 'nbytes' bytes have been freed up or no such entry is left. Returns the number
+// of bytes freed. Call this when memory is running low.
+extern size_t img_cache_trim(size_t nbytes);
+
+#endif /* _IMG_CACHE_H */
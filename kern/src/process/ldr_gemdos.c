@@ -7,6 +7,7 @@
 //
 
 #include "ldr_gemdos.h"
+#include "img_cache.h"
 #include <string.h>
 #include <ext/math.h>
 #include <handler/Handler.h>
@@ -48,11 +49,117 @@ static void _gemdos_reloc(proc_img_t* _Nonnull self, uint8_t* _Nonnull reloc_bas
     }
 }
 
+// Decodes the GemDOS relocation byte stream 'stream' of size 'stream_size' into
+// the relocation list 'rel'. All sites are validated against the image size
+// 'img_size'. Returns ENOEXEC if the stream is malformed.
+static errno_t _gemdos_decode_relocs(const uint8_t* _Nonnull stream, size_t stream_size, size_t img_size, ldr_reloc_t* _Nonnull rel)
+{
+    if (stream_size < sizeof(uint32_t)) {
+        return ENOEXEC;
+    }
+
+    const uint8_t* p = stream + sizeof(uint32_t);
+    const uint8_t* pEnd = stream + stream_size;
+    size_t site = *((const uint32_t*)stream);
+    bool done = (site == 0);
+
+    while (!done) {
+        if (img_size < sizeof(uint32_t) || site > img_size - sizeof(uint32_t)) {
+            return ENOEXEC;
+        }
+        ldr_reloc_add(rel, site);
+
+
+        // Find the next site
+        for (;;) {
+            if (p == pEnd) {
+                return ENOEXEC;
+            }
+
+            const uint8_t b = *p++;
+
+            if (b == 0) {
+                done = true;
+                break;
+            }
+            else if (b == 1) {
+                site += 254;
+            }
+            else {
+                site += b;
+                break;
+            }
+        }
+    }
+
+    return EOK;
+}
+
+// Loads the executable from the cached image 'ce'. No file I/O is needed.
+static errno_t _gemdos_load_cached(proc_img_t* _Nonnull self, const img_entry_t* _Nonnull ce)
+{
+    decl_try_err();
+    const size_t nbytes_to_alloc = __Ceil_PowerOf2(ce->img_size + ce->bss_size, CPU_PAGE_SIZE);
+    uint8_t* img_base = NULL;
+
+    try(proc_img_alloc(self, nbytes_to_alloc, (void**)&img_base));
+
+
+    // Copy the executable header, text and data segments and relocate them
+    uint8_t* txt_base = img_base + sizeof(gemdos_hdr_t);
+    memcpy(img_base, ce->img, ce->img_size);
+    ldr_reloc_apply(&ce->reloc, txt_base, (uint32_t)txt_base);
+
+
+    // Initialize the BSS segment
+    memset(img_base + ce->img_size, 0, ce->bss_size);
+
+
+    // Return the result pointers
+    self->base = img_base; 
+    self->entry_point = txt_base;
+
+catch:
+    return err;
+}
+
+// Creates a cache entry for the unrelocated image at 'img_base' and inserts it
+// into the image cache. Returns the entry (with a use count) and NULL if the
+// image can not be cached.
+static img_entry_t* _Nullable _gemdos_cache_image(proc_img_t* _Nonnull self, const gemdos_hdr_t* _Nonnull hdr, const uint8_t* _Nonnull img_base, const uint8_t* _Nonnull reloc_base, size_t reloc_size)
+{
+    const size_t img_size = sizeof(gemdos_hdr_t) + hdr->text_size + hdr->data_size;
+    const size_t seg_size = img_size - sizeof(gemdos_hdr_t);
+    ldr_reloc_t rel;
+    img_entry_t* ce = NULL;
+
+    // Count the relocation deltas
+    ldr_reloc_init(&rel, NULL);
+    if (_gemdos_decode_relocs(reloc_base, reloc_size, seg_size, &rel) != EOK) {
+        return NULL;
+    }
+
+    if (img_entry_create(&self->file_attr, img_size, hdr->bss_size, &rel, &ce) != EOK) {
+        return NULL;
+    }
+
+
+    // Fill in the relocation list and the image
+    ldr_reloc_init(&ce->reloc, ce->reloc.delta);
+    _gemdos_decode_relocs(reloc_base, reloc_size, seg_size, &ce->reloc);
+    memcpy(ce->img, img_base, img_size);
+
+    img_cache_insert(ce);
+
+    return ce;
+}
+
 errno_t ldr_gemdos_load(proc_img_t* _Nonnull self)
 {
     decl_try_err();
     HandlerRef fp = self->file;
     const gemdos_hdr_t* hdr = (const gemdos_hdr_t*)self->prefix_buf;
+    img_entry_t* ce = NULL;
     off_t fileOffset;
     ssize_t nBytesRead;
 
@@ -86,13 +193,22 @@ errno_t ldr_gemdos_load(proc_img_t* _Nonnull self)
     }
 
 
+    // Use the cached image if we've loaded this executable before
+    ce = img_cache_acquire(&self->file_attr);
+    if (ce) {
+        err = _gemdos_load_cached(self, ce);
+        img_cache_relinquish(ce);
+        return err;
+    }
+
+
     // Allocate the text, data and BSS segments 
     const size_t nbytes_to_read = sizeof(gemdos_hdr_t) + hdr->text_size + hdr->data_size;
     const size_t fileOffset_to_reloc = nbytes_to_read + hdr->symbol_table_size;
     const size_t reloc_size = (size_t)(self->file_attr.size - fileOffset_to_reloc);
     const size_t nbytes_to_alloc = __Ceil_PowerOf2(nbytes_to_read + __max(hdr->bss_size, reloc_size), CPU_PAGE_SIZE);
     uint8_t* img_base = NULL;
-    try(AddressSpace_Allocate(&self->as, nbytes_to_alloc, (void**)&img_base));
+    try(proc_img_alloc(self, nbytes_to_alloc, (void**)&img_base));
 
 
     // Read the executable header, text and data segments into memory
@@ -112,9 +228,20 @@ errno_t ldr_gemdos_load(proc_img_t* _Nonnull self)
     }
 
 
+    // Cache the unrelocated image so that the next load of this executable
+    // doesn't have to go to the disk
+    ce = _gemdos_cache_image(self, (const gemdos_hdr_t*)img_base, img_base, reloc_base, reloc_size);
+
+
     // Relocate the executable
     uint8_t* txt_base = img_base + sizeof(gemdos_hdr_t);
-    _gemdos_reloc(self, reloc_base, txt_base);
+    if (ce) {
+        ldr_reloc_apply(&ce->reloc, txt_base, (uint32_t)txt_base);
+        img_cache_relinquish(ce);
+    }
+    else {
+        _gemdos_reloc(self, reloc_base, txt_base);
+    }
 
 
     // Initialize the BSS segment
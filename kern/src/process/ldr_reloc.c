@@ -0,0 +1,69 @@
+//
+//  ldr_reloc.c
+//  kernel
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#include "ldr_reloc.h"
+
+
+void ldr_reloc_init(ldr_reloc_t* _Nonnull rel, uint16_t* _Nullable delta)
+{
+    rel->site_count = 0;
+    rel->first_site = 0;
+    rel->last_site = 0;
+    rel->delta_count = 0;
+    rel->delta = delta;
+}
+
+void ldr_reloc_add(ldr_reloc_t* _Nonnull rel, uint32_t site)
+{
+    if (rel->site_count > 0) {
+        uint32_t dist = site - rel->last_site;
+
+        while (dist > RELOC_SKIP) {
+            if (rel->delta) {
+                rel->delta[rel->delta_count] = 0;
+            }
+            rel->delta_count++;
+            dist -= RELOC_SKIP;
+        }
+        if (rel->delta) {
+            rel->delta[rel->delta_count] = (uint16_t)dist;
+        }
+        rel->delta_count++;
+    }
+    else {
+        rel->first_site = site;
+    }
+
+    rel->last_site = site;
+    rel->site_count++;
+}
+
+void ldr_reloc_apply(const ldr_reloc_t* _Nonnull rel, uint8_t* _Nonnull base, uint32_t offset)
+{
+    if (rel->site_count == 0) {
+        return;
+    }
+
+    const uint16_t* p = rel->delta;
+    const uint16_t* pEnd = p + rel->delta_count;
+    uint8_t* pLoc = base + rel->first_site;
+
+    *((uint32_t*) pLoc) += offset;
+
+    while (p != pEnd) {
+        const uint16_t d = *p++;
+
+        if (d == 0) {
+            pLoc += RELOC_SKIP;
+        }
+        else {
+            pLoc += d;
+            *((uint32_t*) pLoc) += offset;
+        }
+    }
+}
@@ -0,0 +1,44 @@
+//
+//  ldr_reloc.h
+//  kernel
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#ifndef _LDR_RELOC_H
+#define _LDR_RELOC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// A compact, pre-decoded relocation list. Every relocation site is a 32 bit
+// word to which the load address of the image has to be added. The first site
+// is stored as an absolute offset relative to the relocation base. Every
+// following site is stored as a 16 bit delta relative to the previous site. A
+// delta of 0 is an escape which advances the current site by RELOC_SKIP bytes
+// without relocating anything. This allows us to walk the list with a tight
+// loop that doesn't have to decode a byte stream.
+#define RELOC_SKIP  0xffff
+
+typedef struct ldr_reloc {
+    size_t              site_count;     // Number of relocation sites. 0 -> nothing to relocate
+    uint32_t            first_site;     // Offset of the first site relative to the relocation base
+    uint32_t            last_site;      // Offset of the most recently added site
+    size_t              delta_count;    // Number of entries in 'delta'
+    uint16_t* _Nullable delta;
+} ldr_reloc_t;
+
+
+// Initializes an empty relocation list. Sites are stored in 'delta'. Pass NULL
+// to only count the number of delta entries that are needed to store the list.
+extern void ldr_reloc_init(ldr_reloc_t* _Nonnull rel, uint16_t* _Nullable delta);
+
+// Appends the relocation site 'site' to the list. Sites must be added in
+// strictly ascending order.
+extern void ldr_reloc_add(ldr_reloc_t* _Nonnull rel, uint32_t site);
+
+// Relocates the image at 'base' by adding 'offset' to every relocation site.
+extern void ldr_reloc_apply(const ldr_reloc_t* _Nonnull rel, uint8_t* _Nonnull base, uint32_t offset);
+
+#endif /* _LDR_RELOC_H */
@@ -0,0 +1,217 @@
+//
+//  ldr_sef.c
+//  kernel
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#include "ldr_sef.h"
+#include "ldr_reloc.h"
+#include <string.h>
+#include <ext/math.h>
+#include <handler/Handler.h>
+#include <kern/kalloc.h>
+#include <kpi/sef.h>
+#include <machine/cpu.h>
+
+#define SEF_SEG_ALIGN_MAX   16
+#define SEF_STACK_SIZE_MAX  (1024 * 1024)
+#define SEF_IMG_SIZE_MAX    (64 * 1024 * 1024)
+
+
+// Reads the 'nbytes' bytes at file offset 'offset' into 'buf'.
+static errno_t _sef_read(HandlerRef _Nonnull fp, off_t offset, void* _Nonnull buf, size_t nbytes)
+{
+    decl_try_err();
+    ssize_t nBytesRead;
+
+    Handler_Seek(fp, offset, NULL, SEEK_SET);
+    try(Handler_Read(fp, buf, nbytes, &nBytesRead));
+    if (nBytesRead != nbytes) {
+        throw(EIO);
+    }
+
+catch:
+    return err;
+}
+
+// Loads the segment 'seg' into memory at 'p' and zero-fills the rest of the
+// segment.
+static errno_t _sef_load_seg(HandlerRef _Nonnull fp, const sef_seg_t* _Nonnull seg, uint8_t* _Nonnull p)
+{
+    decl_try_err();
+
+    if (seg->file_size > 0) {
+        err = _sef_read(fp, seg->file_offset, p, seg->file_size);
+    }
+    if (err == EOK) {
+        memset(p + seg->file_size, 0, seg->mem_size - seg->file_size);
+    }
+    return err;
+}
+
+static bool _sef_is_valid_seg(const sef_seg_t* _Nonnull seg, off_t fileSize)
+{
+    return seg->file_size <= seg->mem_size
+        && seg->file_offset <= fileSize
+        && seg->file_size <= fileSize - seg->file_offset;
+}
+
+// Applies the relocation tables to the image. 'seg_base' holds the load address
+// of the text and data segments and 'seg_size' the size of the region that
+// relocation sites in the respective segment may occupy.
+static errno_t _sef_relocate(HandlerRef _Nonnull fp, const sef_hdr_t* _Nonnull hdr, off_t fileSize, uint8_t* _Nonnull seg_base[2], const size_t seg_size[2], const uint32_t seg_offset[2])
+{
+    decl_try_err();
+    uint16_t* buf = NULL;
+    size_t buf_size = 0;
+
+    for (int i = 0; i < SEF_RELOC_COUNT; i++) {
+        const sef_reloc_t* rt = &hdr->reloc[i];
+        const int site_seg = i >> 1;            // SEF_SEG_TEXT or SEF_SEG_DATA
+        const int target_seg = i & 1;
+
+        if (rt->file_offset == 0 || seg_offset[target_seg] == 0) {
+            continue;
+        }
+
+        // A table can't be bigger than the file. Checking the delta count
+        // first ensures that the table size can't overflow
+        if (rt->file_offset > fileSize || rt->delta_count > (fileSize - rt->file_offset) / sizeof(uint16_t)) {
+            throw(ENOEXEC);
+        }
+        const size_t tab_size = sizeof(uint32_t) + rt->delta_count * sizeof(uint16_t);
+        if (tab_size > fileSize - rt->file_offset) {
+            throw(ENOEXEC);
+        }
+
+
+        // Read the table
+        if (tab_size > buf_size) {
+            kfree(buf);
+            buf = NULL;
+            try(kalloc_tagged(tab_size, KALLOC_TAG_PROCESS, (void**)&buf));
+            buf_size = tab_size;
+        }
+        try(_sef_read(fp, rt->file_offset, buf, tab_size));
+
+
+        // Validate it. Every site must lie inside the segment. Sites only
+        // ever move forward, so checking each one against the segment end
+        // without wrapping around is sufficient. Every site must also be word
+        // aligned because the 68000 raises an address error on an odd 32 bit
+        // access. The segment bases are word aligned
+        ldr_reloc_t rel;
+        uint32_t last_site = *(uint32_t*)buf;
+
+        rel.site_count = 1;
+        rel.first_site = last_site;
+        rel.delta_count = rt->delta_count;
+        rel.delta = buf + 2;
+
+        if (seg_size[site_seg] < sizeof(uint32_t)) {
+            throw(ENOEXEC);
+        }
+        const uint32_t max_site = seg_size[site_seg] - sizeof(uint32_t);
+
+        if (last_site > max_site || (last_site & 1) != 0) {
+            throw(ENOEXEC);
+        }
+        for (size_t j = 0; j < rel.delta_count; j++) {
+            const uint32_t delta = (rel.delta[j] > 0) ? rel.delta[j] : RELOC_SKIP;
+
+            if (delta > max_site - last_site) {
+                throw(ENOEXEC);
+            }
+            last_site += delta;
+
+            if (rel.delta[j] > 0 && (last_site & 1) != 0) {
+                throw(ENOEXEC);
+            }
+        }
+
+
+        // Apply it
+        ldr_reloc_apply(&rel, seg_base[site_seg], seg_offset[target_seg]);
+    }
+
+catch:
+    kfree(buf);
+    return err;
+}
+
+errno_t ldr_sef_load(proc_img_t* _Nonnull self)
+{
+    decl_try_err();
+    HandlerRef fp = self->file;
+    const sef_hdr_t* hdr = (const sef_hdr_t*)self->prefix_buf;
+    const off_t fileSize = self->file_attr.size;
+    const sef_seg_t* txt = &hdr->seg[SEF_SEG_TEXT];
+    const sef_seg_t* dat = &hdr->seg[SEF_SEG_DATA];
+    const sef_seg_t* bss = &hdr->seg[SEF_SEG_BSS];
+
+    // Validate the header
+    if (self->prefix_length < sizeof(sef_hdr_t) || hdr->signature != SEF_SIGNATURE) {
+        throw(ENOEXEC);
+    }
+    if (hdr->version != SEF_VERSION || hdr->hdr_size < sizeof(sef_hdr_t)) {
+        throw(EINVAL);
+    }
+    if (txt->mem_size == 0 || hdr->entry_offset >= txt->mem_size || hdr->seg_align > SEF_SEG_ALIGN_MAX) {
+        throw(EINVAL);
+    }
+    if (!_sef_is_valid_seg(txt, fileSize) || !_sef_is_valid_seg(dat, fileSize) || bss->file_size != 0) {
+        throw(EINVAL);
+    }
+
+    // Bound every segment before the image layout is computed. With the
+    // segment sizes and the alignment bounded like this none of the sums and
+    // roundings below can wrap around
+    if (txt->mem_size > SEF_IMG_SIZE_MAX || dat->mem_size > SEF_IMG_SIZE_MAX || bss->mem_size > SEF_IMG_SIZE_MAX) {
+        throw(EINVAL);
+    }
+
+
+    // Allocate the text, data and BSS segments. The data segment follows the
+    // text segment at the next 2^seg_align boundary and the BSS segment follows
+    // the data segment. The data segment must be word aligned
+    const size_t dat_offset = __Ceil_PowerOf2(txt->mem_size, 1ul << hdr->seg_align);
+    const size_t img_size = dat_offset + dat->mem_size + bss->mem_size;
+    if (img_size > SEF_IMG_SIZE_MAX || (dat_offset & 1) != 0) {
+        throw(EINVAL);
+    }
+    const size_t nbytes_to_alloc = __Ceil_PowerOf2(img_size, CPU_PAGE_SIZE);
+    uint8_t* img_base = NULL;
+    try(proc_img_alloc(self, nbytes_to_alloc, (void**)&img_base));
+
+
+    // Load the text and data segments and zero-fill the BSS segment. The BSS
+    // segment needs no file bytes
+    uint8_t* txt_base = img_base;
+    uint8_t* dat_base = img_base + dat_offset;
+    try(_sef_load_seg(fp, txt, txt_base));
+    try(_sef_load_seg(fp, dat, dat_base));
+    memset(dat_base + dat->mem_size, 0, bss->mem_size);
+
+
+    // Relocate the executable unless it landed at its link address. Data
+    // segment sites may point into the BSS segment
+    uint8_t* seg_base[2] = { txt_base, dat_base };
+    const size_t seg_size[2] = { txt->mem_size, dat->mem_size };
+    const uint32_t seg_offset[2] = {
+        (uint32_t)txt_base - hdr->load_addr,
+        (uint32_t)dat_base - (hdr->load_addr + dat_offset)
+    };
+    try(_sef_relocate(fp, hdr, fileSize, seg_base, seg_size, seg_offset));
+
+
+    // Return the result pointers and hints
+    self->base = img_base;
+    self->entry_point = txt_base + hdr->entry_offset;
+    self->stack_size = __min(hdr->stack_size, SEF_STACK_SIZE_MAX);
+    self->heap_size = hdr->heap_size;
+
+catch:
+    return err;
+}
@@ -0,0 +1,20 @@
+//
+//  ldr_sef.h
+//  kernel
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#ifndef _LDR_SEF_H
+#define _LDR_SEF_H
+
+#include "proc_img.h"
+
+// Loads a Serena executable (see kpi/sef.h) into a newly allocated memory area
+// in the address space of the image. Returns the base address of the in-core
+// executable image, the entry address of the executable and the stack and heap
+// size hints.
+extern errno_t ldr_sef_load(proc_img_t* _Nonnull pimg);
+
+#endif /* _LDR_SEF_H */
@@ -7,8 +7,10 @@
 //
 
 #include "proc_img.h"
+#include "img_cache.h"
 #include "ldr_gemdos.h"
 #include "ldr_script.h"
+#include "ldr_sef.h"
 #include <ext/math.h>
 #include <ext/string.h>
 #include <filemanager/FileManager.h>
@@ -31,10 +33,11 @@ static void _proc_img_close_file(proc_img_t* _Nonnull pimg);
 
 
 typedef errno_t (*ldr_func_t)(proc_img_t* _Nonnull pimg);
-#define LDR_COUNT 2
+#define LDR_COUNT 3
 
 static const ldr_func_t ldr_table[LDR_COUNT] = {
     ldr_script_load,
+    ldr_sef_load,
     ldr_gemdos_load
 };
 
@@ -79,16 +82,19 @@ static void _copyin_table(const char* tb[], const ctx_table_t* _Nonnull ctb)
     dst_tbv[ctb->tbc] = NULL;
 }
 
-static void _copyin_aux_array(proc_aux_entry_t* _Nonnull aux, void* _Nonnull exec_hdr)
+static void _copyin_aux_array(proc_aux_entry_t* _Nonnull aux, void* _Nonnull exec_hdr, size_t heap_size)
 {
     aux[0].type = AT_EXEC_HDR;
     aux[0].u.p = exec_hdr;
 
     aux[1].type = AT_KEI;
     aux[1].u.p = gKeiTable;
+
+    aux[2].type = AT_HEAP_SIZE;
+    aux[2].u.i = heap_size;
     
-    aux[2].type = AT_END;
-    aux[2].u.p = NULL;
+    aux[3].type = AT_END;
+    aux[3].u.p = NULL;
 }
 
 static errno_t _build_ctx(proc_img_t* _Nonnull pimg, const char* _Nullable argv[], const char* _Nullable env[])
@@ -109,7 +115,7 @@ static errno_t _build_ctx(proc_img_t* _Nonnull pimg, const char* _Nullable argv[
     // proc_ctx_t, argv_table, envv_table, aux_array, arg_strings, env_strings
     //
     // Layout of the aux entries:
-    // exec_hdr, kei_ptr, aux_end
+    // exec_hdr, kei_ptr, heap_size, aux_end
     ctx_table_t dst_argv;
     ctx_table_t dst_env;
     proc_aux_entry_t* aux_array;
@@ -117,7 +123,7 @@ static errno_t _build_ctx(proc_img_t* _Nonnull pimg, const char* _Nullable argv[
     try(_get_table_size(argv, &dst_argv));
     try(_get_table_size(env, &dst_env));
 
-#define AUX_ENTRY_COUNT 3
+#define AUX_ENTRY_COUNT 4
     proc_ctx_t* pctx = NULL;
     const size_t argv_size = sizeof(char*) * (dst_argv.tbc + 1);
     const size_t envv_size = sizeof(char*) * (dst_env.tbc + 1);
@@ -135,7 +141,7 @@ static errno_t _build_ctx(proc_img_t* _Nonnull pimg, const char* _Nullable argv[
 
     _copyin_table(argv, &dst_argv);
     _copyin_table(env, &dst_env);
-    _copyin_aux_array(aux_array, pimg->base);
+    _copyin_aux_array(aux_array, pimg->base, pimg->heap_size);
 
     pctx->argc = dst_argv.tbc;
     pctx->argv = dst_argv.tbv;
@@ -166,7 +172,7 @@ errno_t proc_img_create(FileManagerRef _Nonnull fm, const char* _Nonnull path, c
     }
     const size_t img_size = sizeof(struct proc_img) + sizeof(char*) * (argc + 1);
 
-    try(kalloc_cleared(img_size, (void**)&pimg));
+    try(kalloc_options(img_size, KALLOC_OPTION_CLEAR | KALLOC_OPTION_TAG(KALLOC_TAG_PROCESS), (void**)&pimg));
 
     pimg->orig_path = path;
     pimg->orig_argv = argv;
@@ -290,3 +296,14 @@ catch:
 
     return err;
 }
+
+errno_t proc_img_alloc(proc_img_t* _Nonnull pimg, size_t nbytes, void* _Nullable * _Nonnull pOutPtr)
+{
+    decl_try_err();
+
+    err = AddressSpace_Allocate(&pimg->as, nbytes, pOutPtr);
+    if (err == ENOMEM && img_cache_trim(nbytes) > 0) {
+        err = AddressSpace_Allocate(&pimg->as, nbytes, pOutPtr);
+    }
+    return err;
+}
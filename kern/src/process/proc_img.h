@@ -30,6 +30,8 @@ typedef struct proc_img {
     AddressSpace                        as;
     void* _Nullable                     base;
     void* _Nullable                     entry_point;
+    size_t                              stack_size;     // Main vcpu stack size hint from the executable. 0 -> default
+    size_t                              heap_size;      // Initial heap size hint from the executable. 0 -> default
     size_t                              arg_size;       // Size of arg_strings in terms of bytes. Includes the trailing '\0'
     char* _Nonnull                      arg_strings;    // Consecutive list of NUL-terminated process argument strings. End is marked by an empty string  
     size_t                              env_size;       // Size of env_strings in terms of bytes. Includes the trailing '\0'
@@ -58,4 +60,9 @@ extern errno_t proc_img_open_file(proc_img_t* _Nonnull pimg, const char* _Nonnul
 // Loads an executable from the given executable file.
 extern errno_t proc_img_load(proc_img_t* _Nonnull pimg);
 
+// Allocates 'nbytes' bytes of memory in the address space of the image.
+// 'nbytes' must be a multiple of the CPU page size. Evicts cached executable
+// images and tries again if memory is running low.
+extern errno_t proc_img_alloc(proc_img_t* _Nonnull pimg, size_t nbytes, void* _Nullable * _Nonnull pOutPtr);
+
 #endif /* _PROC_IMG_H_ */
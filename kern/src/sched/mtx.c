@@ -9,6 +9,7 @@
 #include "mtx.h"
 #include "vcpu.h"
 #include <assert.h>
+#include <hal/clock.h>
 #include <kern/kernlib.h>
 #include <kern/sigset.h>
 
@@ -24,51 +25,92 @@ void mtx_init(mtx_t* _Nonnull self)
 void mtx_deinit(mtx_t* _Nonnull self)
 {
     assert(mtx_owner(self) == NULL);
-    assert(wq_deinit(&self->wq) == EOK);
+    assert(wq_deinit(&self->pi.wq) == EOK);
 }
 
 void mtx_unlock(mtx_t* _Nonnull self)
 {
-    if (vcpu_current() != self->owner) {
+    if (vcpu_current() != self->pi.owner) {
         fatalError(__func__, __LINE__, EPERM);
         /* NOT REACHED */
     }
     
-    self->owner = NULL;
+    self->pi.owner = NULL;
     _mtx_unlock(self);
 }
 
 errno_t mtx_unlock_then_wait(mtx_t* _Nonnull self, struct waitqueue* _Nonnull wq, ticks_t deadline)
 {
-    if (vcpu_current() != self->owner) {
+    if (vcpu_current() != self->pi.owner) {
         fatalError(__func__, __LINE__, EPERM);
         /* NOT REACHED */
     }
     
-    self->owner = NULL;
+    self->pi.owner = NULL;
     return _mtx_unlock_then_wait(self, wq, deadline);
 }
 
 
+void mtx_getstats(mtx_t* _Nonnull self, mtx_stats_t* _Nonnull stats)
+{
+    const int sps = preempt_disable();
+    *stats = self->stats;
+    preempt_restore(sps);
+}
+
+
 // Invoked by mtx_lock() if the lock is currently being held by some other VP.
+// Acquires the mutex on behalf of mtx_lock(). There is only a single CPU and
+// thus the owner can not be running while the caller is. However if the owner
+// is ready to run at the caller's priority, then it is next in line anyway. The
+// caller yields directly to the owner in this case, giving it a chance to leave
+// its critical section without the caller going through the wait queue and the
+// priority inheritance machinery. The caller waits on the wait queue once the
+// owner is no longer ready to run or after MTX_MAX_YIELDS yields.
 // @Entry Condition: preemption disabled
-void mtx_onwait(mtx_t* _Nonnull self)
+void mtx_oncontended(mtx_t* _Nonnull self)
 {
-    wq_wait_np(&self->wq, TICKS_MAX);
+    const uint32_t start = clock_getcycles(g_mono_clock);
+    vcpu_t vp = vcpu_current();
+    int nyields = 0;
+
+    self->stats.contentions++;
+
+    while (!mtx_trylock(self)) {
+        vcpu_t owner = self->pi.owner;
+
+        if (nyields < MTX_MAX_YIELDS
+            && owner && owner->run_state == VCPU_STATE_READY
+            && owner->cur_priority >= vp->cur_priority) {
+            nyields++;
+            self->stats.yields++;
+            sched_switch_to(g_sched, owner);
+        }
+        else {
+            self->stats.waits++;
+            pi_wait_np(&self->pi, TICKS_MAX);
+        }
+    }
+
+    self->stats.wait_cycles += clock_getcycles(g_mono_clock) - start;
 }
 
-// Invoked by mtx_unlock().
+// Invoked by mtx_unlock(). The owner field has already been cleared at this
+// point which guarantees that no new waiter links the mutex to the caller. Drop
+// the priority that the caller has inherited through the mutex.
 // @Entry Condition: preemption disabled
 void mtx_wake(mtx_t* _Nullable self)
 {
-    wq_wakeup_np(&self->wq, WAKEUP_ALL, 0);
+    pi_unlink_np(&self->pi, vcpu_current());
+    wq_wakeup_np(&self->pi.wq, WAKEUP_ALL, 0);
 }
 
 // Invoked by mtx_unlock_then_wait().
 // @Entry Condition: preemption disabled
 errno_t mtx_wake_then_wait(mtx_t* _Nullable self, struct waitqueue* _Nonnull wq, ticks_t deadline)
 {
-    wq_wakeup_np(&self->wq, WAKEUP_ALL | WAKEUP_NO_IMMED_CSW, 0);
+    pi_unlink_np(&self->pi, vcpu_current());
+    wq_wakeup_np(&self->pi.wq, WAKEUP_ALL | WAKEUP_NO_IMMED_CSW, 0);
     wq_wait_np(wq, deadline);
 
     return EOK;
@@ -11,15 +11,34 @@
 
 #include <stdint.h>
 #include <ext/try.h>
-#include <sched/waitqueue.h>
+#include <sched/pi.h>
 
 struct vcpu;
 
 
+// Maximum number of times that a contended mtx_lock() yields to the owner of
+// the mutex before it parks the caller on the wait queue.
+#define MTX_MAX_YIELDS  4
+
+
+// Contention statistics of a mutex. Wait times are measured in clock cycles
+// (see clock_getcycles()).
+typedef struct mtx_stats {
+    uint32_t    acquisitions;           // number of times the mutex was acquired
+    uint32_t    contentions;            // number of acquisitions that found the mutex held by some other VP
+    uint32_t    yields;                 // number of times a contended acquisition yielded to the owner instead of waiting
+    uint32_t    waits;                  // number of times a contended acquisition waited on the wait queue
+    uint64_t    wait_cycles;            // total time spent in contended acquisitions
+} mtx_stats_t;
+
+
+// A mutex with priority inheritance. A vcpu that blocks on the mutex lends its
+// priority to the owner of the mutex until the owner releases the mutex.
+// Note: keep in sync with hal/hw/m68k/mtx_asm.s
 typedef struct mtx {
     volatile uint32_t       value;
-    struct waitqueue        wq;
-    struct vcpu* _Nullable  owner;  // Pointer to the VP that is currently holding the lock
+    pi_lock_t               pi;     // pi.owner points to the VP that is currently holding the lock
+    mtx_stats_t             stats;
 } mtx_t;
 
 #define MTX_INIT (struct mtx){0}
@@ -51,4 +70,7 @@ extern errno_t mtx_unlock_then_wait(mtx_t* _Nonnull self, struct waitqueue* _Non
 // returned if none is holding the lock.
 extern struct vcpu* _Nullable _Nullable mtx_owner(mtx_t* _Nonnull self);
 
+// Returns a snapshot of the contention statistics of the mutex.
+extern void mtx_getstats(mtx_t* _Nonnull self, mtx_stats_t* _Nonnull stats);
+
 #endif /* _MTX_H */
@@ -0,0 +1,137 @@
+//
+//  pi.c
+//  kernel
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#include "pi.h"
+#include "vcpu.h"
+#include <ext/math.h>
+#include <hal/sched.h>
+
+
+// Returns the highest priority of all vcpus that are waiting on the locks that
+// 'vp' holds. Returns SCHED_PRI_LOWEST if there are no waiters.
+// @Entry Condition: preemption disabled
+static int _pi_highest_waiter_priority_np(vcpu_t _Nonnull vp)
+{
+    int pri = SCHED_PRI_LOWEST;
+
+    deque_for_each(&vp->pi_locks, deque_node_t, it,
+        pi_lock_t* lp = pi_lock_from_qe(it);
+
+        deque_for_each(&lp->wq.q, struct vcpu, wvp,
+            pri = __max(pri, wvp->cur_priority);
+        )
+    )
+
+    return pri;
+}
+
+// Links the lock into the 'pi_locks' list of its current owner.
+// @Entry Condition: preemption disabled
+static void _pi_link_np(pi_lock_t* _Nonnull self)
+{
+    if (!self->isLinked && self->owner) {
+        deque_add_last(&self->owner->pi_locks, &self->qe);
+        self->isLinked = true;
+    }
+}
+
+// Raises the inherited priority of the owner of 'self' to at least 'pri' and
+// then follows the chain of locks that the owners are blocked on. Compares
+// against the inherited priority rather than the current priority because the
+// latter may include a transient boost that decays while the waiter is still
+// blocked.
+// @Entry Condition: preemption disabled
+static void _pi_propagate_np(pi_lock_t* _Nullable self, int pri)
+{
+    for (int i = 0; self && i < PI_MAX_CHAIN_LENGTH; i++) {
+        vcpu_t owner = self->owner;
+
+        if (owner == NULL || owner->inherited_priority >= pri) {
+            break;
+        }
+
+        vcpu_set_inherited_priority_np(owner, pri);
+        self = owner->pi_blocked_on;
+    }
+}
+
+
+void pi_setowner_np(pi_lock_t* _Nonnull self, vcpu_t _Nullable owner)
+{
+    if (self->owner != owner) {
+        if (self->owner) {
+            pi_unlink_np(self, self->owner);
+        }
+
+        self->owner = owner;
+        _pi_link_np(self);
+    }
+}
+
+void pi_unlink_np(pi_lock_t* _Nonnull self, vcpu_t _Nonnull vp)
+{
+    if (self->isLinked) {
+        deque_remove(&vp->pi_locks, &self->qe);
+        self->isLinked = false;
+
+        vcpu_set_inherited_priority_np(vp, _pi_highest_waiter_priority_np(vp));
+    }
+}
+
+void pi_disown_all_np(vcpu_t _Nonnull vp)
+{
+    deque_node_t* np;
+
+    while ((np = deque_remove_first(&vp->pi_locks)) != NULL) {
+        pi_lock_t* lp = pi_lock_from_qe(np);
+
+        lp->isLinked = false;
+        lp->owner = NULL;
+    }
+
+    vcpu_set_inherited_priority_np(vp, SCHED_PRI_LOWEST);
+}
+
+errno_t pi_wait_np(pi_lock_t* _Nonnull self, ticks_t deadline)
+{
+    vcpu_t vp = vcpu_current();
+
+    _pi_link_np(self);
+    _pi_propagate_np(self, vp->cur_priority);
+
+    vp->pi_blocked_on = self;
+    const errno_t err = wq_wait_np(&self->wq, deadline);
+    vp->pi_blocked_on = NULL;
+
+    return err;
+}
+
+errno_t pi_wait_addr(pi_lock_t* _Nonnull self, volatile atomic_int* _Nonnull addr, int expected, int flags, ticks_t deadline)
+{
+    decl_try_err();
+    const bool doAbort = (flags & SIGWAIT_NOABORT) == 0;
+    const int sps = preempt_disable();
+
+    for (;;) {
+        if (doAbort && vcpu_testabort_np() == EABORTED) {
+            err = EABORTED;
+            break;
+        }
+        if (atomic_int_load(addr) != expected) {
+            break;
+        }
+
+        err = pi_wait_np(self, deadline);
+        if (err != EOK) {
+            break;
+        }
+    }
+    preempt_restore(sps);
+
+    return err;
+}
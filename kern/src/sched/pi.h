@@ -0,0 +1,73 @@
+//
+//  pi.h
+//  kernel
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#ifndef _PI_H
+#define _PI_H 1
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <ext/atomic.h>
+#include <ext/queue.h>
+#include <ext/try.h>
+#include <sched/waitqueue.h>
+
+struct vcpu;
+
+
+// Maximum length of a chain of lock owners that priority is propagated along.
+// Protects against cycles in the case of a deadlock.
+#define PI_MAX_CHAIN_LENGTH 8
+
+
+// The wait side of a lock that supports priority inheritance. A vcpu that
+// blocks on the lock lends its priority to the owner of the lock. The owner in
+// turn lends its (now raised) priority to the owner of the lock it is blocked
+// on, if any, and so on. An owner keeps its inherited priority until it
+// releases the lock. The lock is linked into the owner's 'pi_locks' list while
+// the owner may be receiving priority through it.
+// Note: all fields are protected by disabling preemption
+typedef struct pi_lock {
+    struct waitqueue        wq;         // vcpus waiting for the lock
+    struct vcpu* _Nullable  owner;      // vcpu currently holding the lock
+    deque_node_t            qe;         // Linkage in the 'pi_locks' list of the owner
+    bool                    isLinked;   // true if 'qe' is on the 'pi_locks' list of the owner
+    int8_t                  reserved[3];
+} pi_lock_t;
+
+#define PI_LOCK_INIT (struct pi_lock){0}
+
+#define pi_lock_from_qe(__ptr) \
+(pi_lock_t*) (((uint8_t*)__ptr) - offsetof(struct pi_lock, qe))
+
+
+// Makes 'owner' the new owner of the lock. The previous owner loses the
+// priority that it has inherited through the lock. 'owner' may be NULL.
+// @Entry Condition: preemption disabled
+extern void pi_setowner_np(pi_lock_t* _Nonnull self, struct vcpu* _Nullable owner);
+
+// Unlinks the lock from the vcpu 'vp' that has just released it and recomputes
+// the priority that 'vp' inherits through the locks it still holds. The caller
+// is expected to clear the 'owner' field itself.
+// @Entry Condition: preemption disabled
+extern void pi_unlink_np(pi_lock_t* _Nonnull self, struct vcpu* _Nonnull vp);
+
+// Detaches all locks from the vcpu 'vp' and revokes any priority that it has
+// inherited. Invoked when a vcpu is relinquished.
+// @Entry Condition: preemption disabled
+extern void pi_disown_all_np(struct vcpu* _Nonnull vp);
+
+// Lends the priority of the caller to the owner chain of the lock and then
+// waits on the lock's wait queue. Otherwise works like wq_wait_np().
+// @Entry Condition: preemption disabled
+extern errno_t pi_wait_np(pi_lock_t* _Nonnull self, ticks_t deadline);
+
+// Like wq_wait_addr() but lends the priority of the caller to the owner chain of
+// the lock while it is waiting.
+extern errno_t pi_wait_addr(pi_lock_t* _Nonnull self, volatile atomic_int* _Nonnull addr, int expected, int flags, ticks_t deadline);
+
+#endif /* _PI_H */
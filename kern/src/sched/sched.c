@@ -12,9 +12,12 @@
 #include <assert.h>
 #include <string.h>
 #include <ext/bit.h>
+#include <ext/math.h>
+#include <hal/clock.h>
 #include <hal/sched.h>
 #include <kern/kernlib.h>
 #include <kern/sigset.h>
+#include <process/ProcessPriv.h>
 
 
 static void sched_dump_rdyq_locked(sched_t _Nonnull self);
@@ -26,7 +29,7 @@ static vcpu_t _Nonnull idle_vcpu_create(BootAllocator* _Nonnull bap);
 sched_t                 g_sched;
 static struct waitqueue g_sched_wq;     // The scheduler VP waits on this queue
 
-// Note that a quantum tick is 16.667ms
+// Note that a quantum tick is ~17ms
 const int8_t g_quantum_base_length[VCPU_QOS_COUNT] = {
     SCHED_QUANTUM(1),       /* Realtime */
     SCHED_QUANTUM(2),       /* Urgent */
@@ -71,6 +74,88 @@ void sched_create(BootAllocator* _Nonnull bap, sys_desc_t* _Nonnull sdp, vcpu_fu
     assert(self->scheduled == self->boot_vp);
 }
 
+// Adds a time span of 'cycles' clock cycles to the histogram 'hist'.
+static void _sched_hist_add(uint32_t* _Nonnull hist, uint32_t cycles)
+{
+    const int idx = (cycles > 0) ? 31 - leading_zeros_ui(cycles) : 0;
+
+    hist[__min(idx, SCHED_HIST_BUCKET_COUNT - 1)]++;
+}
+
+// Charges the time since 'vp->acct_stamp' to the user or system time of 'vp',
+// its process and the CPU. The time of the idle vcpu is charged to the idle
+// time of the CPU only. The cycle delta is 32 bits wide. This is fine because
+// the running vcpu is charged on every clock interrupt (see sched_on_tick_irq())
+// and thus the delta never comes close to wrapping.
+static void _sched_charge_np(sched_t _Nonnull self, vcpu_t _Nonnull vp, uint32_t now)
+{
+    const uint32_t cycles = now - vp->acct_stamp;
+    ProcessRef pp = vp->proc;
+
+    vp->acct_stamp = now;
+
+    if (vp->tag == VP_TAG_IDLE) {
+        self->idle_cycles += cycles;
+    }
+    else if (vcpu_is_user(vp) && (vp->flags & VP_FLAG_IN_SYSCALL) == 0) {
+        vp->usr_cycles += cycles;
+        if (pp) {
+            pp->usr_cycles += cycles;
+        }
+        self->usr_cycles += cycles;
+    }
+    else {
+        vp->sys_cycles += cycles;
+        if (pp) {   // NULL check because boot & idle vcpus are initially not associated with the kerneld proc
+            pp->sys_cycles += cycles;
+        }
+        self->sys_cycles += cycles;
+    }
+}
+
+// Charges the CPU time of the outgoing vcpu and updates the statistics for a
+// context switch from 'self->running' to 'vp'. 'self->running' is still the
+// outgoing vcpu (NULL if there is none) and the csw signals still reflect why
+// it is giving up the CPU.
+static void _sched_on_dispatch(sched_t _Nonnull self, vcpu_t _Nonnull vp)
+{
+    const uint32_t now = clock_getcycles(g_mono_clock);
+    vcpu_t ovp = self->running;
+
+    if (ovp) {
+        _sched_charge_np(self, ovp, now);
+    }
+
+    if (ovp && ovp->tag != VP_TAG_IDLE) {
+        cpu_sched_qos_stats_t* osp = &self->stats.qos[SCHED_QOS_GRADE(ovp->cur_priority) - 1];
+
+        _sched_hist_add(osp->run_time, now - ovp->dispatch_stamp);
+        if ((self->csw_signals & CSW_SIGNAL_PREEMPTED) != 0) {
+            osp->preemptions++;
+        }
+    }
+
+    if (vp->tag != VP_TAG_IDLE) {
+        const int qi = SCHED_QOS_GRADE(vp->cur_priority) - 1;
+        cpu_sched_qos_stats_t* sp = &self->stats.qos[qi];
+        const uint32_t rq_len = self->stats.rq_len[qi];
+
+        sp->dispatches++;
+        sp->rq_len_sum += rq_len;
+        if (rq_len > sp->rq_len_max) {
+            sp->rq_len_max = rq_len;
+        }
+
+        if ((vp->flags & VP_FLAG_WOKEN) != 0) {
+            vp->flags &= ~VP_FLAG_WOKEN;
+            sp->wakeups++;
+            _sched_hist_add(sp->wakeup_latency, now - vp->ready_stamp);
+        }
+    }
+    vp->dispatch_stamp = now;
+    vp->acct_stamp = now;
+}
+
 // Marks 'vp' as ready and inserts it in the proper ready queue.
 // Called from: _sched_switch_context()
 void sched_set_ready(sched_t _Nonnull self, vcpu_t _Nonnull vp, bool doAddToTail)
@@ -80,6 +165,20 @@ void sched_set_ready(sched_t _Nonnull self, vcpu_t _Nonnull vp, bool doAddToTail
     assert(vp->rewa_qe.next == NULL);
     
 
+    if (vp->tag != VP_TAG_IDLE) {
+        // A vcpu that is merely re-queued keeps its original ready stamp
+        if (vp->run_state != VCPU_STATE_READY) {
+            if (vp->run_state == VCPU_STATE_WAITING) {
+                vp->flags |= VP_FLAG_WOKEN;
+            }
+            else {
+                vp->flags &= ~VP_FLAG_WOKEN;
+            }
+            vp->ready_stamp = clock_getcycles(g_mono_clock);
+        }
+        self->stats.rq_len[SCHED_QOS_GRADE(vp->cur_priority) - 1]++;
+    }
+
     vp->run_state = VCPU_STATE_READY;
     const unsigned int pri = vp->cur_priority;
 
@@ -115,6 +214,13 @@ void sched_set_unready(sched_t _Nonnull self, vcpu_t _Nonnull vp, bool doReadyTo
         vp->run_state = VCPU_STATE_RUNNING;
     }
 
+    if (vp->tag != VP_TAG_IDLE) {
+        self->stats.rq_len[SCHED_QOS_GRADE(pri) - 1]--;
+    }
+    if (doReadyToRun) {
+        _sched_on_dispatch(self, vp);
+    }
+
 
     deque_remove(&self->ready_queue.priority[pri], &vp->rewa_qe);
     
@@ -177,6 +283,26 @@ void sched_switch_to(sched_t _Nonnull self, vcpu_t _Nonnull vp)
     sched_switch_context();
 }
 
+void sched_charge_running_np(sched_t _Nonnull self)
+{
+    _sched_charge_np(self, (vcpu_t)self->running, clock_getcycles(g_mono_clock));
+}
+
+void sched_on_syscall(sched_t _Nonnull self, bool isEntering)
+{
+    const int sps = preempt_disable();
+    vcpu_t vp = (vcpu_t)self->running;
+
+    _sched_charge_np(self, vp, clock_getcycles(g_mono_clock));
+    if (isEntering) {
+        vp->flags |= VP_FLAG_IN_SYSCALL;
+    }
+    else {
+        vp->flags &= ~VP_FLAG_IN_SYSCALL;
+    }
+    preempt_restore(sps);
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 // MARK: -
@@ -17,6 +17,7 @@
 #include <ext/try.h>
 #include <hal/cpu.h>
 #include <hal/sys_desc.h>
+#include <kpi/host.h>
 #include <kpi/vcpu.h>
 
 
@@ -79,6 +80,17 @@ typedef struct ready_queue {
 
 
 
+// Scheduler statistics. Kept with preemption disabled and exported through
+// cpu_info(CPU_INFO_SCHED_STATS). Time spans are measured in clock cycles (see
+// clock_getcycles()).
+typedef struct sched_stats {
+    cpu_sched_qos_stats_t   qos[VCPU_QOS_COUNT];    // indexed by QoS grade - 1
+    uint16_t                rq_len[VCPU_QOS_COUNT]; // number of vcpus on the ready queue per QoS grade
+    uint16_t                reserved;
+} sched_stats_t;
+
+
+
 // Note: Keep in sync with machine/hw/m68k/lowmem.i
 struct sched {
     volatile vcpu_t _Nullable   running;                        // Currently running VP
@@ -89,10 +101,11 @@ struct sched {
     int8_t                      reserved;
     vcpu_t _Nonnull             idle_vp;                        // This VP is scheduled if there is no other VP to schedule
     vcpu_t _Nonnull             boot_vp;                        // This is the first VP that was created at boot time for a CPU. It takes care of scheduler chores like destroying terminated VPs
-    ticks_t                     sys_ticks;                      // Accumulated number of ticks this cpu has spent on running in kernel/system mode
-    ticks_t                     usr_ticks;                      // Accumulated number of ticks this cpu has spent on running in user mode
-    ticks_t                     idle_ticks;                     // Accumulated number of ticks this cpu has spent on sitting idle
+    uint64_t                    sys_cycles;                     // Accumulated number of clock cycles this cpu has spent on running in kernel/system mode
+    uint64_t                    usr_cycles;                     // Accumulated number of clock cycles this cpu has spent on running in user mode
+    uint64_t                    idle_cycles;                    // Accumulated number of clock cycles this cpu has spent on sitting idle
     ready_queue_t               ready_queue;
+    sched_stats_t               stats;
 };
 typedef struct sched* sched_t;
 
@@ -139,14 +152,26 @@ extern vcpu_t _Nullable sched_highest_priority_ready(sched_t _Nonnull self);
 
 extern void sched_switch_to(sched_t _Nonnull self, vcpu_t _Nonnull vp);
 
+// Charges the time that the running vcpu has spent on the CPU since it was last
+// charged. Call this before reading the CPU times of a vcpu, a process or the
+// CPU to include the time of the current run.
+// @Entry Condition: preemption disabled
+extern void sched_charge_running_np(sched_t _Nonnull self);
+
+// Invoked by the system call handler when the running vcpu enters
+// ('isEntering' true) or leaves a system call. Charges the time since the last
+// transition to the user or system time of the vcpu.
+extern void sched_on_syscall(sched_t _Nonnull self, bool isEntering);
+
 
 // @HAL Requirement: Must be called from the monotonic clock IRQ handler
 extern void sched_wait_timeout_irq(vcpu_t _Nonnull vp);
 
-// Invoked at every clock tick and before sched_on_any_irq() is invoked. Runs in
-// the interrupt context.
+// Invoked by the clock interrupt and before sched_on_any_irq() is invoked.
+// 'isQuantumTick' is true if a quantum tick is due. Runs in the interrupt
+// context.
 // @HAL Requirement: Must be called from interrupt context
-extern void sched_on_tick_irq(sched_t _Nonnull self, excpt_frame_t* _Nonnull efp);
+extern void sched_on_tick_irq(sched_t _Nonnull self, bool isQuantumTick);
 
 // Invoked at the end of any and all interrupts. Runs in the interrupt context.
 // @HAL Requirement: Must be called from interrupt context
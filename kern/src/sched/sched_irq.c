@@ -22,35 +22,22 @@ void sched_wait_timeout_irq(vcpu_t _Nonnull vp)
 }
 
 
-// Invoked at every clock tick and before sched_on_any_irq() is invoked. Runs in
-// the interrupt context.
-void sched_on_tick_irq(sched_t _Nonnull self, excpt_frame_t* _Nonnull efp)
+// Invoked by the clock interrupt and before sched_on_any_irq() is invoked. Runs
+// in the interrupt context.
+// CPU time is mainly charged at context switch and system call boundaries. It
+// is also charged here because the cycle counter is only 32 bits wide and wraps
+// after about 100 minutes. The clock interrupt fires at least every
+// CLOCK_MAX_EVENT_CYCLES cycles, even while the idle vcpu runs, so a vcpu that
+// runs for a long time without a switch or a system call is still charged in
+// full. See _sched_charge_np().
+void sched_on_tick_irq(sched_t _Nonnull self, bool isQuantumTick)
 {
     register vcpu_t run = (vcpu_t)self->running;
 
-    if (run->quantum_countdown > 0) {
-        run->quantum_countdown -= SCHED_QUANTUM_SCALE;
-    }
+    sched_charge_running_np(self);
 
-    
-    if (excpt_frame_isuser(efp)) {
-        // User mode
-        run->usr_ticks++;
-        run->proc->usr_ticks++;
-        self->usr_ticks++;
-    }
-    else {
-        // System/kernel mode
-        run->sys_ticks++;
-        if (run->proc) {    // NULL check because boot & idle vcpus are initially not associated with the kerneld proc
-            run->proc->sys_ticks++;
-        }
-        if (run->tag == VP_TAG_SYS) {
-            self->sys_ticks++;
-        }
-        else {
-            self->idle_ticks++;
-        }
+    if (isQuantumTick && run->quantum_countdown > 0) {
+        run->quantum_countdown -= SCHED_QUANTUM_SCALE;
     }
 }
 
@@ -81,6 +68,10 @@ void sched_on_any_irq(sched_t _Nonnull self, excpt_frame_t* _Nonnull efp)
         // run another quantum
         register vcpu_t rdy = sched_highest_priority_ready(self);
 
+        if (run->tag != VP_TAG_IDLE) {
+            self->stats.qos[SCHED_QOS_GRADE(run->cur_priority) - 1].quantum_expirations++;
+        }
+
         if (rdy && rdy->cur_priority >= run->cur_priority) {
             sched_set_running(self, rdy);
         }
@@ -120,4 +111,11 @@ void sched_on_any_irq(sched_t _Nonnull self, excpt_frame_t* _Nonnull efp)
         // Reset the quantum
         vcpu_reset_quantum_np(run);
     }
+
+
+    // The clock stops delivering quantum ticks while the idle vcpu is running.
+    // Restart them if we're switching away from the idle vcpu
+    if (run == self->idle_vp && (self->csw_signals & CSW_SIGNAL_SWITCH) != 0 && self->scheduled != run) {
+        clock_resume_quantum(g_mono_clock);
+    }
 }
\ No newline at end of file
@@ -12,6 +12,9 @@
 #include <kern/kalloc.h>
 #include <kern/kernlib.h>
 
+// 'STAK'
+#define STACK_FILL_PATTERN  0x5354414b
+
 
 // Initializes an execution stack struct. The execution stack is empty by default
 // and you need to call stk_setmaxsize() to allocate the stack with
@@ -57,3 +60,25 @@ errno_t stk_setmaxsize(stk_t* _Nullable self, size_t size)
     
     return EOK;
 }
+
+void stk_fill(stk_t* _Nonnull self, size_t nbytes)
+{
+    uint32_t* p = (uint32_t*)(self->base + self->size - __min(nbytes, self->size));
+    uint32_t* top = (uint32_t*)(self->base + self->size);
+
+    while (p < top) {
+        *p++ = STACK_FILL_PATTERN;
+    }
+}
+
+size_t stk_gethighwater(const stk_t* _Nonnull self)
+{
+    const uint32_t* p = (const uint32_t*)self->base;
+    const uint32_t* top = (const uint32_t*)(self->base + self->size);
+
+    while (p < top && *p == STACK_FILL_PATTERN) {
+        p++;
+    }
+
+    return (const char*)top - (const char*)p;
+}
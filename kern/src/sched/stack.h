@@ -26,6 +26,15 @@ extern void stk_destroy(stk_t* _Nullable self);
 
 extern errno_t stk_setmaxsize(stk_t* _Nullable self, size_t size);
 
+// Fills the topmost 'nbytes' bytes of the stack with a pattern. The stack should
+// be filled completely when it is allocated. A stack that has been used only
+// needs the part below its high-water mark refilled.
+extern void stk_fill(stk_t* _Nonnull self, size_t nbytes);
+
+// Returns the number of bytes at the top of the stack that have been used since
+// the stack was filled with stk_fill().
+extern size_t stk_gethighwater(const stk_t* _Nonnull self);
+
 #define stk_getinitialsp(__self) \
 ((uintptr_t)((size_t)((__self)->base + (__self)->size)))
 
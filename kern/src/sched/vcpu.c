@@ -82,10 +82,13 @@ void vcpu_reset_np(vcpu_t _Nonnull self, const vcpu_policy_t* _Nonnull policy, i
     self->excpt_state = (cpu_excpt_state_t){0};
     self->excpt_sa = NULL;
     self->syscall_sa = NULL;
-    self->usr_ticks = 0;
-    self->sys_ticks = 0;
+    self->usr_cycles = 0ull;
+    self->sys_cycles = 0ull;
     self->wait_ticks = 0;
-    self->flags &= ~(VP_FLAG_DID_WAIT);
+    self->flags &= ~(VP_FLAG_DID_WAIT | VP_FLAG_IN_SYSCALL);
+    self->inherited_priority = SCHED_PRI_LOWEST;
+    self->pi_locks = DEQUE_INIT;
+    self->pi_blocked_on = NULL;
 
 
     // Setup QoS, nice, boosts
@@ -173,6 +176,9 @@ void vcpu_on_sched_param_changed_np(vcpu_t _Nonnull self)
         eff_pri = __max(__min(eff_pri, dyn_top_pri), dyn_bot_pri);
     }
 
+    // Never run below the priority of a vcpu that is waiting for a lock we hold
+    eff_pri = __max(eff_pri, self->inherited_priority);
+
 //    assert(eff_pri >= SCHED_PRI_LOWEST && eff_pri <= SCHED_PRI_HIGHEST);
 
     self->cur_priority = (int8_t)eff_pri;
@@ -256,6 +262,25 @@ errno_t vcpu_set_policy(vcpu_t _Nonnull self, const vcpu_policy_t* _Nonnull poli
     return err;
 }
 
+// @Entry Condition: preemption disabled
+void vcpu_set_inherited_priority_np(vcpu_t _Nonnull self, int pri)
+{
+    if (self->inherited_priority == pri) {
+        return;
+    }
+
+    if (self->run_state == VCPU_STATE_READY) {
+        sched_set_unready(g_sched, self, false);
+        self->inherited_priority = (int8_t)pri;
+        vcpu_on_sched_param_changed_np(self);
+        sched_set_ready(g_sched, self, true);
+    }
+    else {
+        self->inherited_priority = (int8_t)pri;
+        vcpu_on_sched_param_changed_np(self);
+    }
+}
+
 // @Entry Condition: preemption disabled
 static void vcpu_yield_np(vcpu_t _Nonnull self)
 {
@@ -532,6 +557,7 @@ errno_t vcpu_info(vcpu_t _Nonnull self, int flavor, vcpu_info_ref _Nonnull info)
             if (vcpu_is_user(self)) {
                 ip->base_ptr = self->user_stack.base;
                 ip->size = self->user_stack.size;
+                ip->high_water = stk_gethighwater(&self->user_stack);
             }
             else {
                 err = EINVAL;
@@ -578,8 +604,14 @@ errno_t vcpu_info(vcpu_t _Nonnull self, int flavor, vcpu_info_ref _Nonnull info)
         case VCPU_INFO_TIMES: {
             vcpu_times_info_t* ip = info;
 
-            clock_ticks2time(g_mono_clock, self->usr_ticks, &ip->user_time);
-            clock_ticks2time(g_mono_clock, self->sys_ticks, &ip->system_time);
+            const int sps = preempt_disable();
+            sched_charge_running_np(g_sched);
+            const uint64_t usr_cycles = self->usr_cycles;
+            const uint64_t sys_cycles = self->sys_cycles;
+            preempt_restore(sps);
+
+            clock_cycles2time(g_mono_clock, usr_cycles, &ip->user_time);
+            clock_cycles2time(g_mono_clock, sys_cycles, &ip->system_time);
             clock_ticks2time(g_mono_clock, self->wait_ticks, &ip->wait_time);
             ip->acquisition_time = self->acquisition_time;
             break;
@@ -26,6 +26,7 @@
 #include <sched/sched.h>
 
 struct Process;
+struct pi_lock;
 struct vcpu;
 
 
@@ -76,6 +77,8 @@ typedef struct cpu_excpt_state {
 // bits 0..3 are reserved for flags that are accessible to C and asm code
 #define VP_FLAG_DID_WAIT            0x10    // cleared by default; set when teh vcpu has called wait() at one point while executing the current quantum
 #define VP_FLAG_FIXED_PRI           0x20    // set if the vcpu should be scheduled using a fixed priority policy. Derived from the QoS scheduling parameters
+#define VP_FLAG_WOKEN               0x40    // set while the vcpu sits on the ready queue after it has been woken up from a wait
+#define VP_FLAG_IN_SYSCALL          0x80    // set while a user vcpu executes a system call. Time is charged to the system time while set and the user time otherwise
 
 
 #define SCHED_PRIORITY_BIAS_HIGHEST INT8_MAX 
@@ -139,19 +142,26 @@ struct vcpu {
     int8_t                          quantum_countdown;      // for how many contiguous clock ticks this VP may run for before the scheduler will consider scheduling some other same or lower priority VP
     int16_t                         suspension_count;       // > 0 -> VP is suspended
     int8_t                          tag;
-    int8_t                          reserved;
+    int8_t                          inherited_priority;     // highest priority of the vcpus waiting on a lock held by this VP (call vcpu_set_inherited_priority_np() to change)
 
     // Usage stats
     nanotime_t                      acquisition_time;
-    ticks_t                         usr_ticks;
-    ticks_t                         sys_ticks;
+    uint64_t                        usr_cycles;             // accumulated number of clock cycles spent running in user space (since acquisition)
+    uint64_t                        sys_cycles;             // accumulated number of clock cycles spent running in kernel space (since acquisition)
     ticks_t                         wait_ticks;             // accumulated number of ticks spent in waiting or suspended state (since acquisition)
+    uint32_t                        ready_stamp;            // clock cycle count when the vcpu was last put on the ready queue
+    uint32_t                        dispatch_stamp;         // clock cycle count when the vcpu was last given the CPU
+    uint32_t                        acct_stamp;             // clock cycle count up to which the vcpu's CPU time has been charged
 
     // Process
     struct Process* _Nullable _Weak proc;                   // Process owning this VP. Note that sched_irq.c assumes that this field is never NULL while the vcpu is acquired and active 
 
     // kdispatch
     void* _Nullable _Weak           dispatch_worker;        // kdispatch_worker if this VP is part of a dispatcher
+
+    // Priority inheritance
+    deque_t                         pi_locks;               // Locks held by this VP through which it may inherit priority
+    struct pi_lock* _Nullable       pi_blocked_on;          // Lock this VP is waiting to acquire; NULL if none
 };
 
 
@@ -371,6 +381,13 @@ extern void vcpu_set_quantum_boost_np(vcpu_t _Nonnull self, int boost);
 // @Entry Condition: preemption disabled
 extern void vcpu_set_nice_np(vcpu_t _Nonnull self, int nice);
 
+// Sets the priority that the vcpu inherits from the vcpus that are blocked on
+// the locks it holds. The effective priority of the vcpu is at least 'pri'
+// while it is inheriting. Pass SCHED_PRI_LOWEST to stop inheriting. Moves the
+// vcpu to the correct ready queue position if it is ready.
+// @Entry Condition: preemption disabled
+extern void vcpu_set_inherited_priority_np(vcpu_t _Nonnull self, int pri);
+
 
 //
 // Internal
@@ -17,6 +17,11 @@
 #define WRES_WAKEUP     1
 #define WRES_TIMEOUT    2
 
+// Longest wait timeout that wq_calc_deadline() turns into a deadline. A clock
+// tick is about 1ms long and thus this keeps deadlines less than TICKS_MAX / 2
+// ticks away from the current time
+#define WQ_DEADLINE_MAX_SECS    ((TICKS_MAX / 2) / 1024)
+
 
 void wq_init(waitqueue_t _Nonnull self)
 {
@@ -42,24 +47,39 @@ ticks_t wq_calc_deadline(clock_ref_t _Nonnull clock, int flags, const nanotime_t
     assert(clock == g_mono_clock);
 
     if (nanotime_lt(wtp, &NANOTIME_INF)) {
-        const ticks_t deadline_ticks = clock_time2ticks_ceil(clock, wtp);
+        nanotime_t dt;
 
+        // The tick counter wraps around. Turn an absolute time into a relative
+        // one first since it can't be converted to ticks directly. Note that we
+        // read the time before the ticks below so that the deadline can only
+        // end up late but never early.
         if ((flags & TIMER_ABSTIME) == TIMER_ABSTIME) {
-            // absolute
-            return deadline_ticks;
+            nanotime_t now;
+
+            clock_gettime(clock, &now);
+            if (nanotime_le(wtp, &now)) {
+                dt = NANOTIME_ZERO;
+            }
+            else {
+                nanotime_sub(&dt, wtp, &now);
+            }
         }
         else {
-            // relative
-            const ticks_t now = clock_getticks(clock);
-            const ticks_t abs_deadline = now + deadline_ticks;
+            dt = *wtp;
+        }
 
-            // overflow check
-            return (abs_deadline > now && abs_deadline > deadline_ticks) ? abs_deadline : TICKS_MAX;
+
+        // Deadlines that are further out than ticks_before() is able to compare
+        // never fire
+        if (dt.tv_sec < WQ_DEADLINE_MAX_SECS) {
+            const ticks_t deadline = clock_getticks(clock) + clock_time2ticks_ceil(clock, &dt);
+
+            // TICKS_MAX means no deadline. Fire one tick later instead
+            return (deadline != TICKS_MAX) ? deadline : deadline + 1;
         }
     }
-    else {
-        return TICKS_MAX;
-    }
+
+    return TICKS_MAX;
 }
 
 // @Entry Condition: preemption disabled
@@ -87,12 +107,12 @@ errno_t wq_wait_np(waitqueue_t _Nonnull self, const ticks_t deadline)
 
     // Put us on the timeout queue. Note that we return immediately if we're
     // already past the deadline
-    if (deadline < TICKS_MAX) {
-        if (deadline <= start_ticks) {
+    if (deadline != TICKS_MAX) {
+        if (!ticks_before(start_ticks, deadline)) {
             return ETIMEDOUT;
         }
 
-        vp->timeout.deadline = deadline;
+        vp->timeout.timer.deadline = deadline;
         vp->timeout.func = (deadline_func_t)sched_wait_timeout_irq;
         vp->timeout.arg = vp;
 
@@ -65,11 +65,12 @@ extern errno_t wq_deinit(waitqueue_t _Nonnull self);
 // timeout and 'flags' specifies whether 'wtp' is relative or absolute. Returns
 // the calculated deadline value as an absolute ticks value in the time system
 // of the scheduler clock if 'wtp' was less than infinity. Returns TICKS_MAX if
-// 'wtp' is infinity. 
+// 'wtp' is infinity or so far in the future that the wrapping tick counter is
+// unable to represent it (about 24 days).
 extern ticks_t wq_calc_deadline(clock_ref_t _Nonnull clock, int flags, const nanotime_t* _Nonnull wtp);
 
 // Waits until wakeup() is called on the wait queue 'self' or until the deadline
-// 'deadline' has been reached if 'deadline' is < TICKS_MAX. Note that the
+// 'deadline' has been reached if 'deadline' is != TICKS_MAX. Note that the
 // deadline should be calculated with the help of the wq_calc_deadline()
 // function and that it is an absolute time value in the time system of the
 // scheduler clock. Returns EOK on a regular (and potentially spurious) wakeup
@@ -45,7 +45,7 @@ SYSCALL_2(clock_time, int clockid, nanotime_t* _Nonnull time)
         return ENODEV;
     }
 
-    clock_gettime(g_mono_clock, pa->time);
+    clock_gettime_hires(g_mono_clock, pa->time);
     return EOK;
 }
 
@@ -124,6 +124,19 @@ SYSCALL_2(fd_truncate, int fd, off_t length)
     return err;
 }
 
+SYSCALL_2(fd_sync, int fd, int flags)
+{
+    decl_try_err();
+    ProcessRef pp = vp->proc;
+    HandlerRef hnd;
+
+    if ((err = HandlerTable_CopyHandler(&pp->HandlerTable, pa->fd, &hnd)) == EOK) {
+        err = Handler_Sync(hnd, pa->flags);
+        Object_Release(hnd);
+    }
+    return err;
+}
+
 SYSCALL_2(fd_attr, int fd, fs_attr_t* _Nonnull attr)
 {
     decl_try_err();
@@ -7,6 +7,7 @@
 //
 
 #include "syscalldecls.h"
+#include <string.h>
 #include <hal/clock.h>
 #include <hal/sys_desc.h>
 #include <kpi/host.h>
@@ -57,6 +58,11 @@ SYSCALL_3(host_processes, pid_t* _Nonnull buf, size_t bufSize, int* _Nonnull out
     return ProcessManager_GetProcessIds(gProcessManager, pa->buf, pa->bufSize, pa->out_hasMore);
 }
 
+SYSCALL_4(host_procsnap, proc_snapshot_t* _Nonnull buf, size_t bufSize, size_t* _Nonnull pOutCount, int* _Nonnull out_hasMore)
+{
+    return ProcessManager_GetSnapshot(gProcessManager, pa->buf, pa->bufSize, pa->pOutCount, pa->out_hasMore);
+}
+
 SYSCALL_3(host_filesystems, fsid_t* _Nonnull buf, size_t bufSize, int* _Nonnull out_hasMore)
 {
     return ProcessManager_GetProcessIds(gProcessManager, pa->buf, pa->bufSize, pa->out_hasMore);
@@ -96,9 +102,27 @@ SYSCALL_3(cpu_info, cpuid_t cpuid, int flavor, cpu_info_ref _Nonnull info)
         case CPU_INFO_UTILIZATION: {
             cpu_utilization_info_t* ip = pa->info;
 
-            clock_ticks2time(g_mono_clock, g_sched->usr_ticks, &ip->user_time);
-            clock_ticks2time(g_mono_clock, g_sched->sys_ticks, &ip->system_time);
-            clock_ticks2time(g_mono_clock, g_sched->idle_ticks, &ip->idle_time);
+            const int sps = preempt_disable();
+            sched_charge_running_np(g_sched);
+            const uint64_t usr_cycles = g_sched->usr_cycles;
+            const uint64_t sys_cycles = g_sched->sys_cycles;
+            const uint64_t idle_cycles = g_sched->idle_cycles;
+            preempt_restore(sps);
+
+            clock_cycles2time(g_mono_clock, usr_cycles, &ip->user_time);
+            clock_cycles2time(g_mono_clock, sys_cycles, &ip->system_time);
+            clock_cycles2time(g_mono_clock, idle_cycles, &ip->idle_time);
+            break;
+        }
+
+        case CPU_INFO_SCHED_STATS: {
+            cpu_sched_stats_info_t* ip = pa->info;
+
+            ip->cycle_ns = g_mono_clock->ns_per_cia_cycle;
+
+            const int sps = preempt_disable();
+            memcpy(ip->qos, g_sched->stats.qos, sizeof(ip->qos));
+            preempt_restore(sps);
             break;
         }
 
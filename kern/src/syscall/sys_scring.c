@@ -0,0 +1,60 @@
+//
+//  sys_scring.c
+//  kernel
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#include "syscalldecls.h"
+#include <string.h>
+#include <kpi/scring.h>
+
+
+// The argument block that we hand to a system call. Mirrors the layout of the
+// arguments of a trapped system call.
+typedef struct scring_args {
+    syscall_args_t  h;
+    intptr_t        args[SCRING_MAX_ARGS];
+} scring_args_t;
+
+
+SYSCALL_2(scring_enter, scring_t* _Nonnull ring, int* _Nonnull pOutCount)
+{
+    scring_t* ring = pa->ring;
+    const unsigned int mask = ring->mask;
+    unsigned int sq_head = ring->sq_head;
+    unsigned int cq_tail = ring->cq_tail;
+    scring_args_t a;
+    int count = 0;
+
+    if (mask >= SCRING_MAX_ENTRIES || (mask & (mask + 1)) != 0) {
+        return EINVAL;
+    }
+
+
+    a.h.dummy = 0;
+    while (sq_head != ring->sq_tail && (cq_tail - ring->cq_head) <= mask) {
+        const scring_sqe_t* sqe = &ring->sqes[sq_head & mask];
+        scring_cqe_t* cqe = &ring->cqes[cq_tail & mask];
+
+        // Leave the rest of the queue alone if we've been asked to abort. The
+        // system call epilog will take care of the abort.
+        if (vcpu_testabort_np() != EOK) {
+            break;
+        }
+
+        a.h.scno = sqe->scno;
+        memcpy(a.args, sqe->args, sizeof(a.args));
+
+        cqe->udata = sqe->udata;
+        cqe->result = _syscall_ring_invoke(vp, &a.h);
+
+        ring->sq_head = ++sq_head;
+        ring->cq_tail = ++cq_tail;
+        count++;
+    }
+
+    *(pa->pOutCount) = count;
+    return EOK;
+}
@@ -15,6 +15,7 @@
 #include <kpi/signal.h>
 #include <kpi/synch.h>
 #include <sched/mtx.h>
+#include <sched/pi.h>
 #include <sched/waitqueue.h>
 
 
@@ -44,7 +45,7 @@
 
 struct woa_hdr {
     deque_node_t        qe;
-    struct waitqueue    wq;
+    pi_lock_t           pi;         // pi.owner is the vcpu that holds the user space mutex at 'key'; NULL if not known
     void*               key;
     int                 use_count;
 };
@@ -86,7 +87,7 @@ static woa_hdr_t _Nullable _acquire_woa_for_addr(void* key, bool bAllocIfNeeded)
 
 
         wp->qe = DEQUE_NODE_INIT;
-        wp->wq = WAITQUEUE_INIT;
+        wp->pi = PI_LOCK_INIT;
         wp->key = key;
         wp->use_count = 0;
 
@@ -108,6 +109,12 @@ static void _relinquish_woa(woa_hdr_t _Nonnull wp)
 
     wp->use_count--;
     if (wp->use_count == 0) {
+        // no one is waiting anymore. Stop lending priority to the owner
+        const int sps = preempt_disable();
+        pi_setowner_np(&wp->pi, NULL);
+        preempt_restore(sps);
+
+
         // remove the ww from the hash table
         deque_remove(&g_woa_table[hash_ptr(wp->key) & WOA_HASH_CHAIN_MASK], &wp->qe);
 
@@ -119,7 +126,7 @@ static void _relinquish_woa(woa_hdr_t _Nonnull wp)
             g_woa_cache_size++;
         }
         else {
-            wq_deinit(&wp->wq);
+            wq_deinit(&wp->pi.wq);
             kfree(wp);
         }
     }
@@ -138,7 +145,42 @@ SYSCALL_4(woa_wait, volatile atomic_int* _Nonnull addr, int expected, int flags,
     
 
     const ticks_t deadline = (pa->wtp) ? wq_calc_deadline(g_mono_clock, pa->flags, pa->wtp) : TICKS_MAX;
-    err = wq_wait_addr(&wp->wq, pa->addr, pa->expected, 0, deadline);
+    err = wq_wait_addr(&wp->pi.wq, pa->addr, pa->expected, 0, deadline);
+
+    _relinquish_woa(wp);
+
+    return err;
+}
+
+SYSCALL_5(woa_wait_pi, volatile atomic_int* _Nonnull addr, int expected, vcpuid_t owner, int flags, const nanotime_t* _Nullable wtp)
+{
+    decl_try_err();
+    ProcessRef pp = vp->proc;
+    woa_hdr_t wp = _acquire_woa_for_addr(pa->addr, true);
+    if (wp == NULL) {
+        return ENOMEM;
+    }
+
+
+    // Record the owner of the mutex. We look it up and link it to the mutex
+    // while holding the process lock to ensure that it can not be relinquished
+    // before it is linked. See Process_RelinquishCurrentVirtualProcessor()
+    // User space encodes the owner in the mutex state. Only accept the owner
+    // if the state is still the one that the caller read the owner from.
+    // Otherwise the mutex has changed hands in the meantime and 'owner' may
+    // be stale. pi_wait_addr() returns right away in this case.
+    mtx_lock(&pp->mtx);
+    vcpu_t ovp = (pa->owner != vp->id) ? _proc_vcpu_for_id(pp, pa->owner) : NULL;
+    const int sps = preempt_disable();
+    if (atomic_int_load(pa->addr) == pa->expected) {
+        pi_setowner_np(&wp->pi, ovp);
+    }
+    preempt_restore(sps);
+    mtx_unlock(&pp->mtx);
+
+
+    const ticks_t deadline = (pa->wtp) ? wq_calc_deadline(g_mono_clock, pa->flags, pa->wtp) : TICKS_MAX;
+    err = pi_wait_addr(&wp->pi, pa->addr, pa->expected, 0, deadline);
 
     _relinquish_woa(wp);
 
@@ -153,7 +195,15 @@ SYSCALL_2(woa_wakeup, volatile atomic_int* _Nonnull addr, int flags)
 
     woa_hdr_t wp = _acquire_woa_for_addr(pa->addr, false);
     if (wp) {
-        wq_wakeup(&wp->wq, pa->flags, 0);
+        const int sps = preempt_disable();
+        // The owner of a priority inheritance mutex wakes up a waiter when it
+        // releases the mutex. It stops inheriting priority through it now
+        if (wp->pi.owner == vp) {
+            pi_setowner_np(&wp->pi, NULL);
+        }
+        wq_wakeup_np(&wp->pi.wq, pa->flags, 0);
+        preempt_restore(sps);
+
         _relinquish_woa(wp);
     }
 
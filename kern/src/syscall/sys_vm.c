@@ -19,3 +19,8 @@ SYSCALL_2(vm_allocate, size_t nbytes, void * _Nullable * _Nonnull pOutMem)
 
     return AddressSpace_Allocate(&(vp->proc->addr_space), pa->nbytes, pa->pOutMem);
 }
+
+SYSCALL_2(vm_deallocate, void* _Nonnull ptr, size_t nbytes)
+{
+    return AddressSpace_Deallocate(&(vp->proc->addr_space), pa->ptr, pa->nbytes);
+}
@@ -19,6 +19,7 @@ typedef intptr_t (*syscall_func_t)(vcpu_t _Nonnull vp, void* _Nonnull args);
 typedef struct syscall_entry {
     syscall_func_t  f;
     char            ret_type;   // return type
+    char            ring_ok;    // may be queued on a system call ring (see kpi/scring.h)
 } syscall_entry_t;
 
 
@@ -34,7 +35,10 @@ extern intptr_t _SYSCALL_##__name(vcpu_t _Nonnull vp, void* _Nonnull args)
 
 
 #define SYSCALL_ENTRY(__name, __flags) \
-{(syscall_func_t)_SYSCALL_##__name, __flags}
+{(syscall_func_t)_SYSCALL_##__name, __flags, 0}
+
+#define SYSCALL_RING_ENTRY(__name, __flags) \
+{(syscall_func_t)_SYSCALL_##__name, __flags, 1}
 
 
 typedef struct syscall_args {
@@ -43,6 +47,12 @@ typedef struct syscall_args {
 } syscall_args_t;
 
 
+// Invokes the system call 'args->scno' on behalf of a system call ring. Returns
+// ENOSYS if the system call does not exist or may not be queued on a ring.
+// Does not run the system call epilog.
+extern intptr_t _syscall_ring_invoke(vcpu_t _Nonnull vp, const syscall_args_t* _Nonnull args);
+
+
 #define SYSCALL_0(__name) \
 struct args##__name { \
     syscall_args_t  h; \
@@ -23,6 +23,7 @@ SYSCALL_REF(excpt_sethandler);
 
 SYSCALL_REF(host_info);
 SYSCALL_REF(host_processes);
+SYSCALL_REF(host_procsnap);
 SYSCALL_REF(host_filesystems);
 SYSCALL_REF(host_cpus);
 
@@ -59,9 +60,12 @@ SYSCALL_REF(fd_setflags);
 SYSCALL_REF(fd_dup);
 SYSCALL_REF(fd_dup_to);
 SYSCALL_REF(fd_cntl);
+SYSCALL_REF(fd_sync);
 
 SYSCALL_REF(pipe_create);
 
+SYSCALL_REF(scring_enter);
+
 SYSCALL_REF(proc_exit);
 SYSCALL_REF(proc_spawn);
 SYSCALL_REF(proc_property);
@@ -77,6 +81,7 @@ SYSCALL_REF(proc_self);
 
 
 SYSCALL_REF(vm_allocate);
+SYSCALL_REF(vm_deallocate);
 
 SYSCALL_REF(sig_wait);
 SYSCALL_REF(sig_pending);
@@ -86,6 +91,7 @@ SYSCALL_REF(sig_urgent);
 
 SYSCALL_REF(woa_wait);
 SYSCALL_REF(woa_wakeup);
+SYSCALL_REF(woa_wait_pi);
 
 SYSCALL_REF(vcpu_errno);
 SYSCALL_REF(vcpu_getdata);
@@ -104,11 +110,11 @@ SYSCALL_REF(vcpu_info);
 
 ////////////////////////////////////////////////////////////////////////////////
 
-#define SYSCALL_COUNT   80
+#define SYSCALL_COUNT   81
 
 static const syscall_entry_t g_syscall_table[SYSCALL_COUNT] = {
-    SYSCALL_ENTRY(fd_read, SC_ERRNO),
-    SYSCALL_ENTRY(fd_write, SC_ERRNO),
+    SYSCALL_RING_ENTRY(fd_read, SC_ERRNO),
+    SYSCALL_RING_ENTRY(fd_write, SC_ERRNO),
     SYSCALL_ENTRY(clock_sleep, SC_ERRNO),
     SYSCALL_ENTRY(vm_allocate, SC_ERRNO),
     SYSCALL_ENTRY(proc_exit, SC_NORETURN),
@@ -116,28 +122,28 @@ static const syscall_entry_t g_syscall_table[SYSCALL_COUNT] = {
     SYSCALL_ENTRY(host_cpus, SC_ERRNO),
     SYSCALL_ENTRY(proc_vcpus, SC_ERRNO),
     SYSCALL_ENTRY(woa_wait, SC_ERRNO),
-    SYSCALL_ENTRY(fs_open, SC_ERRNO),
-    SYSCALL_ENTRY(fd_close, SC_ERRNO),
+    SYSCALL_RING_ENTRY(fs_open, SC_ERRNO),
+    SYSCALL_RING_ENTRY(fd_close, SC_ERRNO),
     SYSCALL_ENTRY(proc_wait, SC_ERRNO),
-    SYSCALL_ENTRY(fd_seek, SC_ERRNO),
+    SYSCALL_RING_ENTRY(fd_seek, SC_ERRNO),
     SYSCALL_ENTRY(proc_property, SC_ERRNO),
     SYSCALL_ENTRY(proc_setcwd, SC_ERRNO),
     SYSCALL_ENTRY(host_processes, SC_ERRNO),
     SYSCALL_ENTRY(proc_setumask, SC_VOID),
-    SYSCALL_ENTRY(fs_create_directory, SC_ERRNO),
-    SYSCALL_ENTRY(fs_attr, SC_ERRNO),
-    SYSCALL_ENTRY(fs_open_directory, SC_ERRNO),
-    SYSCALL_ENTRY(fs_access, SC_ERRNO),
-    SYSCALL_ENTRY(fd_attr, SC_ERRNO),
-    SYSCALL_ENTRY(fs_unlink, SC_ERRNO),
-    SYSCALL_ENTRY(fs_rename, SC_ERRNO),
+    SYSCALL_RING_ENTRY(fs_create_directory, SC_ERRNO),
+    SYSCALL_RING_ENTRY(fs_attr, SC_ERRNO),
+    SYSCALL_RING_ENTRY(fs_open_directory, SC_ERRNO),
+    SYSCALL_RING_ENTRY(fs_access, SC_ERRNO),
+    SYSCALL_RING_ENTRY(fd_attr, SC_ERRNO),
+    SYSCALL_RING_ENTRY(fs_unlink, SC_ERRNO),
+    SYSCALL_RING_ENTRY(fs_rename, SC_ERRNO),
     SYSCALL_ENTRY(fd_cntl, SC_ERRNO),
-    SYSCALL_ENTRY(fs_truncate, SC_ERRNO),
-    SYSCALL_ENTRY(fd_truncate, SC_ERRNO),
-    SYSCALL_ENTRY(fs_create_file, SC_ERRNO),
+    SYSCALL_RING_ENTRY(fs_truncate, SC_ERRNO),
+    SYSCALL_RING_ENTRY(fd_truncate, SC_ERRNO),
+    SYSCALL_RING_ENTRY(fs_create_file, SC_ERRNO),
     SYSCALL_ENTRY(pipe_create, SC_ERRNO),
     SYSCALL_ENTRY(cpu_info, SC_ERRNO),
-    SYSCALL_ENTRY(clock_time, SC_ERRNO),
+    SYSCALL_RING_ENTRY(clock_time, SC_ERRNO),
     SYSCALL_ENTRY(fs_mount, SC_ERRNO),
     SYSCALL_ENTRY(fs_unmount, SC_ERRNO),
     SYSCALL_ENTRY(host_info, SC_ERRNO),
@@ -145,20 +151,20 @@ static const syscall_entry_t g_syscall_table[SYSCALL_COUNT] = {
     SYSCALL_ENTRY(coninit, SC_ERRNO),
     SYSCALL_ENTRY(fs_property, SC_ERRNO),
     SYSCALL_ENTRY(vcpu_errno, SC_PTR),
-    SYSCALL_ENTRY(fs_setowner, SC_ERRNO),
-    SYSCALL_ENTRY(fd_setflags, SC_ERRNO),
-    SYSCALL_ENTRY(fs_setperms, SC_ERRNO),
-    SYSCALL_ENTRY(fs_settimes, SC_ERRNO),
+    SYSCALL_RING_ENTRY(fs_setowner, SC_ERRNO),
+    SYSCALL_RING_ENTRY(fd_setflags, SC_ERRNO),
+    SYSCALL_RING_ENTRY(fs_setperms, SC_ERRNO),
+    SYSCALL_RING_ENTRY(fs_settimes, SC_ERRNO),
     SYSCALL_ENTRY(vcpu_yield, SC_VOID),
-    SYSCALL_ENTRY(fd_type, SC_ERRNO),
-    SYSCALL_ENTRY(nosys, SC_ERRNO),             // UNUSED
-    SYSCALL_ENTRY(nosys, SC_ERRNO),             // UNUSED
-    SYSCALL_ENTRY(nosys, SC_ERRNO),             // UNUSED
+    SYSCALL_RING_ENTRY(fd_type, SC_ERRNO),
+    SYSCALL_RING_ENTRY(fd_sync, SC_ERRNO),
+    SYSCALL_ENTRY(scring_enter, SC_ERRNO),
+    SYSCALL_ENTRY(vm_deallocate, SC_ERRNO),
     SYSCALL_ENTRY(proc_info, SC_ERRNO),
     SYSCALL_ENTRY(sig_route, SC_ERRNO),
     SYSCALL_ENTRY(vcpu_getdata, SC_PTR),
     SYSCALL_ENTRY(vcpu_setdata, SC_INT),
-    SYSCALL_ENTRY(nosys, SC_ERRNO),             // UNUSED
+    SYSCALL_ENTRY(host_procsnap, SC_ERRNO),
     SYSCALL_ENTRY(sig_wait, SC_ERRNO),
     SYSCALL_ENTRY(nosys, SC_ERRNO),             // UNUSED
     SYSCALL_ENTRY(sig_pending, SC_ERRNO),
@@ -177,26 +183,41 @@ static const syscall_entry_t g_syscall_table[SYSCALL_COUNT] = {
     SYSCALL_ENTRY(vcpu_setpolicy, SC_ERRNO),
     SYSCALL_ENTRY(clock_info, SC_ERRNO),
     SYSCALL_ENTRY(vcpu_info, SC_ERRNO),
-    SYSCALL_ENTRY(nullsys, SC_ERRNO),
+    SYSCALL_RING_ENTRY(nullsys, SC_ERRNO),
     SYSCALL_ENTRY(proc_schedparam, SC_ERRNO),
     SYSCALL_ENTRY(proc_setschedparam, SC_ERRNO),
     SYSCALL_ENTRY(vcpu_state, SC_ERRNO),
     SYSCALL_ENTRY(vcpu_setstate, SC_ERRNO),
     SYSCALL_ENTRY(fs_setlabel, SC_ERRNO),
     SYSCALL_ENTRY(woa_wakeup, SC_ERRNO),
-    SYSCALL_ENTRY(fd_flags, SC_ERRNO),
-    SYSCALL_ENTRY(fd_dup, SC_ERRNO),
+    SYSCALL_RING_ENTRY(fd_flags, SC_ERRNO),
+    SYSCALL_RING_ENTRY(fd_dup, SC_ERRNO),
     SYSCALL_ENTRY(proc_self, SC_INT),
+    SYSCALL_ENTRY(woa_wait_pi, SC_ERRNO),
 };
 
 ////////////////////////////////////////////////////////////////////////////////
 
+intptr_t _syscall_ring_invoke(vcpu_t _Nonnull vp, const syscall_args_t* _Nonnull args)
+{
+    const unsigned int scno = args->scno;
+
+    if (scno < SYSCALL_COUNT && g_syscall_table[scno].ring_ok) {
+        return g_syscall_table[scno].f(vp, (void*)args);
+    }
+    else {
+        return ENOSYS;
+    }
+}
+
 void _syscall_handler(vcpu_t _Nonnull vp, const syscall_args_t* _Nonnull args)
 {
     const unsigned int scno = args->scno;
     intptr_t r;
     char rty;
 
+    sched_on_syscall(g_sched, true);
+
     if (scno < SYSCALL_COUNT) {
         const syscall_entry_t* sc = &g_syscall_table[scno];
 
@@ -235,4 +256,6 @@ void _syscall_handler(vcpu_t _Nonnull vp, const syscall_args_t* _Nonnull args)
             // no return value
             break;
     }
+
+    sched_on_syscall(g_sched, false);
 }
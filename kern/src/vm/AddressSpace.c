@@ -10,24 +10,22 @@
 #include <hal/cpu.h>
 #include <kern/kalloc.h>
 #include <kern/kernlib.h>
+#include <string.h>
 
 
 typedef struct MemEntry {
-    char* _Nullable mem;
+    char* _Nonnull  mem;
     size_t          size;
 } MemEntry;
 
-#define MEM_BLOCKS_CAPACITY 8
-typedef struct MemBlocks {
-    queue_node_t    node;
-    size_t          count;  // Number of entries in use
-    MemEntry        blocks[MEM_BLOCKS_CAPACITY];
-} MemBlocks;
+#define MEM_ENTRIES_INITIAL_CAPACITY    8
 
 
 void AddressSpace_Init(AddressSpaceRef _Nonnull self)
 {
-    self->mblocks = QUEUE_INIT;
+    self->mentries = NULL;
+    self->mcount = 0;
+    self->mcapacity = 0;
     self->virt_size = 0;
     mtx_init(&self->mtx);
 }
@@ -47,6 +45,51 @@ size_t AddressSpace_GetVirtualSize(AddressSpaceRef _Nonnull self)
     return vsize;
 }
 
+// Returns the index of the first memory entry whose address is >= 'p'. Returns
+// 'mcount' if all entries are below 'p'.
+static size_t _AddressSpace_LowerBound(AddressSpaceRef _Nonnull _Locked self, const char* _Nonnull p)
+{
+    size_t lo = 0;
+    size_t hi = self->mcount;
+
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+
+        if (self->mentries[mid].mem < p) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+static errno_t _AddressSpace_EnsureCapacity(AddressSpaceRef _Nonnull _Locked self)
+{
+    decl_try_err();
+    MemEntry* new_entries;
+
+    if (self->mcount < self->mcapacity) {
+        return EOK;
+    }
+
+    const size_t new_capacity = (self->mcapacity > 0) ? self->mcapacity * 2 : MEM_ENTRIES_INITIAL_CAPACITY;
+    err = kalloc(new_capacity * sizeof(MemEntry), (void**)&new_entries);
+    if (err == EOK) {
+        if (self->mentries) {
+            memcpy(new_entries, self->mentries, self->mcount * sizeof(MemEntry));
+            kfree(self->mentries);
+        }
+
+        self->mentries = new_entries;
+        self->mcapacity = new_capacity;
+    }
+
+    return err;
+}
+
 // Allocates more address space to the calling process. The address space is
 // expanded by 'nbytes' bytes. A pointer to the first byte in the newly allocated
 // address space portion is return in 'pOutMem'. 'pOutMem' is set to NULL and a
@@ -55,7 +98,6 @@ size_t AddressSpace_GetVirtualSize(AddressSpaceRef _Nonnull self)
 errno_t AddressSpace_Allocate(AddressSpaceRef _Nonnull self, ssize_t nbytes, void* _Nullable * _Nonnull pOutMem)
 {
     decl_try_err();
-    MemBlocks* bp = NULL;
     char* p = NULL;
 
     if (nbytes == 0) {
@@ -68,27 +110,21 @@ errno_t AddressSpace_Allocate(AddressSpaceRef _Nonnull self, ssize_t nbytes, voi
 
     mtx_lock(&self->mtx);
 
-    // We don't need to free the MemBlocks if the allocation of the memory block
-    // below fails because we can always keep it around for the next allocation
-    // request
-    if (queue_empty(&self->mblocks)
-        || ((MemBlocks*)self->mblocks.last)->count == MEM_BLOCKS_CAPACITY) {
-        try(kalloc_cleared(sizeof(MemBlocks), (void**) &bp));
-        bp->node = QUEUE_NODE_INIT;
-        queue_add_last(&self->mblocks, &bp->node);
-    } else {
-        bp = (MemBlocks*)self->mblocks.last;
-    }
+    // Make room for the new entry first. We keep the extra capacity around if
+    // the allocation of the memory block below fails
+    try(_AddressSpace_EnsureCapacity(self));
 
 
     // Allocate the memory block
-    try(kalloc(nbytes, (void**) &p));
+    try(kalloc_tagged(nbytes, KALLOC_TAG_PROCESS, (void**) &p));
 
 
-    // Add the memory block to our list
-    bp->blocks[bp->count].mem = p;
-    bp->blocks[bp->count].size = nbytes;
-    bp->count++;
+    // Insert the memory block in address order
+    const size_t idx = _AddressSpace_LowerBound(self, p);
+    memmove(&self->mentries[idx + 1], &self->mentries[idx], (self->mcount - idx) * sizeof(MemEntry));
+    self->mentries[idx].mem = p;
+    self->mentries[idx].size = nbytes;
+    self->mcount++;
     self->virt_size += nbytes;
 
 catch:
@@ -98,26 +134,40 @@ catch:
     return err;
 }
 
-static void _AddressSpace_UnmapAll(AddressSpaceRef _Nonnull _Locked self)
+errno_t AddressSpace_Deallocate(AddressSpaceRef _Nonnull self, void* _Nonnull ptr, size_t nbytes)
 {
-    MemBlocks* cp = (MemBlocks*)self->mblocks.first;
+    decl_try_err();
+    char* p = NULL;
 
-    while (cp) {
-        MemBlocks* np = (MemBlocks*)cp->node.next;
+    mtx_lock(&self->mtx);
 
-        for (size_t i = 0; i < cp->count; i++) {
-            kfree(cp->blocks[i].mem);
-            cp->blocks[i].mem = NULL;
-            cp->blocks[i].size = 0;
-        }
+    const size_t idx = _AddressSpace_LowerBound(self, ptr);
+    if (idx < self->mcount && self->mentries[idx].mem == ptr && self->mentries[idx].size == nbytes) {
+        p = self->mentries[idx].mem;
+        memmove(&self->mentries[idx], &self->mentries[idx + 1], (self->mcount - idx - 1) * sizeof(MemEntry));
+        self->mcount--;
+        self->virt_size -= nbytes;
+    }
+    else {
+        err = EINVAL;
+    }
+
+    mtx_unlock(&self->mtx);
 
-        cp->node = QUEUE_NODE_INIT;
-        kfree(cp);
+    kfree(p);
+    return err;
+}
 
-        cp = np;
+static void _AddressSpace_UnmapAll(AddressSpaceRef _Nonnull _Locked self)
+{
+    for (size_t i = 0; i < self->mcount; i++) {
+        kfree(self->mentries[i].mem);
     }
+    kfree(self->mentries);
 
-    self->mblocks = QUEUE_INIT;
+    self->mentries = NULL;
+    self->mcount = 0;
+    self->mcapacity = 0;
     self->virt_size = 0;
 }
 
@@ -133,10 +183,14 @@ void AddressSpace_AdoptMappingsFrom(AddressSpaceRef _Nonnull self, AddressSpaceR
     mtx_lock(&self->mtx);
     _AddressSpace_UnmapAll(self);
 
-    self->mblocks = other->mblocks;
+    self->mentries = other->mentries;
+    self->mcount = other->mcount;
+    self->mcapacity = other->mcapacity;
     self->virt_size = other->virt_size;
 
-    other->mblocks = QUEUE_INIT;
+    other->mentries = NULL;
+    other->mcount = 0;
+    other->mcapacity = 0;
     other->virt_size = 0;
     mtx_unlock(&self->mtx);
 }
@@ -9,17 +9,20 @@
 #ifndef AddressSpace_h
 #define AddressSpace_h
 
-#include <ext/queue.h>
 #include <ext/try.h>
 #include <kobj/AnyRefs.h>
 #include <kpi/types.h>
 #include <sched/mtx.h>
 
 
+struct MemEntry;
+
 typedef struct AddressSpace {
-    mtx_t                   mtx;
-    queue_t/*<MemBlocks>*/  mblocks;
-    size_t                  virt_size;
+    mtx_t                           mtx;
+    struct MemEntry* _Nullable      mentries;   // Memory blocks sorted by ascending address
+    size_t                          mcount;     // Number of memory blocks
+    size_t                          mcapacity;  // Number of entries 'mentries' can hold
+    size_t                          virt_size;
 } AddressSpace;
 
 
@@ -31,6 +34,12 @@ extern size_t AddressSpace_GetVirtualSize(AddressSpaceRef _Nonnull self);
 // Allocates a memory block of size 'nbytes' and adds it to the address space.
 extern errno_t AddressSpace_Allocate(AddressSpaceRef _Nonnull self, ssize_t nbytes, void* _Nullable * _Nonnull pOutMem);
 
+// Removes the memory block at 'ptr' from the address space and frees it. 'ptr'
+// must be the address of a memory block that was returned by
+// AddressSpace_Allocate() and 'nbytes' must be its size. Returns EINVAL if this
+// is not the case.
+extern errno_t AddressSpace_Deallocate(AddressSpaceRef _Nonnull self, void* _Nonnull ptr, size_t nbytes);
+
 // Removes and frees all mappings from the address space. The result is a
 // completely empty address space that owns no memory.
 extern void AddressSpace_UnmapAll(AddressSpaceRef _Nonnull self);
@@ -107,11 +107,11 @@ static void run_proc_relinquish(run_proc_t* _Nullable rp)
 }
 
 
-static int state_from_basic_info(const proc_basic_info_t* _Nonnull ip)
+static int state_from_snapshot(const proc_snapshot_t* _Nonnull sp)
 {
-    switch (ip->run_state) {
+    switch (sp->run_state) {
         case PROC_STATE_RUNNING:
-            return (ip->vcpu_waiting_count == ip->vcpu_count) ? RUN_PROC_SLEEPING : RUN_PROC_RUNNING;
+            return (sp->vcpu_waiting_count == sp->vcpu_count) ? RUN_PROC_SLEEPING : RUN_PROC_RUNNING;
 
         case PROC_STATE_STOPPED:
             return RUN_PROC_STOPPED;
@@ -124,37 +124,27 @@ static int state_from_basic_info(const proc_basic_info_t* _Nonnull ip)
     }
 }
 
-static void run_proc_sample(pid_t pid)
+static void run_proc_sample(const proc_snapshot_t* _Nonnull sp)
 {
-    static proc_basic_info_t basic;
-    static proc_times_info_t times;
-
-    run_proc_t* rp = run_proc_acquire(pid);
+    run_proc_t* rp = run_proc_acquire(sp->pid);
     if (rp == NULL) {
         return;
     }
 
 
-    errno = 0;
-    proc_info(pid, PROC_INFO_BASIC, &basic);
-    proc_info(pid, PROC_INFO_TIMES, &times);
-
-    if (errno != 0) {
-        run_proc_relinquish(rp);
-        return;
-    }
-
-
-    rp->pgrp = basic.pgrp;
-    rp->ppid = basic.ppid;
-    rp->sid = basic.sid;
-    rp->uid = basic.uid;
-    rp->vcpu_count = basic.vcpu_count;
-    nanotime_sub(&rp->run_time, &g_info.current_time, &times.creation_time);
-    rp->vm_size = basic.vm_size;
-    rp->state = state_from_basic_info(&basic);
+    rp->pgrp = sp->pgrp;
+    rp->ppid = sp->ppid;
+    rp->sid = sp->sid;
+    rp->uid = sp->uid;
+    rp->vcpu_count = sp->vcpu_count;
+    nanotime_sub(&rp->run_time, &g_info.current_time, &sp->creation_time);
+    rp->vm_size = sp->vm_size;
+    rp->state = state_from_snapshot(sp);
     rp->flags.alive = 1;
-    if (proc_property(pid, PROC_PROP_NAME, rp->name, sizeof(rp->name)) != 0) {
+    if (sp->name[0] != '\0') {
+        strcpy(rp->name, sp->name);
+    }
+    else {
         strcpy(rp->name, "??");
     }
 
@@ -166,45 +156,55 @@ static void run_proc_sample(pid_t pid)
     else if (rp->state == RUN_PROC_SLEEPING || rp->state == RUN_PROC_STOPPED) {
         g_info.slp_proc_count++;
     }
-    g_info.vcpu_count += basic.vcpu_count;
+    g_info.vcpu_count += sp->vcpu_count;
 }
 
-static const pid_t* _Nonnull get_all_proc_pids(void)
+static const proc_snapshot_t* _Nullable get_all_proc_snapshots(size_t* _Nonnull pOutCount)
 {
-#define INIT_PID_BUF_SIZE   128
-    static pid_t* pid_buf = NULL;
-    static size_t pid_buf_size = 0;
+#define INIT_SNAP_BUF_SIZE  32
+    static proc_snapshot_t* snap_buf = NULL;
+    static size_t snap_buf_size = 0;
 
-    if (pid_buf == NULL) {
-        pid_buf = malloc(INIT_PID_BUF_SIZE * sizeof(pid_t));
-        if (pid_buf == NULL) {
+    if (snap_buf == NULL) {
+        snap_buf = malloc(INIT_SNAP_BUF_SIZE * sizeof(proc_snapshot_t));
+        if (snap_buf == NULL) {
             return NULL;
         }
 
-        pid_buf_size = INIT_PID_BUF_SIZE;
+        snap_buf_size = INIT_SNAP_BUF_SIZE;
     }
 
-    while (host_processes(pid_buf, pid_buf_size) == 1) {
-        size_t new_pid_buf_size = pid_buf_size * 2;
-        pid_t* new_pid_buf = realloc(pid_buf, new_pid_buf_size * sizeof(pid_t));
+    for (;;) {
+        const int r = host_procsnap(snap_buf, snap_buf_size, pOutCount);
 
-        if (new_pid_buf == NULL) {
+        if (r == 0) {
+            break;
+        }
+        if (r < 0) {
+            return NULL;
+        }
+
+
+        size_t new_snap_buf_size = snap_buf_size * 2;
+        proc_snapshot_t* new_snap_buf = realloc(snap_buf, new_snap_buf_size * sizeof(proc_snapshot_t));
+
+        if (new_snap_buf == NULL) {
             return NULL;
         }
 
-        pid_buf = new_pid_buf;
-        pid_buf_size = new_pid_buf_size;
+        snap_buf = new_snap_buf;
+        snap_buf_size = new_snap_buf_size;
     }
 
-    return pid_buf;
+    return snap_buf;
 }
 
 void run_procs_sample(void)
 {
-    const pid_t* pids = get_all_proc_pids();
-    size_t i;
+    size_t i, nsnaps;
+    const proc_snapshot_t* snaps = get_all_proc_snapshots(&nsnaps);
 
-    if (pids == NULL) {
+    if (snaps == NULL) {
         return;
     }
 
@@ -264,9 +264,8 @@ void run_procs_sample(void)
         it->flags.alive = 0;
     );
 
-    i = 0;
-    while (pids[i] > 0) {
-        run_proc_sample(pids[i++]);
+    for (i = 0; i < nsnaps; i++) {
+        run_proc_sample(&snaps[i]);
     }
 
     deque_for_each(&g_run_procs, struct run_proc, it,
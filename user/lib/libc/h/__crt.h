@@ -10,6 +10,7 @@
 #define ___CRT_H 1
 
 #include <_cmndef.h>
+#include <stddef.h>
 #include <stdint.h>
 
 __CPP_BEGIN
@@ -56,6 +57,15 @@ extern unsigned long long _lshuint64(unsigned long long x, int s);
 extern unsigned long long _rshuint64(unsigned long long x, int s);
 
 
+extern void* _Nonnull _memcpy_020(void* _Nonnull _Restrict dst, const void* _Nonnull _Restrict src, size_t count);
+extern void* _Nonnull _memcpy_040(void* _Nonnull _Restrict dst, const void* _Nonnull _Restrict src, size_t count);
+
+extern void* _Nonnull _memmove_020(void* _Nonnull dst, const void* _Nonnull src, size_t count);
+extern void* _Nonnull _memmove_040(void* _Nonnull dst, const void* _Nonnull src, size_t count);
+
+extern void* _Nonnull _memset_020(void* _Nonnull dst, int c, size_t count);
+
+
 extern double _uint64toflt64(unsigned long long x);
 extern double _sint64toflt64(long long x);
 
@@ -0,0 +1,146 @@
+//
+//  __tlsf.h
+//  libc, libsc
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#ifndef __TLSF_H
+#define __TLSF_H 1
+
+#include <_cmndef.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#define __ERRNO_T_WANTED 1
+#include <kpi/_errno.h>
+
+__CPP_BEGIN
+
+struct tlsf;
+typedef struct tlsf* tlsf_t;
+
+#ifndef _MEM_DESC_DEFINED
+#define _MEM_DESC_DEFINED 1
+// A memory descriptor describes a contiguous range of RAM that should be managed
+// by the allocator.
+typedef struct mem_desc_t {
+    char* _Nonnull  lower;
+    char* _Nonnull  upper;
+} mem_desc_t;
+#endif
+
+
+// Errors passed to the mem_error function
+#define MERR_CORRUPTION     1
+#define MERR_DOUBLE_FREE    2
+
+
+// Callback that is invoked by the allocator if it needs more backing store.
+// Should return true on success and false on failure. Failure will result in a
+// ENOMEM error.
+typedef bool (*tlsf_grow_func_t)(tlsf_t _Nonnull allocator, size_t minByteCount);
+
+// Callback that is invoked by the allocator when a memory region that was added
+// with __tlsf_add_memregion() has become completely free. 'md' is the memory
+// region with its bounds aligned to the allocator's word size. Should return
+// true if the memory region was handed back to its owner and false if the
+// allocator should keep it.
+typedef bool (*tlsf_release_func_t)(tlsf_t _Nonnull allocator, const mem_desc_t* _Nonnull md);
+
+// Invoked when the memory allocator has detected some kind of heap corruption
+// or severe API misuse.
+typedef void (*tlsf_error_func_t)(int err, const char* _Nonnull funcName, void* _Nullable ptr);
+
+// Invoked by __tlsf_visit() for every allocated block. 'size' is the net size
+// of the block and 'site' is the allocation site that was passed to
+// __tlsf_alloc_site() or NULL.
+typedef void (*tlsf_visit_func_t)(void* _Nullable ctx, void* _Nonnull ptr, size_t size, const char* _Nullable site);
+
+
+// Number of request size classes that the allocator keeps statistics for.
+// Class i counts requests of [2^i, 2^(i+1)) bytes and the last class counts
+// all requests of 2^(TLSF_SIZE_CLASS_COUNT - 1) bytes and more.
+#define TLSF_SIZE_CLASS_COUNT   16
+
+typedef struct tlsf_info {
+    size_t      used_bytes;         // Gross size of all allocated blocks
+    size_t      peak_used_bytes;    // Highest value of 'used_bytes' so far
+    size_t      free_bytes;         // Gross size of all free blocks
+    size_t      largest_free_size;  // Biggest request that can be served without growing the heap
+    size_t      used_block_count;
+    size_t      free_block_count;
+    int         region_count;
+    uint32_t    allocs;
+    uint32_t    frees;
+    uint32_t    allocs_per_class[TLSF_SIZE_CLASS_COUNT];
+} tlsf_info_t;
+
+
+// A two-level segregated fit allocator. Free blocks are kept on size class
+// lists that are indexed by a first level (power of 2) and a second level
+// (linear subdivision of the power of 2 range). Allocating and freeing a block
+// takes constant time independent of the number of free blocks. Every block
+// carries a header and a trailer with a check pattern that is verified whenever
+// the allocator touches the block.
+//
+// The allocator stores its own state at the bottom of the memory region that is
+// passed to __tlsf_create(). This region is never released.
+extern tlsf_t _Nullable __tlsf_create(const mem_desc_t* _Nonnull md, tlsf_grow_func_t _Nullable growFunc, tlsf_release_func_t _Nullable releaseFunc, tlsf_error_func_t _Nonnull errFunc);
+
+// Adds the given memory region to the allocator's available memory pool.
+extern errno_t __tlsf_add_memregion(tlsf_t _Nonnull self, const mem_desc_t* _Nonnull md);
+
+extern void* _Nullable __tlsf_alloc(tlsf_t _Nonnull self, size_t nbytes);
+
+// Same as __tlsf_alloc() but records 'site' in the block. The site costs one
+// additional word per block. It is reported by __tlsf_visit() and carried over
+// by __tlsf_realloc(). 'site' must stay valid for as long as the block exists.
+extern void* _Nullable __tlsf_alloc_site(tlsf_t _Nonnull self, size_t nbytes, const char* _Nullable site);
+
+extern void* _Nullable __tlsf_realloc(tlsf_t _Nonnull self, void * _Nullable ptr, size_t new_size);
+
+// Attempts to deallocate the given memory block. Returns EOK on success and
+// ENOTBLK if the allocator does not manage the given memory block. Invokes the
+// release function if the memory block was the last allocated block in a
+// memory region that was added with __tlsf_add_memregion().
+extern errno_t __tlsf_dealloc(tlsf_t _Nonnull self, void* _Nullable ptr);
+
+// Returns the size of the given memory block. This is the size minus the block
+// header and plus whatever additional memory the allocator added based on its
+// internal alignment constraints.
+extern errno_t __tlsf_getblocksize(tlsf_t _Nonnull self, void* _Nonnull ptr, size_t* _Nonnull pOutSize);
+
+// Returns the allocation site that was recorded in the allocated block 'ptr'
+// and NULL if the block does not carry a site or the allocator does not manage
+// it.
+extern const char* _Nullable __tlsf_getblocksite(tlsf_t _Nonnull self, void* _Nullable ptr);
+
+// Returns the number of bytes that are not allocated. This includes the headers
+// and trailers of free blocks and space lost to fragmentation. Takes constant
+// time.
+extern size_t __tlsf_getfreebytes(tlsf_t _Nonnull self);
+
+// Returns the size of the allocated block 'ptr' without looking up the memory
+// region that manages it. Only reads the block header and thus does not need
+// to be protected by the lock that protects the allocator. Returns 0 if 'ptr'
+// does not point to an allocated block or if the block carries an allocation
+// site.
+extern size_t __tlsf_allocsize(void* _Nullable ptr);
+
+// Returns true if the given pointer is a base pointer of a memory block that
+// was allocated with the given allocator.
+extern bool __tlsf_isvalidptr(tlsf_t _Nonnull self, void* _Nullable ptr);
+
+// Returns the statistics of the allocator. Walks all blocks of all memory
+// regions and thus takes time proportional to the number of blocks.
+extern void __tlsf_getinfo(tlsf_t _Nonnull self, tlsf_info_t* _Nonnull pOutInfo);
+
+// Invokes 'func' for every allocated block. 'func' must not call into the
+// allocator.
+extern void __tlsf_visit(tlsf_t _Nonnull self, tlsf_visit_func_t _Nonnull func, void* _Nullable ctx);
+
+__CPP_END
+
+#endif /* __TLSF_H */
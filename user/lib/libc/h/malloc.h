@@ -29,6 +29,51 @@ extern void free(void *ptr);
 // of memory.
 extern void _abort_on_nomem(void);
 
+
+// Number of request size classes in malloc_stats_t. Class i counts requests of
+// [2^i, 2^(i+1)) bytes and the last class counts all bigger requests.
+#define MALLOC_SIZE_CLASS_COUNT 16
+
+typedef struct malloc_stats {
+    size_t          used_bytes;         // Allocated bytes including block headers
+    size_t          peak_used_bytes;
+    size_t          free_bytes;
+    size_t          largest_free_size;  // Biggest block that can be allocated without growing the heap
+    size_t          used_block_count;
+    size_t          free_block_count;
+    int             region_count;
+    unsigned int    allocs;
+    unsigned int    frees;
+    unsigned int    allocs_per_class[MALLOC_SIZE_CLASS_COUNT];
+    size_t          large_block_count;  // Blocks that have a memory region of their own
+    size_t          large_bytes;        // Size of the memory regions of the large blocks
+} malloc_stats_t;
+
+// Returns the statistics of the application heap. Small blocks that sit in the
+// per-vcpu caches of malloc() count as allocated blocks. Large blocks are not
+// part of the heap and are only counted by the large_xxx fields.
+extern void malloc_getstats(malloc_stats_t* _Nonnull stats);
+
+// Writes the address, size and allocation site of every allocated block that
+// carries an allocation site to stderr. A block carries the source location of
+// the malloc() or calloc() call that allocated it if the translation unit that
+// contains the call defines _MALLOC_TRACK_SITES before it includes <malloc.h>
+// or <stdlib.h>.
+extern void malloc_dump(void);
+
+
+extern void *__malloc_site(size_t size, const char* _Nullable site);
+extern void *__calloc_site(size_t num, size_t size, const char* _Nullable site);
+
+#if defined(_MALLOC_TRACK_SITES)
+#define __MALLOC_STR(__x) #__x
+#define __MALLOC_XSTR(__x) __MALLOC_STR(__x)
+#define __MALLOC_SITE __FILE__ ":" __MALLOC_XSTR(__LINE__)
+
+#define malloc(__size) __malloc_site(__size, __MALLOC_SITE)
+#define calloc(__num, __size) __calloc_site(__num, __size, __MALLOC_SITE)
+#endif
+
 __CPP_END
 
 #endif /* _MALLOC_H */
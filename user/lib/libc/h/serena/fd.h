@@ -63,6 +63,27 @@ extern off_t fd_seek(int fd, off_t offset, int whence);
 extern int fd_truncate(int fd, off_t length);
 
 
+// Synchronously writes all modified data and metadata of the file 'fd' to the
+// underlying storage. Only the blocks that belong to the file are written out;
+// other cached data of the filesystem is left alone. Returns once the data is
+// on the storage device. Returns -1 and sets errno to EINVAL if the descriptor
+// does not refer to a file or directory.
+// @Concurrency: Safe
+extern int fd_sync(int fd);
+
+// Like fd_sync() but only writes the file data and the metadata that is needed
+// to read the data back (eg file size and block allocation). Timestamp-only
+// changes are not written out.
+// @Concurrency: Safe
+extern int fd_datasync(int fd);
+
+// Like fd_sync() and then drops the file data from the disk cache. The next
+// read of the file fetches the data from the storage device again. Blocks that
+// are in use by someone else are kept in the cache.
+// @Concurrency: Safe
+extern int fd_purge(int fd);
+
+
 // Returns a copy of file/directory attributes. Similar to fs_attr() but
 // operates on the file descriptor 'fd'.
 // @Concurrency: Safe
@@ -26,6 +26,16 @@ __CPP_BEGIN
 // states, including the zombie state.
 extern int host_processes(pid_t* _Nonnull buf, size_t bufSize);
 
+// Fills the buffer with a snapshot of all currently existing processes. The
+// snapshot is taken in a single pass and describes a consistent set of
+// processes. 'bufSize' is the number of proc_snapshot_t entries that 'buf' can
+// hold. The number of entries that were filled in is returned in 'pOutCount'.
+// Returns 0 on success and if the buffer is big enough to hold all processes.
+// Returns 1 if the buffer isn't big enough to hold all processes. However the
+// buffer is still filled with as many entries as do fit. Returns -1 on an
+// error.
+extern int host_procsnap(proc_snapshot_t* _Nonnull buf, size_t bufSize, size_t* _Nonnull pOutCount);
+
 // Fills the buffer with an array of fsid_t's of all currently mounted
 // filesystems. 'bufSize' is the size of the buffer in terms of the number of
 // fsid_t objects that it can hold. 'buf' will be terminated by a 0 fsid_t. Thus
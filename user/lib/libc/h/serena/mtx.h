@@ -27,6 +27,7 @@ typedef struct mtx {
 #define mtx_plain       0   /* basic mutex which supports mtx_lock() and mtx_trylock() */
 #define mtx_timed       1   /* mutex which additionally supports mtx_timedlock() */
 #define mtx_recursive   2   /* mutex which additionally supports recursion; (*) not yet supported */
+#define mtx_inherit     4   /* option: a vcpu blocked on the mutex lends its priority to the owner of the mutex. May be combined with mtx_plain and mtx_timed */
 
 
 // Initializes a mutex.
@@ -65,6 +65,13 @@ extern void proc_spawnattr_setsuspended(proc_spawnattr_t* _Nonnull attr, bool fl
 extern int proc_spawnattr_schedparam(const proc_spawnattr_t* _Nonnull attr, int type, int* _Nonnull param);
 extern int proc_spawnattr_setschedparam(proc_spawnattr_t* _Nonnull attr, int type, const int* _Nonnull param);
 
+// Sets the size of the user stack of the main vcpu of the new process. 0 means
+// that the stack size requested by the executable should be used. The
+// vcpu_stack_peak field of proc_basic_info_t reports how much stack the vcpus
+// of a process have actually used.
+extern size_t proc_spawnattr_stacksize(const proc_spawnattr_t* _Nonnull attr);
+extern int proc_spawnattr_setstacksize(proc_spawnattr_t* _Nonnull attr, size_t size);
+
 
 
 // Initializes a spawn actions object. Spawn actions are executed in the order
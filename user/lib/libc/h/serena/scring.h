@@ -0,0 +1,49 @@
+//
+//  scring.h
+//  libc
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#ifndef _SERENA_SCRING_H
+#define _SERENA_SCRING_H 1
+
+#include <_cmndef.h>
+#include <_null.h>
+#include <_size.h>
+#include <kpi/scring.h>
+#include <kpi/syscall.h>
+
+__CPP_BEGIN
+
+// Initializes the system call ring 'ring'. 'sqes' and 'cqes' must each point to
+// an array of 'nentries' entries. 'nentries' must be a power of 2 and at most
+// SCRING_MAX_ENTRIES. The arrays must stay alive as long as the ring is in use.
+// @Concurrency: Not safe
+extern int scring_init(scring_t* _Nonnull ring, scring_sqe_t* _Nonnull sqes, scring_cqe_t* _Nonnull cqes, size_t nentries);
+
+// Returns the next free submission entry with 'scno' and 'udata' filled in and
+// all arguments cleared. The caller fills in the arguments in the order that
+// _syscall() expects them. The entry is queued up for execution by the next
+// scring_submit(). Returns NULL if the submission queue is full.
+// @Concurrency: Not safe
+extern scring_sqe_t* _Nullable scring_sqe(scring_t* _Nonnull ring, int scno, intptr_t udata);
+
+// Executes all queued submissions with a single trap into the kernel. Returns
+// the number of submissions that were executed. Fewer submissions than queued
+// are executed if the completion queue fills up. Returns -1 and sets errno if
+// the ring is invalid. Note that the result of a queued system call is reported
+// by its completion entry.
+// @Concurrency: Not safe
+extern int scring_submit(scring_t* _Nonnull ring);
+
+// Removes the oldest completion entry from the completion queue and returns
+// it. Returns NULL if no completion entry is available. The returned entry
+// stays valid until the next scring_submit().
+// @Concurrency: Not safe
+extern const scring_cqe_t* _Nullable scring_cqe(scring_t* _Nonnull ring);
+
+__CPP_END
+
+#endif /* _SERENA_SCRING_H */
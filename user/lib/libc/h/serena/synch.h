@@ -24,6 +24,14 @@ __CPP_BEGIN
 // time value. Returns ETIMEDOUT if the timeout is reached.
 extern int woa_wait(volatile atomic_int* _Nonnull addr, int expected, int flags, const nanotime_t* _Nullable wtp);
 
+// Like woa_wait() but additionally lends the priority of the caller to the vcpu
+// 'owner' while the caller is blocked. 'owner' is expected to be the vcpu that
+// holds the lock that the memory cell at address 'addr' represents. 'expected'
+// should encode 'owner' since the owner is only recorded if 'addr' still holds
+// 'expected'. The owner keeps the inherited priority until it calls
+// woa_wakeup() on 'addr'.
+extern int woa_wait_pi(volatile atomic_int* _Nonnull addr, int expected, vcpuid_t owner, int flags, const nanotime_t* _Nullable wtp);
+
 // Wakes up one or all waiters currently blocked on the address 'addr'.
 extern int woa_wakeup(volatile atomic_int* _Nonnull addr, int flags);
 
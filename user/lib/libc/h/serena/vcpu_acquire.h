@@ -38,6 +38,12 @@ extern void vcpu_attr_setsuspended(vcpu_attr_t* _Nonnull attr, bool flag);
 extern void vcpu_attr_qos(vcpu_attr_t* _Nonnull attr, int* _Nullable qos, int* _Nullable priority);
 extern int vcpu_attr_setqos(vcpu_attr_t* _Nonnull attr, int qos, int priority);
 
+// Sets the size of the user stack of the vcpu. 0 selects the default stack size.
+// Use vcpu_info() with VCPU_INFO_STACK to find out how much stack a vcpu really
+// uses.
+extern size_t vcpu_attr_stacksize(const vcpu_attr_t* _Nonnull attr);
+extern int vcpu_attr_setstacksize(vcpu_attr_t* _Nonnull attr, size_t size);
+
 
 // Acquires a vcpu. 'attr' specifies various attributes and how the vcpu should
 // be acquired. Returns the id of the newly acquired vcpu on success and -1 if
@@ -16,6 +16,11 @@ __CPP_BEGIN
 
 extern int vm_allocate(size_t nbytes, void* _Nullable * _Nonnull ptr);
 
+// Returns the memory block at 'ptr' to the kernel. 'ptr' must be a pointer that
+// was returned by vm_allocate() and 'nbytes' must be the size that was passed
+// to vm_allocate().
+extern int vm_deallocate(void* _Nonnull ptr, size_t nbytes);
+
 __CPP_END
 
 #endif /* _SERENA_VM_H */
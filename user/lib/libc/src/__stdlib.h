@@ -23,6 +23,8 @@ __CPP_BEGIN
 
 typedef void (*at_exit_func_t)(void);
 
+struct __mcache;
+
 
 extern const proc_ctx_t* _Nonnull __gProcCtx;
 
@@ -38,6 +40,7 @@ extern volatile bool            __gIsExiting;
 
 extern void __stdlibc_init(proc_ctx_t* _Nonnull argsp);
 extern void __malloc_init(void);
+extern void __mcache_destroy(struct __mcache* _Nullable cache);
 extern void __locale_init(void);
 extern void __proc_init(void);
 extern void __stdio_init(void);
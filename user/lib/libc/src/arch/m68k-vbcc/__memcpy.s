@@ -0,0 +1,246 @@
+;
+;  __memcpy.s
+;  libsc
+;
+;  Created by Dietmar Planitzer on 10/18/26.
+;  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+;
+
+; libsc doesn't define memcpy() and memmove(). The kernel defines them and
+; dispatches to the CPU specific versions below through its KEI table.
+
+    xdef __memcpy_020
+    xdef __memcpy_040
+    xdef __memmove_020
+    xdef __memmove_040
+
+
+; Copies below this size are done with byte moves
+MEM_MIN_LONG_COPY       equ 16
+
+; Number of bytes moved by a single movem burst (d2-d7/a2-a5)
+MEM_BURST_SIZE          equ 40
+
+; Copies below this size don't benefit from move16 because of the setup cost
+MEM_MIN_MOVE16_COPY     equ 256
+
+; Amiga chip RAM lives below this address. Chip RAM doesn't support burst
+; transfers reliably on all 68040/68060 machines and thus we never use move16
+; on it
+MEM_CHIP_RAM_TOP        equ $00200000
+
+
+;-------------------------------------------------------------------------------
+; void* _Nonnull memcpy_020(void* _Nonnull _Restrict dst, const void* _Nonnull _Restrict src, size_t count)
+; 68020/68030 version. Aligns 'dst' to a long word boundary and then copies
+; MEM_BURST_SIZE bytes per movem load/store pair. The 68020+ handles misaligned
+; source long words in hardware.
+__memcpy_020:
+    cargs mc20_dst.l, mc20_src.l, mc20_count.l
+
+    move.l  mc20_dst(sp), a1
+    move.l  mc20_src(sp), a0
+    move.l  mc20_count(sp), d1
+
+
+;-------------------------------------------------------------------------------
+; memcpy_fwd_020(a0: src, a1: dst, d1: count) -> d0
+; Copies from low to high addresses. Returns the 'dst' argument of the caller
+; in d0. Expects that the 'dst' argument is at 4(sp).
+memcpy_fwd_020:
+    cmp.l   #MEM_MIN_LONG_COPY, d1
+    blo.s   .fwd_bytes
+
+    ; align dst to the next long word boundary
+    move.l  a1, d0
+    and.l   #3, d0
+    beq.s   .fwd_aligned
+    neg.l   d0
+    addq.l  #4, d0
+    sub.l   d0, d1
+    subq.w  #1, d0
+.fwd_align:
+    move.b  (a0)+, (a1)+
+    dbra    d0, .fwd_align
+
+.fwd_aligned:
+    cmp.l   #MEM_BURST_SIZE, d1
+    blo.s   .fwd_longs
+
+    movem.l d2-d7/a2-a5, -(sp)
+    moveq   #MEM_BURST_SIZE, d0
+.fwd_burst:
+    movem.l (a0)+, d2-d7/a2-a5
+    movem.l d2-d7/a2-a5, (a1)
+    add.l   d0, a1
+    sub.l   d0, d1
+    cmp.l   d0, d1
+    bhs.s   .fwd_burst
+    movem.l (sp)+, d2-d7/a2-a5
+
+.fwd_longs:
+    move.l  d1, d0
+    lsr.l   #2, d0
+    beq.s   .fwd_bytes
+    and.l   #3, d1
+    subq.w  #1, d0
+.fwd_long:
+    move.l  (a0)+, (a1)+
+    dbra    d0, .fwd_long
+
+.fwd_bytes:
+    subq.l  #1, d1
+    bmi.s   .fwd_done
+.fwd_byte:
+    move.b  (a0)+, (a1)+
+    dbra    d1, .fwd_byte
+
+.fwd_done:
+    move.l  4(sp), d0
+    rts
+
+
+;-------------------------------------------------------------------------------
+; void* _Nonnull memcpy_040(void* _Nonnull _Restrict dst, const void* _Nonnull _Restrict src, size_t count)
+; 68040/68060 version. Uses move16 to copy whole cache lines if 'src' and 'dst'
+; have the same alignment relative to a 16 byte boundary and neither of them
+; points into chip RAM. Falls back to the 68020 version otherwise.
+__memcpy_040:
+    cargs mc40_dst.l, mc40_src.l, mc40_count.l
+
+    move.l  mc40_dst(sp), a1
+    move.l  mc40_src(sp), a0
+    move.l  mc40_count(sp), d1
+
+
+;-------------------------------------------------------------------------------
+; memcpy_fwd_040(a0: src, a1: dst, d1: count) -> d0
+; Same contract as memcpy_fwd_020.
+memcpy_fwd_040:
+    cmp.l   #MEM_MIN_MOVE16_COPY, d1
+    blo.s   memcpy_fwd_020
+    cmp.l   #MEM_CHIP_RAM_TOP, a0
+    blo.s   memcpy_fwd_020
+    cmp.l   #MEM_CHIP_RAM_TOP, a1
+    blo.s   memcpy_fwd_020
+    move.l  a0, d0
+    sub.l   a1, d0
+    and.l   #15, d0
+    bne.s   memcpy_fwd_020
+
+    ; align src and dst to the next cache line boundary
+    move.l  a1, d0
+    and.l   #15, d0
+    beq.s   .m16_aligned
+    neg.l   d0
+    add.l   #16, d0
+    sub.l   d0, d1
+    subq.w  #1, d0
+.m16_align:
+    move.b  (a0)+, (a1)+
+    dbra    d0, .m16_align
+
+.m16_aligned:
+    ; 4 cache lines per iteration. There are at least 3 iterations because
+    ; count >= MEM_MIN_MOVE16_COPY - 15
+    move.l  d1, d0
+    lsr.l   #6, d0
+    and.l   #63, d1
+.m16_loop:
+    move16  (a0)+, (a1)+
+    move16  (a0)+, (a1)+
+    move16  (a0)+, (a1)+
+    move16  (a0)+, (a1)+
+    subq.l  #1, d0
+    bne.s   .m16_loop
+
+    ; copy the remaining < 64 bytes
+    bra     memcpy_fwd_020
+
+
+;-------------------------------------------------------------------------------
+; void* _Nonnull memmove_020(void* _Nonnull dst, const void* _Nonnull src, size_t count)
+; 68020/68030 version. Copies from low to high addresses if 'dst' is below
+; 'src' and from high to low addresses otherwise. A movem burst reads all of its
+; source bytes before it writes any destination bytes and thus overlapping
+; regions are handled correctly.
+__memmove_020:
+    cargs mm20_dst.l, mm20_src.l, mm20_count.l
+
+    move.l  mm20_dst(sp), a1
+    move.l  mm20_src(sp), a0
+    move.l  mm20_count(sp), d1
+    cmp.l   a0, a1
+    bls     memcpy_fwd_020
+    bra.s   memcpy_bwd_020
+
+
+;-------------------------------------------------------------------------------
+; void* _Nonnull memmove_040(void* _Nonnull dst, const void* _Nonnull src, size_t count)
+; 68040/68060 version. Uses move16 for the forward direction. move16 can't copy
+; backwards and thus the backward direction is the same as in the 68020 version.
+__memmove_040:
+    cargs mm40_dst.l, mm40_src.l, mm40_count.l
+
+    move.l  mm40_dst(sp), a1
+    move.l  mm40_src(sp), a0
+    move.l  mm40_count(sp), d1
+    cmp.l   a0, a1
+    bls     memcpy_fwd_040
+
+
+;-------------------------------------------------------------------------------
+; memcpy_bwd_020(a0: src, a1: dst, d1: count) -> d0
+; Copies from high to low addresses. Returns the 'dst' argument of the caller
+; in d0. Expects that the 'dst' argument is at 4(sp).
+memcpy_bwd_020:
+    add.l   d1, a0
+    add.l   d1, a1
+    cmp.l   #MEM_MIN_LONG_COPY, d1
+    blo.s   .bwd_bytes
+
+    ; align the end of dst to a long word boundary
+    move.l  a1, d0
+    and.l   #3, d0
+    beq.s   .bwd_aligned
+    sub.l   d0, d1
+    subq.w  #1, d0
+.bwd_align:
+    move.b  -(a0), -(a1)
+    dbra    d0, .bwd_align
+
+.bwd_aligned:
+    cmp.l   #MEM_BURST_SIZE, d1
+    blo.s   .bwd_longs
+
+    movem.l d2-d7/a2-a5, -(sp)
+    moveq   #MEM_BURST_SIZE, d0
+.bwd_burst:
+    sub.l   d0, a0
+    movem.l (a0), d2-d7/a2-a5
+    movem.l d2-d7/a2-a5, -(a1)
+    sub.l   d0, d1
+    cmp.l   d0, d1
+    bhs.s   .bwd_burst
+    movem.l (sp)+, d2-d7/a2-a5
+
+.bwd_longs:
+    move.l  d1, d0
+    lsr.l   #2, d0
+    beq.s   .bwd_bytes
+    and.l   #3, d1
+    subq.w  #1, d0
+.bwd_long:
+    move.l  -(a0), -(a1)
+    dbra    d0, .bwd_long
+
+.bwd_bytes:
+    subq.l  #1, d1
+    bmi.s   .bwd_done
+.bwd_byte:
+    move.b  -(a0), -(a1)
+    dbra    d1, .bwd_byte
+
+.bwd_done:
+    move.l  4(sp), d0
+    rts
@@ -0,0 +1,100 @@
+;
+;  __memset.s
+;  libsc
+;
+;  Created by Dietmar Planitzer on 10/18/26.
+;  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+;
+
+    xdef _memset
+    xdef __memset_020
+
+
+; Requests below this size are done with byte stores
+MEM_MIN_LONG_SET        equ 16
+
+; Number of bytes written by a single movem burst (d2-d7/a2-a5)
+MEM_BURST_SIZE          equ 40
+
+
+;-------------------------------------------------------------------------------
+; void* _Nonnull memset_020(void* _Nonnull dst, int c, size_t count)
+; 68020+ version. Fills the block from its end towards its start because movem
+; only supports the predecrement addressing mode for stores. Writes
+; MEM_BURST_SIZE bytes per movem store. Used on all CPU models since move16
+; has no advantage for stores.
+_memset:
+__memset_020:
+    cargs #(4 + 4), ms20_dst.l, ms20_c.l, ms20_count.l
+
+    move.l  d2, -(sp)
+    move.l  ms20_dst(sp), a0
+    move.l  ms20_c(sp), d0
+    move.l  ms20_count(sp), d1
+    add.l   d1, a0
+    cmp.l   #MEM_MIN_LONG_SET, d1
+    blo.s   .set_bytes
+
+    ; align the end of the block to a long word boundary
+    move.l  a0, d2
+    and.l   #3, d2
+    sub.l   d2, d1
+    bra.s   .set_align_next
+.set_align:
+    move.b  d0, -(a0)
+.set_align_next:
+    dbra    d2, .set_align
+
+    ; replicate the fill byte into all 4 bytes of d0
+    and.l   #$ff, d0
+    move.l  d0, d2
+    lsl.l   #8, d2
+    or.l    d2, d0
+    move.l  d0, d2
+    swap    d2
+    or.l    d2, d0
+
+    cmp.l   #MEM_BURST_SIZE, d1
+    blo.s   .set_longs
+
+    movem.l d3-d7/a2-a5, -(sp)
+    move.l  d0, d2
+    move.l  d0, d3
+    move.l  d0, d4
+    move.l  d0, d5
+    move.l  d0, d6
+    move.l  d0, d7
+    move.l  d0, a2
+    move.l  d0, a3
+    move.l  d0, a4
+    move.l  d0, a5
+    move.l  #MEM_BURST_SIZE, a1
+.set_burst:
+    movem.l d2-d7/a2-a5, -(a0)
+    sub.l   a1, d1
+    cmp.l   a1, d1
+    bhs.s   .set_burst
+    movem.l (sp)+, d3-d7/a2-a5
+
+.set_longs:
+    ; d1 < MEM_BURST_SIZE here
+    move.l  d1, d2
+    lsr.l   #2, d2
+    and.l   #3, d1
+    bra.s   .set_long_next
+.set_long:
+    move.l  d0, -(a0)
+.set_long_next:
+    dbra    d2, .set_long
+
+.set_bytes:
+    ; d1 < MEM_MIN_LONG_SET here
+    bra.s   .set_byte_next
+.set_byte:
+    move.b  d0, -(a0)
+.set_byte_next:
+    dbra    d1, .set_byte
+
+    move.l  (sp)+, d2
+    move.l  4(sp), d0
+    rts
@@ -47,6 +47,8 @@ ARCH_M68K_VBCC_SC_ASM_SOURCES := $(ARCH_M68K_VBCC_SOURCES_DIR)/__divsint64_020.s
 								 $(ARCH_M68K_VBCC_SOURCES_DIR)/__divuint64_020.s \
 								 $(ARCH_M68K_VBCC_SOURCES_DIR)/__divuint64_060.s \
 								 $(ARCH_M68K_VBCC_SOURCES_DIR)/__lshint64.s \
+								 $(ARCH_M68K_VBCC_SOURCES_DIR)/__memcpy.s \
+								 $(ARCH_M68K_VBCC_SOURCES_DIR)/__memset.s \
 								 $(ARCH_M68K_VBCC_SOURCES_DIR)/__modsint64_020.s \
 								 $(ARCH_M68K_VBCC_SOURCES_DIR)/__modsint64_060.s \
 								 $(ARCH_M68K_VBCC_SOURCES_DIR)/__moduint64_020.s \
@@ -0,0 +1,25 @@
+//
+//  fd_sync.c
+//  libc
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#include <kpi/syscall.h>
+#include <serena/fd.h>
+
+int fd_sync(int fd)
+{
+    return (int)_syscall(SC_fd_sync, fd, 0);
+}
+
+int fd_datasync(int fd)
+{
+    return (int)_syscall(SC_fd_sync, fd, FD_SYNC_DATA);
+}
+
+int fd_purge(int fd)
+{
+    return (int)_syscall(SC_fd_sync, fd, FD_SYNC_PURGE);
+}
@@ -0,0 +1,23 @@
+//
+//  host_procsnap.c
+//  libc
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#include <serena/host.h>
+#include <kpi/syscall.h>
+
+
+int host_procsnap(proc_snapshot_t* _Nonnull buf, size_t bufSize, size_t* _Nonnull pOutCount)
+{
+    int hasMore = 0;
+    
+    if (_syscall(SC_host_procsnap, buf, bufSize, pOutCount, &hasMore) == 0) {
+        return hasMore;
+    }
+    else {
+        return -1;
+    }
+}
@@ -9,18 +9,75 @@
 #ifndef __MALLOC_H
 #define __MALLOC_H 1
 
-#include <__lsta.h>
+#include <__tlsf.h>
 #include <serena/mtx.h>
 
 
 // The allocator that represents the application heap
-extern lsta_t   __gMainAllocator;
+extern tlsf_t   __gMainAllocator;
 extern bool     __gAbortOnNoMem;
 extern mtx_t    __gMallocLock;
 
 
 extern void __malloc_nomem(void);
 
+// Reports a heap error 'err' (MERR_XXX) that was detected by 'funcName'.
+extern void __malloc_error(int err, const char* _Nonnull _Restrict funcName, void* _Nullable _Restrict ptr);
+
+
+// Every vcpu has a cache of small blocks in front of the main allocator. The
+// cache is organized as MCACHE_CLASS_COUNT bins of blocks with sizes that are
+// multiples of 2^MCACHE_CLASS_SHIFT bytes. An empty bin is refilled with
+// MCACHE_BATCH_COUNT blocks at once and a bin that holds more than
+// MCACHE_MAX_COUNT blocks gives MCACHE_BATCH_COUNT of them back. Only the
+// refill and flush operations take the malloc lock.
+#define MCACHE_CLASS_SHIFT  4
+#define MCACHE_CLASS_COUNT  8
+#define MCACHE_MIN_SIZE     (1 << MCACHE_CLASS_SHIFT)
+#define MCACHE_MAX_SIZE     (MCACHE_CLASS_COUNT << MCACHE_CLASS_SHIFT)
+#define MCACHE_BATCH_COUNT  8
+#define MCACHE_MAX_COUNT    16
+
+// Allocates a block of 'size' bytes from the cache of the calling vcpu. 'size'
+// must be in the range [1, MCACHE_MAX_SIZE].
+extern void* _Nullable __mcache_alloc(size_t size);
+
+// Returns the block 'ptr' to the cache of the calling vcpu. Returns false if the
+// block can not be cached and should be freed to the main allocator instead.
+extern bool __mcache_free(void* _Nullable ptr);
+
+
+// Requests of at least MLARGE_MIN_SIZE bytes get a vm_allocate()d region of
+// their own instead of a block in the main allocator. This way big transient
+// buffers don't fragment the main heap and their memory goes back to the kernel
+// when they are freed. Up to MLARGE_MAX_COUNT regions are tracked in a table.
+// Requests that find the table full are served by the main allocator. A region
+// is rounded up to a multiple of the page size and realloc() resizes a block in
+// place as long as it fits in its region.
+#define MLARGE_MIN_SIZE     (32*1024)
+#define MLARGE_MAX_COUNT    32
+
+// Allocates a block of 'size' bytes in a region of its own. Returns NULL if the
+// kernel is out of memory or the table is full. The caller should fall back to
+// the main allocator in this case.
+extern void* _Nullable __mlarge_alloc(size_t size, const char* _Nullable site);
+
+// Frees the block 'ptr' and returns its region to the kernel. Returns false if
+// 'ptr' isn't a large block.
+extern bool __mlarge_free(void* _Nullable ptr);
+
+// Resizes the large block 'ptr' like realloc() does. Returns false if 'ptr'
+// isn't a large block.
+extern bool __mlarge_realloc(void* _Nullable ptr, size_t new_size, void* _Nullable * _Nonnull pOutPtr);
+
+// Returns the number of large blocks and the size of their regions. Expects
+// that the caller holds the malloc lock.
+extern void __mlarge_getinfo(size_t* _Nonnull pOutCount, size_t* _Nonnull pOutBytes);
+
+// Invokes 'func' for every large block. Expects that the caller holds the
+// malloc lock.
+extern void __mlarge_visit(tlsf_visit_func_t _Nonnull func, void* _Nullable ctx);
+
 #define __malloc_lock() \
 mtx_lock(&__gMallocLock)
 
@@ -16,9 +16,10 @@
 
 #define INITIAL_HEAP_SIZE   __Ceil_PowerOf2(64*1024, CPU_PAGE_SIZE)
 #define EXPANSION_HEAP_SIZE __Ceil_PowerOf2(64*1024, CPU_PAGE_SIZE)
+#define REGION_OVERHEAD     256
 
 
-lsta_t  __gMainAllocator;
+tlsf_t  __gMainAllocator;
 bool    __gAbortOnNoMem;
 mtx_t   __gMallocLock;
 
@@ -43,10 +44,10 @@ void __malloc_nomem(void)
 }
 
 
-static bool __malloc_expand_backing_store(lsta_t _Nonnull pAllocator, size_t minByteCount)
+static bool __malloc_expand_backing_store(tlsf_t _Nonnull pAllocator, size_t minByteCount)
 {
-    const size_t ceiledSize = __Ceil_PowerOf2(minByteCount, CPU_PAGE_SIZE);
-    const size_t nbytes = __min(ceiledSize, EXPANSION_HEAP_SIZE);
+    // Leave room for the region and block headers
+    const size_t nbytes = __Ceil_PowerOf2(__max(minByteCount + REGION_OVERHEAD, EXPANSION_HEAP_SIZE), CPU_PAGE_SIZE);
     char* ptr;
     
     if (vm_allocate(nbytes, (void**)&ptr) == 0) {
@@ -54,7 +55,7 @@ static bool __malloc_expand_backing_store(lsta_t _Nonnull pAllocator, size_t min
 
         md.lower = ptr;
         md.upper = ptr + nbytes;
-        if (__lsta_add_memregion(pAllocator, &md) == EOK) {
+        if (__tlsf_add_memregion(pAllocator, &md) == EOK) {
             return true;
         }
     }
@@ -62,9 +63,18 @@ static bool __malloc_expand_backing_store(lsta_t _Nonnull pAllocator, size_t min
     return false;
 }
 
-static void __malloc_error(int err, const char* _Nonnull _Restrict funcName, void* _Nullable _Restrict ptr)
+// Hands a memory region that no longer holds any allocated blocks back to the
+// kernel. 'md' covers exactly the memory that __malloc_expand_backing_store()
+// got from vm_allocate() since that memory is word aligned and its size is a
+// multiple of the page size.
+static bool __malloc_release_backing_store(tlsf_t _Nonnull pAllocator, const mem_desc_t* _Nonnull md)
 {
-    if (err = MERR_DOUBLE_FREE) {
+    return (vm_deallocate(md->lower, md->upper - md->lower) == 0) ? true : false;
+}
+
+void __malloc_error(int err, const char* _Nonnull _Restrict funcName, void* _Nullable _Restrict ptr)
+{
+    if (err == MERR_DOUBLE_FREE) {
         fprintf(stderr, "** m%s: ignoring double free at: %p\n", funcName, ptr);
     }
     else {
@@ -73,23 +83,40 @@ static void __malloc_error(int err, const char* _Nonnull _Restrict funcName, voi
 }
 
 
+// Returns the size of the initial heap. The executable may ask for a specific
+// size through the AT_HEAP_SIZE aux entry.
+static size_t __malloc_initial_heap_size(void)
+{
+    const proc_aux_entry_t* ae = __gProcCtx->aux;
+
+    while (ae->type != AT_END) {
+        if (ae->type == AT_HEAP_SIZE && ae->u.i > 0) {
+            return __Ceil_PowerOf2(ae->u.i, CPU_PAGE_SIZE);
+        }
+        ae++;
+    }
+
+    return INITIAL_HEAP_SIZE;
+}
+
 void __malloc_init(void)
 {
+    const size_t heapSize = __malloc_initial_heap_size();
     mem_desc_t md;
     char* ptr;
 
     // Get backing store for our initial memory region
-    if (vm_allocate(INITIAL_HEAP_SIZE, (void**)&ptr) != 0) {
+    if (vm_allocate(heapSize, (void**)&ptr) != 0) {
         abort();
     }
 
     md.lower = ptr;
-    md.upper = md.lower + INITIAL_HEAP_SIZE;
+    md.upper = md.lower + heapSize;
 
-    __gMainAllocator = __lsta_create(&md, __malloc_expand_backing_store, __malloc_error);
+    __gMainAllocator = __tlsf_create(&md, __malloc_expand_backing_store, __malloc_release_backing_store, __malloc_error);
     if (__gMainAllocator == NULL) {
         abort();
     }
 
-    mtx_init(&__gMallocLock, mtx_plain);
+    mtx_init(&__gMallocLock, mtx_plain | mtx_inherit);
 }
@@ -0,0 +1,195 @@
+//
+//  __mcache.c
+//  libc
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#include <limits.h>
+#include <string.h>
+#include <__stdlib.h>
+#include <vcpu/__vcpu.h>
+#include "__malloc.h"
+
+
+// A cached block is linked into its bin through its first word. The second
+// word marks the block as cached. The main allocator considers a cached block
+// allocated and thus can not detect a double free of it. The mark is only a
+// hint since a live block may hold the same value as user data. A double free
+// is confirmed by finding the block in the bin. Every block is at least
+// MCACHE_MIN_SIZE bytes big and thus has room for both words.
+typedef struct mcache_block {
+    struct mcache_block* _Nullable  next;
+    uint32_t                        magic;
+} mcache_block_t;
+
+#define MCACHE_BLOCK_MAGIC  0x6d636672
+
+typedef struct mcache_bin {
+    mcache_block_t* _Nullable   first;
+    int                         count;
+} mcache_bin_t;
+
+struct __mcache {
+    mcache_bin_t    bin[MCACHE_CLASS_COUNT];
+};
+
+
+// Bin that serves allocation requests of 'size' bytes
+#define __mcache_alloc_class(__size) \
+(((__size) - 1) >> MCACHE_CLASS_SHIFT)
+
+// Bin that takes a free block of 'size' bytes. The block is at least as big as
+// the blocks that the bin hands out.
+#define __mcache_free_class(__size) \
+(((__size) >> MCACHE_CLASS_SHIFT) - 1)
+
+#define __mcache_class_size(__c) \
+(((__c) + 1) << MCACHE_CLASS_SHIFT)
+
+
+// Allocates the cache of the vcpu 'vp' if it doesn't have one yet and refills
+// bin 'c' with a batch of blocks from the main allocator. Returns one additional
+// block of the size of bin 'c' to the caller.
+static void* _Nullable __mcache_refill(vcpu_t _Nonnull vp, int c)
+{
+    const size_t bsize = __mcache_class_size(c);
+    struct __mcache* self = vp->mcache;
+    void* ptr;
+
+    __malloc_lock();
+    if (self == NULL) {
+        self = __tlsf_alloc(__gMainAllocator, sizeof(struct __mcache));
+        if (self) {
+            memset(self, 0, sizeof(struct __mcache));
+            vp->mcache = self;
+        }
+    }
+
+    ptr = __tlsf_alloc(__gMainAllocator, bsize);
+    if (ptr) {
+        // Memory that comes from the main allocator may still carry the mark
+        // of a block that was cached before
+        ((mcache_block_t*)ptr)->magic = 0;
+    }
+    if (self && ptr) {
+        mcache_bin_t* bp = &self->bin[c];
+
+        while (bp->count < MCACHE_BATCH_COUNT) {
+            mcache_block_t* bkp = __tlsf_alloc(__gMainAllocator, bsize);
+
+            if (bkp == NULL) {
+                break;
+            }
+
+            bkp->next = bp->first;
+            bkp->magic = MCACHE_BLOCK_MAGIC;
+            bp->first = bkp;
+            bp->count++;
+        }
+    }
+    __malloc_unlock();
+
+    return ptr;
+}
+
+// Returns true if the block 'bkp' is in bin 'bp'.
+static bool __mcache_bin_contains(const mcache_bin_t* _Nonnull bp, const mcache_block_t* _Nonnull bkp)
+{
+    for (const mcache_block_t* p = bp->first; p; p = p->next) {
+        if (p == bkp) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Returns up to 'count' blocks from bin 'bp' to the main allocator.
+static void __mcache_flush(mcache_bin_t* _Nonnull bp, int count)
+{
+    __malloc_lock();
+    while (count-- > 0 && bp->first) {
+        mcache_block_t* bkp = bp->first;
+
+        bp->first = bkp->next;
+        bp->count--;
+        bkp->magic = 0;
+        __tlsf_dealloc(__gMainAllocator, bkp);
+    }
+    __malloc_unlock();
+}
+
+
+void* _Nullable __mcache_alloc(size_t size)
+{
+    vcpu_t vp = vcpu_self();
+    struct __mcache* self = vp->mcache;
+    const int c = __mcache_alloc_class(size);
+
+    if (self) {
+        mcache_bin_t* bp = &self->bin[c];
+        mcache_block_t* bkp = bp->first;
+
+        if (bkp) {
+            bp->first = bkp->next;
+            bp->count--;
+            bkp->magic = 0;
+            return bkp;
+        }
+    }
+
+    return __mcache_refill(vp, c);
+}
+
+bool __mcache_free(void* _Nullable ptr)
+{
+    const size_t size = __tlsf_allocsize(ptr);
+
+    if (size < MCACHE_MIN_SIZE || size > MCACHE_MAX_SIZE) {
+        return false;
+    }
+
+    struct __mcache* self = vcpu_self()->mcache;
+    if (self == NULL) {
+        return false;
+    }
+
+
+    // The block goes to the cache of the vcpu that frees it, no matter which
+    // vcpu allocated it. Blocks that move from one vcpu to another this way
+    // end up back in the main allocator once the bin overflows.
+    mcache_bin_t* bp = &self->bin[__mcache_free_class(size)];
+    mcache_block_t* bkp = ptr;
+
+    // Only the bin of the calling vcpu is searched. A double free of a block
+    // that sits in the bin of some other vcpu goes undetected
+    if (bkp->magic == MCACHE_BLOCK_MAGIC && __mcache_bin_contains(bp, bkp)) {
+        __malloc_error(MERR_DOUBLE_FREE, "free", ptr);
+        return true;
+    }
+
+    bkp->next = bp->first;
+    bkp->magic = MCACHE_BLOCK_MAGIC;
+    bp->first = bkp;
+    bp->count++;
+
+    if (bp->count > MCACHE_MAX_COUNT) {
+        __mcache_flush(bp, MCACHE_BATCH_COUNT);
+    }
+
+    return true;
+}
+
+void __mcache_destroy(struct __mcache* _Nullable self)
+{
+    if (self) {
+        for (int c = 0; c < MCACHE_CLASS_COUNT; c++) {
+            __mcache_flush(&self->bin[c], INT_MAX);
+        }
+
+        __malloc_lock();
+        __tlsf_dealloc(__gMainAllocator, self);
+        __malloc_unlock();
+    }
+}
@@ -0,0 +1,202 @@
+//
+//  __mlarge.c
+//  libc
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#include <machine/cpu.h>
+#include <stdint.h>
+#include <string.h>
+#include <ext/math.h>
+#include <serena/vm.h>
+#include "__malloc.h"
+
+
+typedef struct mlarge_entry {
+    char* _Nonnull          ptr;        // Start of the vm region
+    size_t                  size;       // Size that was requested by the caller
+    size_t                  capacity;   // Size of the vm region
+    const char* _Nullable   site;
+} mlarge_entry_t;
+
+
+// All of these are protected by the malloc lock. free() reads gLower and gUpper
+// without taking the lock. This is safe because a block that the caller owns
+// was entered in the table before the caller got to see it and the bounds only
+// ever shrink to a range that still covers all blocks in the table.
+static mlarge_entry_t   gEntry[MLARGE_MAX_COUNT];
+static int              gCount;
+static char* _Nullable  gLower = (char*)UINTPTR_MAX;    // Bounds of all regions in the table
+static char* _Nullable  gUpper;
+
+
+static void __mlarge_update_bounds(void)
+{
+    char* lower = (char*)UINTPTR_MAX;
+    char* upper = NULL;
+
+    for (int i = 0; i < gCount; i++) {
+        lower = __min(lower, gEntry[i].ptr);
+        upper = __max(upper, gEntry[i].ptr + gEntry[i].capacity);
+    }
+
+    gLower = lower;
+    gUpper = upper;
+}
+
+static mlarge_entry_t* _Nullable __mlarge_find(void* _Nullable ptr)
+{
+    for (int i = 0; i < gCount; i++) {
+        if (gEntry[i].ptr == ptr) {
+            return &gEntry[i];
+        }
+    }
+
+    return NULL;
+}
+
+// Allocates a vm region of at least 'capacity' bytes for a block of 'size'
+// bytes. 'capacity' must be at least 'size'. Returns NULL if the kernel has no
+// memory or the table is full.
+static void* _Nullable __mlarge_alloc_region(size_t size, size_t capacity, const char* _Nullable site)
+{
+    char* ptr;
+
+    if (capacity > SIZE_MAX - CPU_PAGE_SIZE) {
+        return NULL;
+    }
+
+    capacity = __Ceil_PowerOf2(capacity, CPU_PAGE_SIZE);
+    if (vm_allocate(capacity, (void**)&ptr) != 0) {
+        return NULL;
+    }
+
+    __malloc_lock();
+    if (gCount < MLARGE_MAX_COUNT) {
+        mlarge_entry_t* ep = &gEntry[gCount++];
+
+        ep->ptr = ptr;
+        ep->size = size;
+        ep->capacity = capacity;
+        ep->site = site;
+        gLower = __min(gLower, ptr);
+        gUpper = __max(gUpper, ptr + capacity);
+    }
+    else {
+        vm_deallocate(ptr, capacity);
+        ptr = NULL;
+    }
+    __malloc_unlock();
+
+    return ptr;
+}
+
+
+void* _Nullable __mlarge_alloc(size_t size, const char* _Nullable site)
+{
+    return __mlarge_alloc_region(size, size, site);
+}
+
+bool __mlarge_free(void* _Nullable ptr)
+{
+    if ((char*)ptr < gLower || (char*)ptr >= gUpper) {
+        return false;
+    }
+
+    __malloc_lock();
+    mlarge_entry_t* ep = __mlarge_find(ptr);
+    size_t capacity = 0;
+
+    if (ep) {
+        capacity = ep->capacity;
+        *ep = gEntry[--gCount];
+        __mlarge_update_bounds();
+    }
+    __malloc_unlock();
+
+    if (ep) {
+        vm_deallocate(ptr, capacity);
+    }
+
+    return (ep != NULL);
+}
+
+bool __mlarge_realloc(void* _Nullable ptr, size_t new_size, void* _Nullable * _Nonnull pOutPtr)
+{
+    if ((char*)ptr < gLower || (char*)ptr >= gUpper) {
+        return false;
+    }
+
+    __malloc_lock();
+    mlarge_entry_t* ep = __mlarge_find(ptr);
+    if (ep == NULL) {
+        __malloc_unlock();
+        return false;
+    }
+
+    // Same as __tlsf_realloc(): the block stays allocated
+    if (new_size == 0) {
+        __malloc_unlock();
+        *pOutPtr = NULL;
+        return true;
+    }
+
+    // Resize in place if the block stays large and fits in its region
+    if (new_size >= MLARGE_MIN_SIZE && new_size <= ep->capacity) {
+        ep->size = new_size;
+        __malloc_unlock();
+        *pOutPtr = ptr;
+        return true;
+    }
+
+    const size_t old_size = ep->size;
+    const char* site = ep->site;
+    __malloc_unlock();
+
+
+    // Move the block. A block that keeps growing gets a region with 25% head
+    // room so that the next few realloc() calls can grow it in place. A block
+    // that shrinks below the threshold goes back to the main allocator.
+    void* np = NULL;
+
+    if (new_size >= MLARGE_MIN_SIZE) {
+        const size_t headroom = new_size >> 2;
+        const size_t capacity = (new_size <= SIZE_MAX - headroom) ? new_size + headroom : new_size;
+
+        np = __mlarge_alloc_region(new_size, capacity, site);
+    }
+    if (np == NULL) {
+        __malloc_lock();
+        np = __tlsf_alloc_site(__gMainAllocator, new_size, site);
+        __malloc_unlock();
+    }
+
+    if (np) {
+        memcpy(np, ptr, __min(old_size, new_size));
+        __mlarge_free(ptr);
+    }
+
+    *pOutPtr = np;
+    return true;
+}
+
+void __mlarge_getinfo(size_t* _Nonnull pOutCount, size_t* _Nonnull pOutBytes)
+{
+    size_t nbytes = 0;
+
+    for (int i = 0; i < gCount; i++) {
+        nbytes += gEntry[i].capacity;
+    }
+
+    *pOutCount = gCount;
+    *pOutBytes = nbytes;
+}
+
+void __mlarge_visit(tlsf_visit_func_t _Nonnull func, void* _Nullable ctx)
+{
+    for (int i = 0; i < gCount; i++) {
+        func(ctx, gEntry[i].ptr, gEntry[i].size, gEntry[i].site);
+    }
+}
@@ -0,0 +1,993 @@
+//
+//  __tlsf.c
+//  libc, libsc
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#include <__tlsf.h>
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+#include <ext/bit.h>
+#include <ext/math.h>
+
+
+#if defined(__ILP32__)
+typedef int32_t word_t;
+#define WORD_SIZE       4
+#define WORD_SIZE_LOG2  2
+// 'bhdr'
+#define HEADER_PATTERN  ((word_t)0x62686472)
+// 'bhds'
+#define SITE_HEADER_PATTERN ((word_t)0x62686473)
+// 'btrl'
+#define TRAILER_PATTERN ((word_t)0x6274726c)
+#elif defined(__LLP64__) || defined(__LP64__)
+typedef int64_t word_t;
+#define WORD_SIZE       8
+#define WORD_SIZE_LOG2  3
+// 'bhdr'
+#define HEADER_PATTERN  ((word_t)0x6268647272646862)
+// 'bhds'
+#define SITE_HEADER_PATTERN ((word_t)0x6268647373646862)
+// 'btrl'
+#define TRAILER_PATTERN ((word_t)0x6274726c6c727462)
+#else
+#error "unknown data model"
+#endif
+
+
+// Size classes. The first level splits the block sizes into power of 2 ranges
+// and the second level splits each power of 2 range into SL_INDEX_COUNT equally
+// sized classes. Blocks smaller than SMALL_BLOCK_SIZE are kept in first level 0
+// which is split into word sized classes.
+#define SL_INDEX_COUNT_LOG2 4
+#define SL_INDEX_COUNT      (1 << SL_INDEX_COUNT_LOG2)
+#define FL_INDEX_SHIFT      (SL_INDEX_COUNT_LOG2 + WORD_SIZE_LOG2)
+#define FL_INDEX_MAX        30
+#define FL_INDEX_COUNT      (FL_INDEX_MAX - FL_INDEX_SHIFT + 1)
+#define SMALL_BLOCK_SIZE    (1 << FL_INDEX_SHIFT)
+
+#define MIN_GROSS_BLOCK_SIZE    (sizeof(block_header_t) + sizeof(free_links_t) + sizeof(block_trailer_t))
+#define MAX_GROSS_BLOCK_SIZE    (((size_t)1 << FL_INDEX_MAX) - ((size_t)1 << (FL_INDEX_MAX - SL_INDEX_COUNT_LOG2)))
+#define MAX_NET_BLOCK_SIZE      (MAX_GROSS_BLOCK_SIZE - sizeof(block_header_t) - sizeof(block_trailer_t))
+
+
+// A memory block (freed or allocated) has a header at the beginning (lowest address)
+// and a trailer (highest address) at its end. The header and trailer store the
+// block size. The size is the gross block size in terms of bytes. So it includes
+// the size of the header and the trailer. The sign bit of the block size indicates
+// whether the block is in allocated or freed state: sign bit set to 1 means
+// allocated and sign bit set to 0 means freed. A free block stores the links of
+// its size class list right after the header.
+//
+// An allocated block may carry an allocation site. Such a block is marked with
+// SITE_HEADER_PATTERN instead of HEADER_PATTERN and stores the site in the word
+// right in front of its trailer.
+
+typedef struct block_header {
+    word_t  size;       // < 0 -> allocated block; > 0 -> free block; == 0 -> invalid; gross block size in bytes := |size|
+    word_t  pat;        // HEADER_PATTERN
+} block_header_t;
+
+typedef struct free_links {
+    block_header_t* _Nullable   next;
+    block_header_t* _Nullable   prev;
+} free_links_t;
+
+typedef struct block_trailer {
+    word_t  pat;        // TRAILER_PATTERN
+    word_t  size;       // < 0 -> allocated block; > 0 -> free block; == 0 -> invalid; gross block size in bytes := |size|
+} block_trailer_t;
+
+#define __free_links(__bhdr) \
+((free_links_t*)(((char*)(__bhdr)) + sizeof(block_header_t)))
+
+#define __block_trailer(__bhdr, __gross_size) \
+((block_trailer_t*)(((char*)(__bhdr)) + (__gross_size) - sizeof(block_trailer_t)))
+
+#define __block_site(__bhdr, __gross_size) \
+((const char**)(((char*)(__bhdr)) + (__gross_size) - sizeof(block_trailer_t) - WORD_SIZE))
+
+#define __block_has_site(__bhdr) \
+((__bhdr)->pat == SITE_HEADER_PATTERN)
+
+#define __block_net_size(__bhdr) \
+(__abs((__bhdr)->size) - sizeof(block_header_t) - sizeof(block_trailer_t) - (__block_has_site(__bhdr) ? WORD_SIZE : 0))
+
+#define __validate_block_header(__bhdr) \
+((__bhdr)->pat == HEADER_PATTERN || (__bhdr)->pat == SITE_HEADER_PATTERN)
+
+#define __validate_block_trailer(__btrl) \
+((__btrl)->pat == TRAILER_PATTERN)
+
+
+// A memory region manages a contiguous range of memory.
+typedef struct mem_region {
+    struct mem_region* _Nullable    next;
+    char* _Nonnull                  lower;  // Lowest address from which to allocate (word aligned)
+    char* _Nonnull                  upper;  // Address just beyond the last allocatable address (word aligned)
+} mem_region_t;
+
+
+// An allocator manages memory from a pool of memory regions. The free blocks of
+// all regions share the same size class lists.
+struct tlsf {
+    mem_region_t* _Nonnull          first_region;
+    mem_region_t* _Nonnull          last_region;
+    tlsf_grow_func_t _Nullable      grow_func;
+    tlsf_release_func_t _Nullable   release_func;
+    tlsf_error_func_t _Nonnull      error_func;
+    size_t                          used_bytes;                 // gross size of all allocated blocks
+    size_t                          capacity;                   // gross size of all memory regions
+    size_t                          peak_used_bytes;
+    uint32_t                        allocs;
+    uint32_t                        frees;
+    uint32_t                        allocs_per_class[TLSF_SIZE_CLASS_COUNT];
+    uint32_t                        fl_bitmap;                  // bit fl is set if any size class of first level fl is populated
+    uint32_t                        sl_bitmap[FL_INDEX_COUNT];  // bit sl is set if size class [fl][sl] is populated
+    block_header_t* _Nullable       blocks[FL_INDEX_COUNT][SL_INDEX_COUNT];
+};
+
+
+// Returns the index of the most significant bit that is set in 'x'. 'x' must
+// not be 0.
+#define __fls(__x) \
+(31 - (int)leading_zeros_ul((unsigned long)(__x)))
+
+// Returns the index of the least significant bit that is set in 'x'. 'x' must
+// not be 0.
+#define __ffs(__x) \
+__fls((__x) & (~(__x) + 1))
+
+
+////////////////////////////////////////////////////////////////////////////////
+// MARK: -
+// MARK: Size Classes
+// MARK: -
+////////////////////////////////////////////////////////////////////////////////
+
+// Returns the size class of a free block of gross size 'size'.
+static void mapping_insert(size_t size, int* _Nonnull pOutFl, int* _Nonnull pOutSl)
+{
+    if (size < SMALL_BLOCK_SIZE) {
+        *pOutFl = 0;
+        *pOutSl = (int)size >> WORD_SIZE_LOG2;
+    }
+    else {
+        const int fl = __fls(size);
+
+        *pOutSl = (int)(size >> (fl - SL_INDEX_COUNT_LOG2)) ^ SL_INDEX_COUNT;
+        *pOutFl = fl - (FL_INDEX_SHIFT - 1);
+    }
+}
+
+// Returns 'size' rounded up to the next size class boundary. A free block of at
+// least this size is guaranteed to be found by mapping_search(size).
+static size_t mapping_search_size(size_t size)
+{
+    if (size >= SMALL_BLOCK_SIZE) {
+        size += ((size_t)1 << (__fls(size) - SL_INDEX_COUNT_LOG2)) - 1;
+    }
+    return size;
+}
+
+// Returns the first size class whose blocks are all at least 'size' bytes big.
+static void mapping_search(size_t size, int* _Nonnull pOutFl, int* _Nonnull pOutSl)
+{
+    mapping_insert(mapping_search_size(size), pOutFl, pOutSl);
+}
+
+// Returns the first free block in the size class [fl][sl] or the next bigger
+// populated size class. Updates 'fl' and 'sl' to the size class of the block.
+static block_header_t* _Nullable tlsf_find_suitable_block(tlsf_t _Nonnull self, int* _Nonnull pFl, int* _Nonnull pSl)
+{
+    int fl = *pFl;
+    uint32_t sl_map = self->sl_bitmap[fl] & (~0u << *pSl);
+
+    if (sl_map == 0) {
+        const uint32_t fl_map = self->fl_bitmap & (~0u << (fl + 1));
+
+        if (fl_map == 0) {
+            return NULL;
+        }
+
+        fl = __ffs(fl_map);
+        sl_map = self->sl_bitmap[fl];
+    }
+
+    const int sl = __ffs(sl_map);
+
+    *pFl = fl;
+    *pSl = sl;
+    return self->blocks[fl][sl];
+}
+
+// Returns the first free block of at least 'size' bytes in the size class that
+// 'size' itself maps to. The blocks in this class may be smaller than 'size'
+// which is why mapping_search() skips it. Searching it is the fallback for the
+// case that no bigger class has a free block.
+static block_header_t* _Nullable tlsf_find_block_in_class(tlsf_t _Nonnull self, size_t size)
+{
+    int fl, sl;
+
+    mapping_insert(size, &fl, &sl);
+
+    for (block_header_t* bhdr = self->blocks[fl][sl]; bhdr; bhdr = __free_links(bhdr)->next) {
+        if ((size_t)bhdr->size >= size) {
+            return bhdr;
+        }
+    }
+    return NULL;
+}
+
+// Adds the free block 'bhdr' to its size class list.
+static void tlsf_insert_free_block(tlsf_t _Nonnull self, block_header_t* _Nonnull bhdr)
+{
+    int fl, sl;
+
+    mapping_insert(bhdr->size, &fl, &sl);
+
+    block_header_t* head = self->blocks[fl][sl];
+    free_links_t* fp = __free_links(bhdr);
+
+    fp->prev = NULL;
+    fp->next = head;
+    if (head) {
+        __free_links(head)->prev = bhdr;
+    }
+    self->blocks[fl][sl] = bhdr;
+
+    self->fl_bitmap |= (1u << fl);
+    self->sl_bitmap[fl] |= (1u << sl);
+}
+
+// Removes the free block 'bhdr' from its size class list.
+static void tlsf_remove_free_block(tlsf_t _Nonnull self, block_header_t* _Nonnull bhdr)
+{
+    free_links_t* fp = __free_links(bhdr);
+    int fl, sl;
+
+    mapping_insert(bhdr->size, &fl, &sl);
+
+    if (fp->next) {
+        __free_links(fp->next)->prev = fp->prev;
+    }
+    if (fp->prev) {
+        __free_links(fp->prev)->next = fp->next;
+    }
+    else {
+        self->blocks[fl][sl] = fp->next;
+
+        if (fp->next == NULL) {
+            self->sl_bitmap[fl] &= ~(1u << sl);
+            if (self->sl_bitmap[fl] == 0) {
+                self->fl_bitmap &= ~(1u << fl);
+            }
+        }
+    }
+
+    fp->next = NULL;
+    fp->prev = NULL;
+}
+
+// Writes the header and trailer of a block of gross size 'size' at 'p'. 'size'
+// is negative for an allocated block and positive for a free block.
+static void tlsf_make_block(char* _Nonnull p, word_t size)
+{
+    block_header_t* bhdr = (block_header_t*)p;
+    block_trailer_t* btrl = __block_trailer(p, __abs(size));
+
+    bhdr->size = size;
+    bhdr->pat = HEADER_PATTERN;
+    btrl->size = size;
+    btrl->pat = TRAILER_PATTERN;
+}
+
+// Returns the gross block size for a request of 'nbytes' bytes.
+static word_t tlsf_gross_size(size_t nbytes)
+{
+    const word_t gross_nbytes = sizeof(block_header_t) + __Ceil_PowerOf2(nbytes, WORD_SIZE) + sizeof(block_trailer_t);
+
+    return (gross_nbytes >= MIN_GROSS_BLOCK_SIZE) ? gross_nbytes : MIN_GROSS_BLOCK_SIZE;
+}
+
+// Records the allocation site 'site' in the allocated block 'bhdr'. The block
+// must have room for the site in front of its trailer.
+static void tlsf_set_site(block_header_t* _Nonnull bhdr, const char* _Nullable site)
+{
+    bhdr->pat = SITE_HEADER_PATTERN;
+    *__block_site(bhdr, -bhdr->size) = site;
+}
+
+// Adds 'delta' bytes to the number of allocated bytes.
+static void tlsf_count_used(tlsf_t _Nonnull self, word_t delta)
+{
+    self->used_bytes += delta;
+    if (self->used_bytes > self->peak_used_bytes) {
+        self->peak_used_bytes = self->used_bytes;
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// MARK: -
+// MARK: Memory Regions
+// MARK: -
+////////////////////////////////////////////////////////////////////////////////
+
+// Initializes a new mem region structure in the given memory region and puts
+// all memory following the memory region header up to the top of the region on
+// the free lists as a single free block. Memory beyond the biggest block size
+// that the allocator supports is ignored.
+static mem_region_t* _Nullable mem_region_create(tlsf_t _Nonnull self, const mem_desc_t* _Nonnull md)
+{
+    char* bptr = __Ceil_Ptr_PowerOf2(md->lower, WORD_SIZE);
+    char* tptr = __Floor_Ptr_PowerOf2(md->upper, WORD_SIZE);
+
+    if (tptr < bptr) {
+        return NULL;
+    }
+    if ((tptr - bptr) < sizeof(mem_region_t) + MIN_GROSS_BLOCK_SIZE) {
+        return NULL;
+    }
+
+
+    // Places the memory region header at the very bottom of the memory region
+    mem_region_t* mr = (mem_region_t*)bptr;
+    mr->next = NULL;
+    mr->lower = __Ceil_Ptr_PowerOf2(bptr + sizeof(mem_region_t), WORD_SIZE);
+    mr->upper = tptr;
+
+    if ((mr->upper - mr->lower) > MAX_GROSS_BLOCK_SIZE) {
+        mr->upper = mr->lower + __Floor_PowerOf2(MAX_GROSS_BLOCK_SIZE, WORD_SIZE);
+    }
+
+
+    // Cover all the rest in the memory region with a single freed block
+    tlsf_make_block(mr->lower, mr->upper - mr->lower);
+    tlsf_insert_free_block(self, (block_header_t*)mr->lower);
+    self->capacity += mr->upper - mr->lower;
+
+    return mr;
+}
+
+// Returns true if the given memory address is managed by this memory region
+// and false otherwise.
+static bool mem_region_manages(const mem_region_t* _Nonnull mr, char* _Nullable addr)
+{
+    return (addr >= mr->lower && addr < mr->upper) ? true : false;
+}
+
+// Returns true if the given memory region consists of a single free block.
+static bool mem_region_isempty(const mem_region_t* _Nonnull mr)
+{
+    return (((block_header_t*)mr->lower)->size == (mr->upper - mr->lower)) ? true : false;
+}
+
+// Returns the header of the allocated block 'ptr'. Returns NULL and reports an
+// error if the block is corrupted or not allocated.
+static block_header_t* _Nullable mem_region_allocated_block(tlsf_t _Nonnull self, void* _Nonnull ptr, const char* _Nonnull funcName)
+{
+    block_header_t* bhdr = (block_header_t*)((char*)ptr - sizeof(block_header_t));
+
+    if (!__validate_block_header(bhdr)) {
+        self->error_func(MERR_CORRUPTION, funcName, ptr);
+        return NULL;
+    }
+    if (bhdr->size >= 0) {
+        self->error_func(MERR_DOUBLE_FREE, funcName, ptr);
+        return NULL;
+    }
+    if (!__validate_block_trailer(__block_trailer(bhdr, -bhdr->size))) {
+        self->error_func(MERR_CORRUPTION, funcName, ptr);
+        return NULL;
+    }
+
+    return bhdr;
+}
+
+// Returns the header of the block that follows the block 'bhdr' of gross size
+// 'gross_size' if it is free. Returns NULL if there is no successor or it is
+// allocated. Sets 'pOutCorrupted' to true if the successor is corrupted.
+static block_header_t* _Nullable mem_region_free_succ(mem_region_t* _Nonnull mr, block_header_t* _Nonnull bhdr, word_t gross_size, bool* _Nonnull pOutCorrupted)
+{
+    block_header_t* succ_hdr = (block_header_t*)((char*)bhdr + gross_size);
+
+    *pOutCorrupted = false;
+    if ((char*)succ_hdr >= mr->upper) {
+        return NULL;
+    }
+    if (!__validate_block_header(succ_hdr)) {
+        *pOutCorrupted = true;
+        return NULL;
+    }
+    if (succ_hdr->size < 0) {
+        return NULL;
+    }
+    if (!__validate_block_trailer(__block_trailer(succ_hdr, succ_hdr->size))) {
+        *pOutCorrupted = true;
+        return NULL;
+    }
+
+    return succ_hdr;
+}
+
+// Same as mem_region_free_succ() but for the block that precedes 'bhdr'.
+static block_header_t* _Nullable mem_region_free_pred(mem_region_t* _Nonnull mr, block_header_t* _Nonnull bhdr, bool* _Nonnull pOutCorrupted)
+{
+    *pOutCorrupted = false;
+    if ((char*)bhdr <= mr->lower) {
+        return NULL;
+    }
+
+    block_trailer_t* pred_trl = (block_trailer_t*)((char*)bhdr - sizeof(block_trailer_t));
+    if (!__validate_block_trailer(pred_trl)) {
+        *pOutCorrupted = true;
+        return NULL;
+    }
+    if (pred_trl->size < 0) {
+        return NULL;
+    }
+
+    block_header_t* pred_hdr = (block_header_t*)((char*)bhdr - pred_trl->size);
+    if (!__validate_block_header(pred_hdr)) {
+        *pOutCorrupted = true;
+        return NULL;
+    }
+
+    return pred_hdr;
+}
+
+// Splits the block 'bhdr' into an allocated block of 'gross_nbytes' bytes and a
+// free block that covers the rest. The whole block is turned into the allocated
+// block if the rest is too small to form a free block of its own.
+static void mem_region_split_alloc(tlsf_t _Nonnull self, block_header_t* _Nonnull bhdr, word_t gross_bsize, word_t gross_nbytes)
+{
+    const word_t gross_fsize = gross_bsize - gross_nbytes;
+
+    if (gross_fsize >= MIN_GROSS_BLOCK_SIZE) {
+        char* fp = (char*)bhdr + gross_nbytes;
+
+        tlsf_make_block((char*)bhdr, -gross_nbytes);
+        tlsf_make_block(fp, gross_fsize);
+        tlsf_insert_free_block(self, (block_header_t*)fp);
+    }
+    else {
+        tlsf_make_block((char*)bhdr, -gross_bsize);
+    }
+}
+
+// Deallocates the given memory block and merges it with its free neighbors.
+// Expects that the memory block is managed by the given mem region.
+static bool mem_region_free(tlsf_t _Nonnull self, mem_region_t* _Nonnull mr, void* _Nonnull ptr)
+{
+    block_header_t* bhdr = mem_region_allocated_block(self, ptr, "free");
+    bool corrupted;
+
+    if (bhdr == NULL) {
+        return false;
+    }
+
+    word_t gross_bsize = -bhdr->size;
+    block_trailer_t* btrl = __block_trailer(bhdr, gross_bsize);
+
+    self->used_bytes -= gross_bsize;
+    self->frees++;
+
+
+    // Merge with the successor if it is free
+    block_header_t* succ_hdr = mem_region_free_succ(mr, bhdr, gross_bsize, &corrupted);
+    if (corrupted) {
+        goto corruption;
+    }
+    if (succ_hdr) {
+        tlsf_remove_free_block(self, succ_hdr);
+
+        btrl->pat = 0;
+        succ_hdr->pat = 0;
+        gross_bsize += succ_hdr->size;
+    }
+
+
+    // Merge with the predecessor if it is free
+    block_header_t* pred_hdr = mem_region_free_pred(mr, bhdr, &corrupted);
+    if (corrupted) {
+        goto corruption;
+    }
+    if (pred_hdr) {
+        tlsf_remove_free_block(self, pred_hdr);
+
+        ((block_trailer_t*)((char*)bhdr - sizeof(block_trailer_t)))->pat = 0;
+        bhdr->pat = 0;
+        gross_bsize += pred_hdr->size;
+        bhdr = pred_hdr;
+    }
+
+
+    tlsf_make_block((char*)bhdr, gross_bsize);
+    tlsf_insert_free_block(self, bhdr);
+
+    return true;
+
+
+corruption:
+    self->error_func(MERR_CORRUPTION, "free", ptr);
+    return false;
+}
+
+// Attempts to resize the given memory block in place to 'new_size' bytes.
+// Shrinking always succeeds. Growing succeeds if the block is followed by a
+// free block that is big enough. Returns true on success and false otherwise.
+static bool mem_region_resize_block(tlsf_t _Nonnull self, mem_region_t* _Nonnull mr, void* _Nonnull ptr, size_t new_size)
+{
+    if (new_size > MAX_NET_BLOCK_SIZE) {
+        return false;
+    }
+
+    block_header_t* bhdr = mem_region_allocated_block(self, ptr, "realloc");
+    bool corrupted;
+
+    if (bhdr == NULL) {
+        return false;
+    }
+
+    const bool hasSite = __block_has_site(bhdr);
+    const char* site = (hasSite) ? *__block_site(bhdr, -bhdr->size) : NULL;
+    const word_t gross_bsize = -bhdr->size;
+    const word_t gross_new_size = tlsf_gross_size((hasSite) ? new_size + WORD_SIZE : new_size);
+    block_header_t* succ_hdr = mem_region_free_succ(mr, bhdr, gross_bsize, &corrupted);
+
+    if (corrupted) {
+        self->error_func(MERR_CORRUPTION, "realloc", ptr);
+        return false;
+    }
+
+    if (succ_hdr) {
+        // Merge the successor into the block and split the rest off again
+        const word_t avail_gross_size = gross_bsize + succ_hdr->size;
+
+        if (avail_gross_size < gross_new_size) {
+            return false;
+        }
+
+        tlsf_remove_free_block(self, succ_hdr);
+        __block_trailer(bhdr, gross_bsize)->pat = 0;
+        succ_hdr->pat = 0;
+        mem_region_split_alloc(self, bhdr, avail_gross_size, gross_new_size);
+    }
+    else if (gross_new_size <= gross_bsize) {
+        // Give the tail of the block back if it is big enough to form a free block
+        mem_region_split_alloc(self, bhdr, gross_bsize, gross_new_size);
+    }
+    else {
+        return false;
+    }
+
+    if (hasSite) {
+        tlsf_set_site(bhdr, site);
+    }
+    tlsf_count_used(self, -bhdr->size - gross_bsize);
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// MARK: -
+// MARK: Allocator
+// MARK: -
+////////////////////////////////////////////////////////////////////////////////
+
+// Allocates a new heap. The allocator state is placed at the bottom of 'md'.
+tlsf_t _Nullable __tlsf_create(const mem_desc_t* _Nonnull md, tlsf_grow_func_t _Nullable growFunc, tlsf_release_func_t _Nullable releaseFunc, tlsf_error_func_t _Nonnull errFunc)
+{
+    tlsf_t self = __Ceil_Ptr_PowerOf2(md->lower, WORD_SIZE);
+    mem_desc_t rmd;
+
+    if (md->upper < (char*)self || (md->upper - (char*)self) < sizeof(struct tlsf)) {
+        return NULL;
+    }
+
+    memset(self, 0, sizeof(struct tlsf));
+    self->grow_func = growFunc;
+    self->release_func = releaseFunc;
+    self->error_func = errFunc;
+
+    rmd.lower = (char*)self + sizeof(struct tlsf);
+    rmd.upper = md->upper;
+    mem_region_t* mr = mem_region_create(self, &rmd);
+    if (mr == NULL) {
+        return NULL;
+    }
+
+    self->first_region = mr;
+    self->last_region = mr;
+
+    return self;
+}
+
+// Returns the MemRegion managing the given address. NULL is returned if this
+// allocator does not manage the given address.
+static mem_region_t* _Nullable __tlsf_getmemregion(tlsf_t _Nonnull self, void* _Nullable addr)
+{
+    mem_region_t* mr = self->first_region;
+
+    while (mr) {
+        if (mem_region_manages(mr, addr)) {
+            return mr;
+        }
+
+        mr = mr->next;
+    }
+
+    return NULL;
+}
+
+// Same as __tlsf_getmemregion() but also returns the predecessor of the memory
+// region.
+static mem_region_t* _Nullable __tlsf_getmemregion_pred(tlsf_t _Nonnull self, void* _Nullable addr, mem_region_t* _Nullable * _Nonnull pOutPred)
+{
+    mem_region_t* pmr = NULL;
+    mem_region_t* mr = self->first_region;
+
+    while (mr) {
+        if (mem_region_manages(mr, addr)) {
+            *pOutPred = pmr;
+            return mr;
+        }
+
+        pmr = mr;
+        mr = mr->next;
+    }
+
+    *pOutPred = NULL;
+    return NULL;
+}
+
+// Removes the empty memory region 'mr' from the allocator and hands it to the
+// release function. 'mr' is put back in place if the release function declines
+// to take it. The first memory region is never released since it stores the
+// allocator itself.
+static void __tlsf_releasememregion(tlsf_t _Nonnull self, mem_region_t* _Nonnull pmr, mem_region_t* _Nonnull mr)
+{
+    block_header_t* bhdr = (block_header_t*)mr->lower;
+    mem_region_t* nmr = mr->next;
+    const size_t mrSize = mr->upper - mr->lower;
+    mem_desc_t md;
+
+    md.lower = (char*)mr;
+    md.upper = mr->upper;
+
+    tlsf_remove_free_block(self, bhdr);
+    pmr->next = nmr;
+    if (self->last_region == mr) {
+        self->last_region = pmr;
+    }
+
+    if (self->release_func(self, &md)) {
+        self->capacity -= mrSize;
+    }
+    else {
+        pmr->next = mr;
+        if (self->last_region == pmr) {
+            self->last_region = mr;
+        }
+        tlsf_insert_free_block(self, bhdr);
+    }
+}
+
+bool __tlsf_isvalidptr(tlsf_t _Nonnull self, void* _Nullable ptr)
+{
+    if (ptr == NULL || ((uintptr_t) ptr) == UINTPTR_MAX) {
+        // Any allocator can take responsibility of that since deallocating these
+        // things is a NOP anyway
+        return true;
+    }
+
+    return __tlsf_getmemregion(self, ptr) != NULL;
+}
+
+// Adds the given memory region to the allocator's available memory pool.
+errno_t __tlsf_add_memregion(tlsf_t _Nonnull self, const mem_desc_t* _Nonnull md)
+{
+    if (md->lower == NULL || md->upper == md->lower) {
+        return EINVAL;
+    }
+
+    mem_region_t* mr = mem_region_create(self, md);
+    if (mr) {
+        self->last_region->next = mr;
+        self->last_region = mr;
+        return EOK;
+    }
+    return ENOMEM;
+}
+
+static errno_t __tlsf_trygrowstore(tlsf_t _Nonnull self, size_t minByteCount)
+{
+    if (self->grow_func && self->grow_func(self, minByteCount)) {
+        return EOK;
+    }
+    return ENOMEM;
+}
+
+void* _Nullable __tlsf_alloc(tlsf_t _Nonnull self, size_t nbytes)
+{
+    return __tlsf_alloc_site(self, nbytes, NULL);
+}
+
+void* _Nullable __tlsf_alloc_site(tlsf_t _Nonnull self, size_t nbytes, const char* _Nullable site)
+{
+    // Return the "empty memory block singleton" if the requested size is 0
+    if (nbytes == 0) {
+        return (void*)UINTPTR_MAX;
+    }
+    if (nbytes > MAX_NET_BLOCK_SIZE - ((site) ? WORD_SIZE : 0)) {
+        return NULL;
+    }
+
+
+    // Find the first size class that is guaranteed to hold a big enough block
+    const word_t gross_nbytes = tlsf_gross_size((site) ? nbytes + WORD_SIZE : nbytes);
+    int fl, sl;
+
+    mapping_search(gross_nbytes, &fl, &sl);
+    block_header_t* bhdr = tlsf_find_suitable_block(self, &fl, &sl);
+    if (bhdr == NULL) {
+        bhdr = tlsf_find_block_in_class(self, gross_nbytes);
+    }
+
+
+    // Try expanding the backing store if we've exhausted our existing memory
+    // regions. The new region must be big enough for a block that the search
+    // above is guaranteed to find
+    if (bhdr == NULL) {
+        if (__tlsf_trygrowstore(self, mapping_search_size(gross_nbytes)) == EOK) {
+            mapping_search(gross_nbytes, &fl, &sl);
+            bhdr = tlsf_find_suitable_block(self, &fl, &sl);
+        }
+
+        if (bhdr == NULL) {
+            return NULL;
+        }
+    }
+
+    if (!__validate_block_header(bhdr) || !__validate_block_trailer(__block_trailer(bhdr, bhdr->size))) {
+        self->error_func(MERR_CORRUPTION, "alloc", (char*)bhdr + sizeof(block_header_t));
+        return NULL;
+    }
+
+
+    // Split the front portion off for our new allocated block and put the rest
+    // back on the free lists
+    tlsf_remove_free_block(self, bhdr);
+    mem_region_split_alloc(self, bhdr, bhdr->size, gross_nbytes);
+
+    if (site) {
+        tlsf_set_site(bhdr, site);
+    }
+    tlsf_count_used(self, -bhdr->size);
+    self->allocs++;
+    self->allocs_per_class[__min(__fls(nbytes), TLSF_SIZE_CLASS_COUNT - 1)]++;
+
+    return ((char*)bhdr) + sizeof(block_header_t);
+}
+
+// Attempts to deallocate the given memory block. Returns EOK on success and
+// ENOTBLK if the allocator does not manage the given memory block.
+errno_t __tlsf_dealloc(tlsf_t _Nonnull self, void* _Nullable ptr)
+{
+    if (ptr == NULL || ((uintptr_t) ptr) == UINTPTR_MAX) {
+        return EOK;
+    }
+
+    // Find out which memory region contains the block that we want to free
+    mem_region_t* pmr;
+    mem_region_t* mr = __tlsf_getmemregion_pred(self, ptr, &pmr);
+    if (mr == NULL) {
+        // 'ptr' isn't managed by this allocator
+        return ENOTBLK;
+    }
+
+
+    // Free the memory block and give the region back if nothing is allocated
+    // from it anymore
+    if (mem_region_free(self, mr, ptr) && pmr && self->release_func && mem_region_isempty(mr)) {
+        __tlsf_releasememregion(self, pmr, mr);
+    }
+
+    return EOK;
+}
+
+void* _Nullable __tlsf_realloc(tlsf_t _Nonnull self, void * _Nullable ptr, size_t new_size)
+{
+    if (ptr == NULL || ((uintptr_t) ptr) == UINTPTR_MAX) {
+        return __tlsf_alloc(self, new_size);
+    }
+
+    if (new_size == 0) {
+        return NULL;
+    }
+
+
+    mem_region_t* mr = __tlsf_getmemregion(self, ptr);
+    if (mr == NULL) {
+        // 'ptr' isn't managed by this allocator
+        return NULL;
+    }
+
+
+    // Try resizing the block in place
+    if (mem_region_resize_block(self, mr, ptr, new_size)) {
+        return ptr;
+    }
+
+
+    // No luck, allocate a new block of memory and copy the data over
+    size_t old_size;
+    if (__tlsf_getblocksize(self, ptr, &old_size) != EOK) {
+        return NULL;
+    }
+
+    block_header_t* bhdr = (block_header_t*)((char*)ptr - sizeof(block_header_t));
+    const char* site = (__block_has_site(bhdr)) ? *__block_site(bhdr, -bhdr->size) : NULL;
+    void* np = __tlsf_alloc_site(self, new_size, site);
+    if (np) {
+        memcpy(np, ptr, __min(old_size, new_size));
+        __tlsf_dealloc(self, ptr);
+    }
+
+    return np;
+}
+
+// Returns the size of the given memory block. This is the size minus the block
+// header and plus whatever additional memory the allocator added based on its
+// internal alignment constraints.
+errno_t __tlsf_getblocksize(tlsf_t _Nonnull self, void* _Nullable ptr, size_t* _Nonnull pOutSize)
+{
+    if (ptr == NULL || ((uintptr_t) ptr) == UINTPTR_MAX) {
+        *pOutSize = 0;
+        return EOK;
+    }
+
+
+    // Make sure that we actually manage this memory block
+    if (__tlsf_getmemregion(self, ptr) == NULL) {
+        // 'ptr' isn't managed by this allocator
+        return ENOTBLK;
+    }
+
+    block_header_t* bhdr = (block_header_t*)((char*)ptr - sizeof(block_header_t));
+    if (!__validate_block_header(bhdr)) {
+        self->error_func(MERR_CORRUPTION, "size", ptr);
+        *pOutSize = 0;
+        return EOK;
+    }
+
+    *pOutSize = __block_net_size(bhdr);
+    return EOK;
+}
+
+const char* _Nullable __tlsf_getblocksite(tlsf_t _Nonnull self, void* _Nullable ptr)
+{
+    if (ptr == NULL || ((uintptr_t) ptr) == UINTPTR_MAX || __tlsf_getmemregion(self, ptr) == NULL) {
+        return NULL;
+    }
+
+    block_header_t* bhdr = (block_header_t*)((char*)ptr - sizeof(block_header_t));
+    if (!__validate_block_header(bhdr) || bhdr->size >= 0) {
+        self->error_func(MERR_CORRUPTION, "site", ptr);
+        return NULL;
+    }
+
+    return (__block_has_site(bhdr)) ? *__block_site(bhdr, -bhdr->size) : NULL;
+}
+
+size_t __tlsf_getfreebytes(tlsf_t _Nonnull self)
+{
+    return self->capacity - self->used_bytes;
+}
+
+size_t __tlsf_allocsize(void* _Nullable ptr)
+{
+    if (ptr == NULL || ((uintptr_t) ptr) == UINTPTR_MAX) {
+        return 0;
+    }
+
+    block_header_t* bhdr = (block_header_t*)((char*)ptr - sizeof(block_header_t));
+    if (bhdr->pat != HEADER_PATTERN || bhdr->size >= 0) {
+        return 0;
+    }
+
+    return -bhdr->size - sizeof(block_header_t) - sizeof(block_trailer_t);
+}
+
+// Invokes 'func' for every block of every memory region. Stops and reports the
+// corruption if it runs into a damaged block.
+static void __tlsf_walk(tlsf_t _Nonnull self, void (*func)(void* _Nonnull ctx, block_header_t* _Nonnull bhdr), void* _Nonnull ctx)
+{
+    mem_region_t* mr = self->first_region;
+
+    while (mr) {
+        char* p = mr->lower;
+
+        while (p < mr->upper) {
+            block_header_t* bhdr = (block_header_t*)p;
+            const word_t gross_bsize = __abs(bhdr->size);
+
+            if (!__validate_block_header(bhdr) || gross_bsize < MIN_GROSS_BLOCK_SIZE || gross_bsize > mr->upper - p
+                || !__validate_block_trailer(__block_trailer(bhdr, gross_bsize))) {
+                self->error_func(MERR_CORRUPTION, "walk", p + sizeof(block_header_t));
+                return;
+            }
+
+            func(ctx, bhdr);
+            p += gross_bsize;
+        }
+
+        mr = mr->next;
+    }
+}
+
+static void __tlsf_info_block(void* _Nonnull ctx, block_header_t* _Nonnull bhdr)
+{
+    tlsf_info_t* ip = ctx;
+
+    if (bhdr->size < 0) {
+        ip->used_block_count++;
+    }
+    else {
+        const size_t net_size = __block_net_size(bhdr);
+
+        ip->free_bytes += bhdr->size;
+        ip->free_block_count++;
+        if (net_size > ip->largest_free_size) {
+            ip->largest_free_size = net_size;
+        }
+    }
+}
+
+void __tlsf_getinfo(tlsf_t _Nonnull self, tlsf_info_t* _Nonnull pOutInfo)
+{
+    memset(pOutInfo, 0, sizeof(tlsf_info_t));
+    pOutInfo->used_bytes = self->used_bytes;
+    pOutInfo->peak_used_bytes = self->peak_used_bytes;
+    pOutInfo->allocs = self->allocs;
+    pOutInfo->frees = self->frees;
+    memcpy(pOutInfo->allocs_per_class, self->allocs_per_class, sizeof(self->allocs_per_class));
+
+    for (mem_region_t* mr = self->first_region; mr; mr = mr->next) {
+        pOutInfo->region_count++;
+    }
+
+    __tlsf_walk(self, __tlsf_info_block, pOutInfo);
+}
+
+
+typedef struct tlsf_visit_ctx {
+    tlsf_visit_func_t _Nonnull  func;
+    void* _Nullable             ctx;
+} tlsf_visit_ctx_t;
+
+static void __tlsf_visit_block(void* _Nonnull ctx, block_header_t* _Nonnull bhdr)
+{
+    tlsf_visit_ctx_t* vp = ctx;
+
+    if (bhdr->size < 0) {
+        const char* site = (__block_has_site(bhdr)) ? *__block_site(bhdr, -bhdr->size) : NULL;
+
+        vp->func(vp->ctx, (char*)bhdr + sizeof(block_header_t), __block_net_size(bhdr), site);
+    }
+}
+
+void __tlsf_visit(tlsf_t _Nonnull self, tlsf_visit_func_t _Nonnull func, void* _Nullable ctx)
+{
+    tlsf_visit_ctx_t vc;
+
+    vc.func = func;
+    vc.ctx = ctx;
+    __tlsf_walk(self, __tlsf_visit_block, &vc);
+}
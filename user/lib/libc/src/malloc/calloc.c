@@ -21,3 +21,14 @@ void *calloc(size_t num, size_t size)
     }
     return p;
 }
+
+void *__calloc_site(size_t num, size_t size, const char* _Nullable site)
+{
+    const size_t len = num * size;
+    void *p = __malloc_site(len, site);
+
+    if (p) {
+        memset(p, 0, len);
+    }
+    return p;
+}
@@ -12,7 +12,13 @@
 
 void free(void *ptr)
 {
+    // Check for a large block first since __mcache_free() looks at the block
+    // header
+    if (ptr == NULL || __mlarge_free(ptr) || __mcache_free(ptr)) {
+        return;
+    }
+
     __malloc_lock();
-    __lsta_dealloc(__gMainAllocator, ptr);
+    __tlsf_dealloc(__gMainAllocator, ptr);
     __malloc_unlock();
 }
@@ -12,13 +12,43 @@
 
 void *malloc(size_t size)
 {
-    __malloc_lock();
-    void* ptr = __lsta_alloc(__gMainAllocator, size);
+    void* ptr;
+
+    if (size > 0 && size <= MCACHE_MAX_SIZE) {
+        ptr = __mcache_alloc(size);
+    }
+    else {
+        ptr = (size >= MLARGE_MIN_SIZE) ? __mlarge_alloc(size, NULL) : NULL;
+
+        if (ptr == NULL) {
+            __malloc_lock();
+            ptr = __tlsf_alloc(__gMainAllocator, size);
+            __malloc_unlock();
+        }
+    }
     
     if (ptr == NULL) {
         __malloc_nomem();
     }
-    __malloc_unlock();
+
+    return ptr;
+}
+
+// Blocks that carry an allocation site bypass the per-vcpu caches so that the
+// site always names the code that allocated the block.
+void *__malloc_site(size_t size, const char* _Nullable site)
+{
+    void* ptr = (size >= MLARGE_MIN_SIZE) ? __mlarge_alloc(size, site) : NULL;
+
+    if (ptr == NULL) {
+        __malloc_lock();
+        ptr = __tlsf_alloc_site(__gMainAllocator, size, site);
+        __malloc_unlock();
+    }
+
+    if (ptr == NULL) {
+        __malloc_nomem();
+    }
 
     return ptr;
 }
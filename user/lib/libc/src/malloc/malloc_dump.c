@@ -0,0 +1,71 @@
+//
+//  malloc_dump.c
+//  libc
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "__malloc.h"
+
+#define DUMP_BATCH_SIZE 16
+
+
+typedef struct dump_entry {
+    void* _Nonnull          ptr;
+    size_t                  size;
+    const char* _Nonnull    site;
+} dump_entry_t;
+
+// The heap is walked in batches because stdio may allocate memory and thus
+// can't be called while the heap is locked. 'skip' is the number of blocks with
+// an allocation site that earlier batches have already covered.
+typedef struct dump_batch {
+    size_t          skip;
+    int             count;
+    dump_entry_t    entry[DUMP_BATCH_SIZE];
+} dump_batch_t;
+
+
+static void _dump_block(void* _Nullable ctx, void* _Nonnull ptr, size_t size, const char* _Nullable site)
+{
+    dump_batch_t* bp = ctx;
+
+    if (site == NULL) {
+        return;
+    }
+
+    if (bp->skip > 0) {
+        bp->skip--;
+    }
+    else if (bp->count < DUMP_BATCH_SIZE) {
+        bp->entry[bp->count].ptr = ptr;
+        bp->entry[bp->count].size = size;
+        bp->entry[bp->count].site = site;
+        bp->count++;
+    }
+}
+
+void malloc_dump(void)
+{
+    dump_batch_t batch;
+    size_t ndumped = 0;
+
+    do {
+        batch.skip = ndumped;
+        batch.count = 0;
+
+        __malloc_lock();
+        __tlsf_visit(__gMainAllocator, _dump_block, &batch);
+        __mlarge_visit(_dump_block, &batch);
+        __malloc_unlock();
+
+        for (int i = 0; i < batch.count; i++) {
+            fprintf(stderr, "%p %zu %s\n", batch.entry[i].ptr, batch.entry[i].size, batch.entry[i].site);
+        }
+
+        ndumped += batch.count;
+    } while (batch.count == DUMP_BATCH_SIZE);
+}
@@ -0,0 +1,39 @@
+//
+//  malloc_getstats.c
+//  libc
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#include <stdlib.h>
+#include <string.h>
+#include "__malloc.h"
+
+#if MALLOC_SIZE_CLASS_COUNT != TLSF_SIZE_CLASS_COUNT
+#error "MALLOC_SIZE_CLASS_COUNT must match TLSF_SIZE_CLASS_COUNT"
+#endif
+
+
+void malloc_getstats(malloc_stats_t* _Nonnull stats)
+{
+    tlsf_info_t info;
+
+    __malloc_lock();
+    __tlsf_getinfo(__gMainAllocator, &info);
+    __mlarge_getinfo(&stats->large_block_count, &stats->large_bytes);
+    __malloc_unlock();
+
+    stats->used_bytes = info.used_bytes;
+    stats->peak_used_bytes = info.peak_used_bytes;
+    stats->free_bytes = info.free_bytes;
+    stats->largest_free_size = info.largest_free_size;
+    stats->used_block_count = info.used_block_count;
+    stats->free_block_count = info.free_block_count;
+    stats->region_count = info.region_count;
+    stats->allocs = info.allocs;
+    stats->frees = info.frees;
+    for (int i = 0; i < MALLOC_SIZE_CLASS_COUNT; i++) {
+        stats->allocs_per_class[i] = info.allocs_per_class[i];
+    }
+}
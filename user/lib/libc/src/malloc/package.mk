@@ -39,7 +39,7 @@ $(MALLOC_OBJS_DIR)/%.o : $(MALLOC_SOURCES_DIR)/%.c
 # Build variables
 #
 
-MALLOC_SC_SOURCES := $(MALLOC_SOURCES_DIR)/__lsta.c
+MALLOC_SC_SOURCES := $(MALLOC_SOURCES_DIR)/__tlsf.c
 
 MALLOC_SC_OBJS := $(patsubst $(MALLOC_SOURCES_DIR)/%.c,$(MALLOC_SC_OBJS_DIR)/%.o,$(MALLOC_SC_SOURCES))
 MALLOC_SC_DEPS := $(MALLOC_SC_OBJS:.o=.d)
@@ -7,18 +7,50 @@
 //
 
 #include <stdlib.h>
+#include <string.h>
+#include <ext/math.h>
 #include "__malloc.h"
 
 
-void *realloc(void *ptr, size_t new_size)
+// Moves the main allocator block 'ptr' to a region of its own. The region keeps
+// the allocation site of the block. Returns NULL if no region is available.
+static void* _Nullable __realloc_to_large(void* _Nonnull ptr, size_t new_size)
 {
+    size_t old_size = 0;
+
     __malloc_lock();
-    void* np = __lsta_realloc(__gMainAllocator, ptr, new_size);
+    __tlsf_getblocksize(__gMainAllocator, ptr, &old_size);
+    const char* site = __tlsf_getblocksite(__gMainAllocator, ptr);
+    __malloc_unlock();
+
+    void* np = __mlarge_alloc(new_size, site);
+    if (np) {
+        memcpy(np, ptr, __min(old_size, new_size));
+        free(ptr);
+    }
+
+    return np;
+}
+
+void *realloc(void *ptr, size_t new_size)
+{
+    void* np;
+
+    if (__mlarge_realloc(ptr, new_size, &np)) {
+        // 'ptr' is a large block
+    }
+    else if (ptr == NULL) {
+        return malloc(new_size);
+    }
+    else if (new_size < MLARGE_MIN_SIZE || (np = __realloc_to_large(ptr, new_size)) == NULL) {
+        __malloc_lock();
+        np = __tlsf_realloc(__gMainAllocator, ptr, new_size);
+        __malloc_unlock();
+    }
 
     if (np == NULL) {
         __malloc_nomem();
     }
-    __malloc_unlock();
     
     return np;
 }
@@ -21,6 +21,7 @@ int proc_spawnattr_init(proc_spawnattr_t* _Nonnull attr)
     attr->flags = 0;
     attr->quantum_boost = 0;
     attr->nice = 0;
+    attr->stack_size = 0;
 
     return 0;
 }
@@ -161,3 +162,15 @@ int proc_spawnattr_setschedparam(proc_spawnattr_t* _Nonnull attr, int type, cons
             return -1;
     }
 }
+
+
+size_t proc_spawnattr_stacksize(const proc_spawnattr_t* _Nonnull attr)
+{
+    return attr->stack_size;
+}
+
+int proc_spawnattr_setstacksize(proc_spawnattr_t* _Nonnull attr, size_t size)
+{
+    attr->stack_size = size;
+    return 0;
+}
@@ -0,0 +1,71 @@
+//
+//  scring.c
+//  libc
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#include <errno.h>
+#include <string.h>
+#include <kpi/syscall.h>
+#include <serena/scring.h>
+
+
+int scring_init(scring_t* _Nonnull ring, scring_sqe_t* _Nonnull sqes, scring_cqe_t* _Nonnull cqes, size_t nentries)
+{
+    if (nentries == 0 || nentries > SCRING_MAX_ENTRIES || (nentries & (nentries - 1)) != 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    ring->sq_head = 0;
+    ring->sq_tail = 0;
+    ring->cq_head = 0;
+    ring->cq_tail = 0;
+    ring->mask = nentries - 1;
+    ring->sqes = sqes;
+    ring->cqes = cqes;
+
+    return 0;
+}
+
+scring_sqe_t* _Nullable scring_sqe(scring_t* _Nonnull ring, int scno, intptr_t udata)
+{
+    if (ring->sq_tail - ring->sq_head > ring->mask) {
+        return NULL;
+    }
+
+    scring_sqe_t* sqe = &ring->sqes[ring->sq_tail & ring->mask];
+    sqe->scno = scno;
+    sqe->reserved = 0;
+    sqe->udata = udata;
+    memset(sqe->args, 0, sizeof(sqe->args));
+    ring->sq_tail++;
+
+    return sqe;
+}
+
+int scring_submit(scring_t* _Nonnull ring)
+{
+    int count = 0;
+
+    if (ring->sq_head == ring->sq_tail) {
+        return 0;
+    }
+
+    if (_syscall(SC_scring_enter, ring, &count) < 0) {
+        return -1;
+    }
+
+    return count;
+}
+
+const scring_cqe_t* _Nullable scring_cqe(scring_t* _Nonnull ring)
+{
+    if (ring->cq_head == ring->cq_tail) {
+        return NULL;
+    }
+
+    return &ring->cqes[ring->cq_head++ & ring->mask];
+}
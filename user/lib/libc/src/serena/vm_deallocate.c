@@ -0,0 +1,16 @@
+//
+//  vm_deallocate.c
+//  libc
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#include <serena/vm.h>
+#include <kpi/syscall.h>
+
+
+int vm_deallocate(void* _Nonnull ptr, size_t nbytes)
+{
+    return (int)_syscall(SC_vm_deallocate, ptr, nbytes);
+}
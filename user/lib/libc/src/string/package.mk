@@ -60,9 +60,6 @@ $(STRING_OBJS_DIR)/%.o : $(STRING_SOURCES_DIR)/%.c
 STRING_SC_SOURCES := $(STRING_SOURCES_DIR)/ctype.c \
 					 $(STRING_SOURCES_DIR)/memchr.c \
 					 $(STRING_SOURCES_DIR)/memcmp.c \
-					 $(STRING_SOURCES_DIR)/memcpy.c \
-					 $(STRING_SOURCES_DIR)/memmove.c \
-					 $(STRING_SOURCES_DIR)/memset.c \
 					 $(STRING_SOURCES_DIR)/strcat.c \
 					 $(STRING_SOURCES_DIR)/strchr.c \
 					 $(STRING_SOURCES_DIR)/strcmp.c \
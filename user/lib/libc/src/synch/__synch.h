@@ -11,10 +11,12 @@
 
 #include <errno.h>
 #include <ext/nanotime.h>
+#include <limits.h>
 #include <serena/cnd.h>
 #include <serena/mtx.h>
 #include <serena/sem.h>
 #include <serena/synch.h>
+#include <serena/vcpu.h>
 #include <stdbool.h>
 
 __CPP_BEGIN
@@ -44,12 +46,27 @@ __CPP_BEGIN
 #define _MTX_RECURSIVE(__self) \
 (((__self)->caps & mtx_recursive) != 0)
 
+#define _MTX_INHERIT(__self) \
+(((__self)->caps & mtx_inherit) != 0)
+
 
 // mtx states
 #define _MTX_AVAILABLE  0   /* Noone os holding the mutex */
 #define _MTX_LOCKED     1   /* Mutex is locked and noone else is trying to get it */
 #define _MTX_CONTENDED  2   /* Mutex is locked and at least one other vcpu is trying to get it */
 
+
+// mtx_inherit states. The state word holds the id of the owning vcpu so that a
+// waiter always lends its priority to the vcpu that held the mutex at the time
+// it blocked. The waiters bit is set while at least one other vcpu is trying
+// to get the mutex
+#define _MTX_PI_WAITERS INT_MIN
+#define _MTX_PI_OWNER(__s)  ((vcpuid_t)((__s) & ~_MTX_PI_WAITERS))
+
+
+extern errno_t __mtx_lock_pi(mtx_t* _Nonnull self, int flags, const nanotime_t* _Nullable wtp);
+extern void __mtx_unlock_pi(mtx_t* _Nonnull self);
+
 extern bool __sem_trywait(sem_t* _Nonnull self);
 
 __CPP_END
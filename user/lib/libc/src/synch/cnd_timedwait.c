@@ -19,8 +19,13 @@ errno_t cnd_timedwait(cnd_t* _Nonnull self, mtx_t* _Nonnull mutex, int flags, co
     int r = woa_wait(&self->seq, seq, flags, wtp);
 
     // Note that we need to acquire the mutex even if the timed wait timed out.
-    while (atomic_int_exchange(&mutex->state, _MTX_CONTENDED) != _MTX_AVAILABLE) {
-        woa_wait(&mutex->state, _MTX_CONTENDED, 0, NULL);
+    if (_MTX_INHERIT(mutex)) {
+        __mtx_lock_pi(mutex, 0, NULL);
+    }
+    else {
+        while (atomic_int_exchange(&mutex->state, _MTX_CONTENDED) != _MTX_AVAILABLE) {
+            woa_wait(&mutex->state, _MTX_CONTENDED, 0, NULL);
+        }
     }
 
     return (r == 0) ? EOK : errno;
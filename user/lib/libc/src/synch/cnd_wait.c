@@ -18,8 +18,13 @@ errno_t cnd_wait(cnd_t* _Nonnull self, mtx_t* _Nonnull mutex)
 
     woa_wait(&self->seq, seq, 0, NULL);
 
-    while (atomic_int_exchange(&mutex->state, _MTX_CONTENDED) != _MTX_AVAILABLE) {
-        woa_wait(&mutex->state, _MTX_CONTENDED, 0, NULL);
+    if (_MTX_INHERIT(mutex)) {
+        __mtx_lock_pi(mutex, 0, NULL);
+    }
+    else {
+        while (atomic_int_exchange(&mutex->state, _MTX_CONTENDED) != _MTX_AVAILABLE) {
+            woa_wait(&mutex->state, _MTX_CONTENDED, 0, NULL);
+        }
     }
 
     return EOK;
@@ -10,7 +10,7 @@
 
 errno_t mtx_init(mtx_t* _Nonnull self, int type)
 {
-    switch (type) {
+    switch (type & ~mtx_inherit) {
         case mtx_plain:
         case mtx_timed:
             break;
@@ -12,6 +12,16 @@
 
 errno_t mtx_lock(mtx_t* _Nonnull self)
 {
+    if (_MTX_INHERIT(self)) {
+        int s = _MTX_AVAILABLE;
+
+        if (atomic_int_compare_exchange_strong(&self->state, &s, (int)vcpu_id(vcpu_self()))) {
+            return EOK;
+        }
+        return __mtx_lock_pi(self, 0, NULL);
+    }
+
+
     int s = _MTX_AVAILABLE;
     atomic_int_compare_exchange_strong(&self->state, &s, _MTX_LOCKED);
 
@@ -0,0 +1,56 @@
+//
+//  mtx_pi.c
+//  libc
+//
+//  Based on: https://www.akkadia.org/drepper/futex.pdf
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#include "__synch.h"
+
+
+// Slow path of the mtx_inherit lock functions. Blocks until the mutex can be
+// taken or the timeout 'wtp' (if any) has expired. The waiter passes the owner
+// id that it read from the state word together with the state word itself to
+// the kernel. The kernel only blocks the waiter if the state word still holds
+// this value and thus the priority is always lent to the actual owner.
+errno_t __mtx_lock_pi(mtx_t* _Nonnull self, int flags, const nanotime_t* _Nullable wtp)
+{
+    const int me = (int)vcpu_id(vcpu_self());
+    int s = atomic_int_load(&self->state);
+
+    for (;;) {
+        if (s == _MTX_AVAILABLE) {
+            // Keep the waiters bit set since we don't know whether there are
+            // other vcpus still blocked on the mutex
+            if (atomic_int_compare_exchange_strong(&self->state, &s, me | _MTX_PI_WAITERS)) {
+                return EOK;
+            }
+            continue;
+        }
+
+        if ((s & _MTX_PI_WAITERS) == 0) {
+            if (!atomic_int_compare_exchange_strong(&self->state, &s, s | _MTX_PI_WAITERS)) {
+                continue;
+            }
+            s |= _MTX_PI_WAITERS;
+        }
+
+        if (woa_wait_pi(&self->state, s, _MTX_PI_OWNER(s), flags, wtp) != 0) {
+            return errno;
+        }
+        s = atomic_int_load(&self->state);
+    }
+}
+
+void __mtx_unlock_pi(mtx_t* _Nonnull self)
+{
+    int s = (int)vcpu_id(vcpu_self());
+
+    if (!atomic_int_compare_exchange_strong(&self->state, &s, _MTX_AVAILABLE)) {
+        atomic_int_store(&self->state, _MTX_AVAILABLE);
+        woa_wakeup(&self->state, WAKEUP_ONE);
+    }
+}
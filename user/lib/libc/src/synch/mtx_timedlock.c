@@ -20,10 +20,9 @@ errno_t mtx_timedlock(mtx_t* _Nonnull self, int flags, const nanotime_t* _Nonnul
 
     int r = 0;
     int s = _MTX_AVAILABLE;
-    atomic_int_compare_exchange_strong(&self->state, &s, _MTX_LOCKED);
+    atomic_int_compare_exchange_strong(&self->state, &s, (_MTX_INHERIT(self)) ? (int)vcpu_id(vcpu_self()) : _MTX_LOCKED);
 
     if (s != _MTX_AVAILABLE) {
-        int r = 0;
         nanotime_t now, a_timeout;
 
         if ((flags & TIMER_ABSTIME) == TIMER_ABSTIME) {
@@ -35,6 +34,10 @@ errno_t mtx_timedlock(mtx_t* _Nonnull self, int flags, const nanotime_t* _Nonnul
             flags |= TIMER_ABSTIME;
         }
 
+        if (_MTX_INHERIT(self)) {
+            return __mtx_lock_pi(self, flags, &a_timeout);
+        }
+
 
         if (s != _MTX_CONTENDED) {
             s = atomic_int_exchange(&self->state, _MTX_CONTENDED);
@@ -10,8 +10,9 @@
 
 errno_t mtx_trylock(mtx_t* _Nonnull self)
 {
+    const int locked = (_MTX_INHERIT(self)) ? (int)vcpu_id(vcpu_self()) : _MTX_LOCKED;
     int s = _MTX_AVAILABLE;
-    atomic_int_compare_exchange_strong(&self->state, &s, _MTX_LOCKED);
+    atomic_int_compare_exchange_strong(&self->state, &s, locked);
     
     return (s == _MTX_AVAILABLE) ? EOK : EAGAIN;
 }
@@ -12,6 +12,11 @@
 
 errno_t mtx_unlock(mtx_t* _Nonnull self)
 {
+    if (_MTX_INHERIT(self)) {
+        __mtx_unlock_pi(self);
+        return EOK;
+    }
+
     if (atomic_int_fetch_sub(&self->state, 1) != _MTX_LOCKED) {
 #if defined(__M68K__)
         // CPU store instruction provides enough intrinsic atomicity that we can
@@ -0,0 +1,16 @@
+//
+//  woa_wait_pi.c
+//  libc
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#include <serena/synch.h>
+#include <kpi/syscall.h>
+
+
+int woa_wait_pi(volatile atomic_int* _Nonnull addr, int expected, vcpuid_t owner, int flags, const nanotime_t* _Nullable wtp)
+{
+    return (int)_syscall(SC_woa_wait_pi, addr, expected, owner, flags, wtp);
+}
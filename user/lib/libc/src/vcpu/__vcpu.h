@@ -45,6 +45,7 @@ struct vcpu {
     struct vcpu_specific    specific_inline[VCPU_DATA_INLINE_CAPACITY];
     vcpu_specific_t         specific_tab;
     int                     specific_capacity;
+    struct __mcache* _Nullable  mcache;     // Small block cache of malloc
 };
 
 
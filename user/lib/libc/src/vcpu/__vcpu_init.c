@@ -44,6 +44,7 @@ void __vcpu_init(void)
     __g_main_vcpu.arg = 0;
     __g_main_vcpu.specific_tab = NULL;
     __g_main_vcpu.specific_capacity = 0;
+    __g_main_vcpu.mcache = NULL;
     (void)_syscall(SC_vcpu_setdata, (intptr_t)&__g_main_vcpu);
     deque_add_last(&__g_all_vcpus, &__g_main_vcpu.qe);
 
@@ -87,3 +87,15 @@ int vcpu_attr_setqos(vcpu_attr_t* _Nonnull attr, int qos, int priority)
     
     return 0;
 }
+
+
+size_t vcpu_attr_stacksize(const vcpu_attr_t* _Nonnull attr)
+{
+    return attr->stack_size;
+}
+
+int vcpu_attr_setstacksize(vcpu_attr_t* _Nonnull attr, size_t size)
+{
+    attr->stack_size = size;
+    return 0;
+}
@@ -8,6 +8,7 @@
 
 #include "__vcpu.h"
 #include <stdlib.h>
+#include <__stdlib.h>
 #include <serena/spinlock.h>
 #include <kpi/syscall.h>
 
@@ -64,6 +65,8 @@ _Noreturn void __vcpu_relinquish(vcpu_t _Nonnull self)
 
     if (self != &__g_main_vcpu) {
         __vcpu_destroy_specific(self);
+        __mcache_destroy(self->mcache);
+        self->mcache = NULL;
         free(self);
     }
 
@@ -0,0 +1,64 @@
+//
+//  clock_tests.c
+//  C Tests
+//
+//  Created by Dietmar Planitzer on 10/18/26.
+//  Copyright © 2026 Dietmar Planitzer. All rights reserved.
+//
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <ext/nanotime.h>
+#include <serena/clock.h>
+#include "asserts.h"
+
+#define SLEEP_ITERATIONS    20
+
+static const mseconds_t gSleepDurations[] = {1, 2, 5, 10, 17, 50, 100};
+
+
+// Measures how far the actual wake time of clock_sleep() is off from the
+// requested wake time. Reports the minimum, average and maximum wake latency
+// for a series of sleep durations.
+void clock_latency_test(int argc, char *argv[])
+{
+    clock_basic_info_t info;
+    nanotime_t wt, t0, t1, dt;
+
+    assert_ok(clock_info(CLOCK_MONOTONIC, CLOCK_INFO_BASIC, &info));
+    const int64_t res_ns = nanotime_ns(&info.tick_resolution);
+    printf("Clock resolution: %lld ns\n\n", res_ns);
+    printf("Requested      Min        Avg        Max    [us]\n");
+
+    for (size_t i = 0; i < sizeof(gSleepDurations) / sizeof(mseconds_t); i++) {
+        const int64_t req_ns = (int64_t)gSleepDurations[i] * 1000000ll;
+        int64_t min_ns = INT64_MAX, max_ns = INT64_MIN, sum_ns = 0;
+
+        nanotime_from_ms(&wt, gSleepDurations[i]);
+
+        for (int j = 0; j < SLEEP_ITERATIONS; j++) {
+            assert_ok(clock_time(CLOCK_MONOTONIC, &t0));
+            assert_ok(clock_sleep(CLOCK_MONOTONIC, 0, &wt));
+            assert_ok(clock_time(CLOCK_MONOTONIC, &t1));
+
+            nanotime_sub(&dt, &t1, &t0);
+            const int64_t late_ns = nanotime_ns(&dt) - req_ns;
+
+            // We may wake up at most one clock tick early because the
+            // sleep starts at some point within the current tick
+            assert_true(late_ns > -res_ns);
+
+            if (late_ns < min_ns) {
+                min_ns = late_ns;
+            }
+            if (late_ns > max_ns) {
+                max_ns = late_ns;
+            }
+            sum_ns += late_ns;
+        }
+
+        printf("%6ld ms  %9lld  %9lld  %9lld\n", gSleepDurations[i], min_ns / 1000ll, (sum_ns / SLEEP_ITERATIONS) / 1000ll, max_ns / 1000ll);
+    }
+}
@@ -11,6 +11,12 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <ext/nanotime.h>
+#include <serena/clock.h>
+#include <serena/file.h>
+#include <serena/pipe.h>
+#include <serena/sem.h>
+#include <serena/vcpu_acquire.h>
 #include "asserts.h"
 
 
@@ -31,3 +37,196 @@ void overwrite_file_test(int argc, char *argv[])
 
     fclose(fp);
 }
+
+void sync_file_test(int argc, char *argv[])
+{
+    const char* path = "/Users/admin/sync_test.txt";
+    const char* str = "HELLO WORLD";
+    const size_t len = strlen(str);
+    int fds[2];
+
+    printf("sync: %s\n", path);
+
+    const int fd = fs_create_file(NULL, path, O_RDWR, 0644);
+    assert_int_ge(0, fd);
+
+    assert_ssize_eq(len, fd_write(fd, str, len));
+    assert_ok(fd_datasync(fd));
+
+    // Overwrite in place: no size or block map change
+    assert_ok((int)fd_seek(fd, 0, SEEK_SET));
+    assert_ssize_eq(len, fd_write(fd, str, len));
+    assert_ok(fd_datasync(fd));
+    assert_ok(fd_sync(fd));
+
+    // Nothing changed since the last sync
+    assert_ok(fd_sync(fd));
+
+    assert_ok(fd_close(fd));
+    assert_ok(fs_remove(NULL, path));
+
+
+    // Pipes can not be synced
+    assert_ok(pipe_create(fds));
+    assert_nok(EINVAL, fd_sync(fds[PIPE_FD_WRITE]));
+    fd_close(fds[PIPE_FD_READ]);
+    fd_close(fds[PIPE_FD_WRITE]);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// read_bench_file_test
+//
+// Measures the read throughput of a large file. The file data is dropped from
+// the disk cache after it has been written, so that a single fd_read() of the
+// whole file takes the path that reads uncached blocks straight into the
+// caller's buffer. Reading the file in small chunks goes through the disk cache.
+
+#define READ_BENCH_FILE_SIZE    (256 * 1024)
+#define READ_BENCH_CHUNK_SIZE   512
+
+static void print_read_rate(const char* _Nonnull label, const nanotime_t* _Nonnull t0, const nanotime_t* _Nonnull t1)
+{
+    nanotime_t dt;
+
+    nanotime_sub(&dt, t1, t0);
+    const int64_t us = nanotime_ns(&dt) / 1000ll;
+    const int64_t kbps = (us > 0) ? ((int64_t)READ_BENCH_FILE_SIZE * 1000000ll / 1024ll) / us : 0;
+
+    printf("%s: %d bytes, %lld us, %lld KB/s\n", label, READ_BENCH_FILE_SIZE, (long long)us, (long long)kbps);
+}
+
+void read_bench_file_test(int argc, char *argv[])
+{
+    const char* path = "/Users/admin/read_bench.dat";
+    char* buf = malloc(READ_BENCH_FILE_SIZE);
+    nanotime_t t0, t1;
+
+    assert_not_null(buf);
+    printf("read_bench: %s\n", path);
+
+    for (size_t i = 0; i < READ_BENCH_FILE_SIZE; i++) {
+        buf[i] = (char)(i * 7);
+    }
+
+    int fd = fs_create_file(NULL, path, O_RDWR, 0644);
+    assert_int_ge(0, fd);
+    assert_ssize_eq(READ_BENCH_FILE_SIZE, fd_write(fd, buf, READ_BENCH_FILE_SIZE));
+    assert_ok(fd_purge(fd));
+    assert_ok(fd_close(fd));
+
+
+    // One big read. None of the blocks is cached at this point
+    memset(buf, 0, READ_BENCH_FILE_SIZE);
+    fd = fs_open(NULL, path, O_RDONLY);
+    assert_int_ge(0, fd);
+    clock_time(CLOCK_MONOTONIC, &t0);
+    assert_ssize_eq(READ_BENCH_FILE_SIZE, fd_read(fd, buf, READ_BENCH_FILE_SIZE));
+    clock_time(CLOCK_MONOTONIC, &t1);
+    print_read_rate("single read", &t0, &t1);
+
+    for (size_t i = 0; i < READ_BENCH_FILE_SIZE; i++) {
+        assert_int_eq((char)(i * 7), buf[i]);
+    }
+
+
+    // Many small reads
+    memset(buf, 0, READ_BENCH_FILE_SIZE);
+    assert_ok((int)fd_seek(fd, 0, SEEK_SET));
+    clock_time(CLOCK_MONOTONIC, &t0);
+    for (size_t i = 0; i < READ_BENCH_FILE_SIZE; i += READ_BENCH_CHUNK_SIZE) {
+        assert_ssize_eq(READ_BENCH_CHUNK_SIZE, fd_read(fd, &buf[i], READ_BENCH_CHUNK_SIZE));
+    }
+    clock_time(CLOCK_MONOTONIC, &t1);
+    print_read_rate("chunked read", &t0, &t1);
+
+    for (size_t i = 0; i < READ_BENCH_FILE_SIZE; i++) {
+        assert_int_eq((char)(i * 7), buf[i]);
+    }
+
+    assert_ok(fd_close(fd));
+    assert_ok(fs_remove(NULL, path));
+    free(buf);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// fd_lookup_bench_test
+//
+// Measures the cost of a descriptor lookup. fd_type() does nothing but look up
+// the handler and release it again. A single vcpu first establishes the
+// uncontended cost, then several vcpus hammer the same descriptor table.
+
+#define LOOKUP_VCPU_COUNT   4
+#define LOOKUP_ITERATIONS   20000
+
+static sem_t gLookupDone;
+static int gLookupFds[LOOKUP_VCPU_COUNT];
+
+
+static void lookup_loop(int* _Nonnull pfd)
+{
+    const int fd = *pfd;
+
+    for (int i = 0; i < LOOKUP_ITERATIONS; i++) {
+        fd_type(fd);
+    }
+
+    sem_post(&gLookupDone);
+}
+
+static void print_lookup_cost(const char* _Nonnull label, int nvcpus, const nanotime_t* _Nonnull t0, const nanotime_t* _Nonnull t1)
+{
+    nanotime_t dt;
+
+    nanotime_sub(&dt, t1, t0);
+    const int64_t ns = nanotime_ns(&dt);
+    const int32_t lookups = nvcpus * LOOKUP_ITERATIONS;
+
+    printf("%s: %d vcpus, %ld lookups, %lld ns total, %ld ns/lookup\n", label, nvcpus, (long)lookups, (long long)ns, (long)(ns / lookups));
+}
+
+void fd_lookup_bench_test(int argc, char *argv[])
+{
+    int fds[2];
+    nanotime_t t0, t1;
+    vcpu_attr_t attr;
+
+    assert_ok(pipe_create(fds));
+    for (int i = 0; i < LOOKUP_VCPU_COUNT; i++) {
+        gLookupFds[i] = fd_dup(fds[PIPE_FD_READ], 0);
+        assert_int_ge(0, gLookupFds[i]);
+    }
+    assert_ok(sem_init(&gLookupDone, 0));
+
+
+    // Uncontended
+    clock_time(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < LOOKUP_ITERATIONS; i++) {
+        fd_type(gLookupFds[0]);
+    }
+    clock_time(CLOCK_MONOTONIC, &t1);
+    print_lookup_cost("uncontended", 1, &t0, &t1);
+
+
+    // Contended
+    clock_time(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < LOOKUP_VCPU_COUNT; i++) {
+        vcpu_attr_init(&attr);
+        vcpu_attr_setqos(&attr, VCPU_QOS_INTERACTIVE, VCPU_PRI_NORMAL);
+        assert_not_null(vcpu_acquire((vcpu_func_t)lookup_loop, &gLookupFds[i], &attr));
+    }
+    for (int i = 0; i < LOOKUP_VCPU_COUNT; i++) {
+        assert_ok(sem_wait(&gLookupDone));
+    }
+    clock_time(CLOCK_MONOTONIC, &t1);
+    print_lookup_cost("contended", LOOKUP_VCPU_COUNT, &t0, &t1);
+
+
+    sem_destroy(&gLookupDone);
+    for (int i = 0; i < LOOKUP_VCPU_COUNT; i++) {
+        fd_close(gLookupFds[i]);
+    }
+    fd_close(fds[PIPE_FD_READ]);
+    fd_close(fds[PIPE_FD_WRITE]);
+}
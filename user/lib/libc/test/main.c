@@ -18,6 +18,9 @@
 // atomic
 extern void atomic_test(int argc, char *argv[]);
 
+// clock
+extern void clock_latency_test(int argc, char *argv[]);
+
 // console
 extern void interactive_console_test(int argc, char *argv[]);
 
@@ -31,7 +34,10 @@ extern void excpt_raise_test(int argc, char *argv[]);
 extern void fp_test(int argc, char *argv[]);
 
 // fd
+extern void fd_lookup_bench_test(int argc, char *argv[]);
 extern void overwrite_file_test(int argc, char *argv[]);
+extern void sync_file_test(int argc, char *argv[]);
+extern void read_bench_file_test(int argc, char *argv[]);
 
 // hid
 extern void hid_test(int argc, char *argv[]);
@@ -44,12 +50,18 @@ extern void int64_test(int argc, char *argv[]);
 
 // kern
 extern void kern_test(int argc, char *argv[]);
+extern void scring_test(int argc, char *argv[]);
 
 // mem
 extern void mem_test(int argc, char *argv[]);
+extern void mem_release_test(int argc, char *argv[]);
+extern void mem_large_test(int argc, char *argv[]);
+extern void mem_contention_test(int argc, char *argv[]);
+extern void mem_stats_test(int argc, char *argv[]);
 
 // mtx
 extern void mtx_test(int argc, char *argv[]);
+extern void mtx_pi_test(int argc, char *argv[]);
 
 // pipe
 extern void pipe_test(int argc, char *argv[]);
@@ -58,6 +70,8 @@ extern void pipe2_test(int argc, char *argv[]);
 // proc
 extern void proc_exec_test(int argc, char *argv[]);
 extern void proc_exit_test(int argc, char *argv[]);
+extern void proc_sef_test(int argc, char *argv[]);
+extern void proc_snapshot_test(int argc, char *argv[]);
 
 // reference counting
 extern void rc_test(int argc, char *argv[]);
@@ -77,6 +91,8 @@ extern void fopen_memory_variable_size_test(int argc, char *argv[]);
 
 // string
 extern void str_test(int argc, char *argv[]);
+extern void memxxx_test(int argc, char *argv[]);
+extern void memxxx_bench_test(int argc, char *argv[]);
 
 // strtol
 extern void strtol_test(int argc, char *argv[]);
@@ -91,7 +107,9 @@ extern void uint64_test(int argc, char *argv[]);
 extern void vcpu_acquire_test(int argc, char *argv[]);
 extern void vcpu_main_test(int argc, char *argv[]);
 extern void vcpu_scheduling_test(int argc, char *argv[]);
+extern void vcpu_sched_stats_test(int argc, char *argv[]);
 extern void vcpu_sigkill_test(int argc, char *argv[]);
+extern void vcpu_stack_test(int argc, char *argv[]);
 extern void vcpu_suspend_test(int argc, char *argv[]);
 
 
@@ -107,6 +125,8 @@ typedef struct test {
 static const test_t gTests[] = {
     {"atomic", atomic_test, false},
 
+    {"clock_latency", clock_latency_test, false},
+
     {"console", interactive_console_test, false},
 
     {"excpt_crash", excpt_crash_test, false},
@@ -115,6 +135,10 @@ static const test_t gTests[] = {
     {"excpt_ret", excpt_return_test, false},
 
     {"file", overwrite_file_test, false},
+    {"file_sync", sync_file_test, false},
+    {"file_read_bench", read_bench_file_test, false},
+
+    {"fd_bench", fd_lookup_bench_test, false},
 
     {"fp", fp_test, false},
 
@@ -125,16 +149,24 @@ static const test_t gTests[] = {
     {"int64", int64_test, false},
 
     {"kern", kern_test, false},
+    {"kern_scring", scring_test, false},
 
     {"mem", mem_test, false},
+    {"mem_release", mem_release_test, false},
+    {"mem_large", mem_large_test, false},
+    {"mem_contention", mem_contention_test, false},
+    {"mem_stats", mem_stats_test, false},
 
     {"mtx", mtx_test, true},
+    {"mtx_pi", mtx_pi_test, false},
 
     {"pipe", pipe_test, false},
     {"pipe2", pipe2_test, true},
 
     {"proc_exec", proc_exec_test, false},
     {"proc_exit", proc_exit_test, true},
+    {"proc_sef", proc_sef_test, false},
+    {"proc_snapshot", proc_snapshot_test, false},
 
     {"rc", rc_test, false},
 
@@ -150,6 +182,8 @@ static const test_t gTests[] = {
     {"strtol", strtol_test, false},
 
     {"str", str_test, false},
+    {"memxxx", memxxx_test, false},
+    {"memxxx_bench", memxxx_bench_test, false},
 
     {"uint32", uint32_test, false},
     {"uint64", uint64_test, false},
@@ -157,7 +191,9 @@ static const test_t gTests[] = {
     {"vcpu_aq", vcpu_acquire_test, true},
     {"vcpu_main", vcpu_main_test, false},
     {"vcpu_sched", vcpu_scheduling_test, true},
+    {"vcpu_sched_stats", vcpu_sched_stats_test, false},
     {"vcpu_sigkill", vcpu_sigkill_test, true},
+    {"vcpu_stack", vcpu_stack_test, false},
     {"vcpu_suspend", vcpu_suspend_test, true},
 
     {"", NULL}
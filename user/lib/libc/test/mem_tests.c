@@ -9,6 +9,14 @@
 #include <limits.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdio.h>
+#include <ext/nanotime.h>
+#include <serena/clock.h>
+#include <serena/mtx.h>
+#include <serena/process.h>
+#include <serena/vcpu.h>
+#include <serena/vcpu_acquire.h>
+#include <serena/vm.h>
 #include "asserts.h"
 
 
@@ -126,3 +134,263 @@ void mem_test(int argc, char *argv[])
 
     free(p);
 }
+
+
+static uint64_t vm_size(void)
+{
+    proc_basic_info_t info;
+
+    assert_ok(proc_info(PROC_SELF, PROC_INFO_BASIC, &info));
+    return info.vm_size;
+}
+
+void mem_release_test(int argc, char *argv[])
+{
+    // Small enough to stay in the main allocator
+    const size_t MEMBLK_SIZE = 24*1024;
+    const size_t MEMBLK_COUNT = 4;
+    char* p[4];
+    void* vp;
+
+    // vm_deallocate() only accepts whole blocks from vm_allocate()
+    assert_ok(vm_allocate(2*4096, &vp));
+    assert_nok(EINVAL, vm_deallocate(vp, 4096));
+    assert_nok(EINVAL, vm_deallocate((char*)vp + 4096, 4096));
+    assert_ok(vm_deallocate(vp, 2*4096));
+    assert_nok(EINVAL, vm_deallocate(vp, 2*4096));
+
+
+    // Freeing everything that malloc() had to expand the heap for gives the
+    // memory back to the kernel
+    const uint64_t vm_size0 = vm_size();
+
+    for (size_t i = 0; i < MEMBLK_COUNT; i++) {
+        p[i] = malloc(MEMBLK_SIZE);
+        assert_not_null(p[i]);
+        memset(p[i], 0xaa, MEMBLK_SIZE);
+    }
+    assert_true(vm_size() > vm_size0);
+
+    for (size_t i = 0; i < MEMBLK_COUNT; i++) {
+        free(p[i]);
+    }
+    assert_true(vm_size() == vm_size0);
+}
+
+void mem_large_test(int argc, char *argv[])
+{
+    const size_t MEMBLK_SIZE = 64*1024;
+    malloc_stats_t st0, st1;
+
+    malloc_getstats(&st0);
+    const uint64_t vm_size0 = vm_size();
+
+
+    // A large block gets a memory region of its own
+    char* p = malloc(MEMBLK_SIZE);
+    assert_not_null(p);
+    memset(p, 0x55, MEMBLK_SIZE);
+
+    malloc_getstats(&st1);
+    assert_int_eq(st0.large_block_count + 1, st1.large_block_count);
+    assert_true(st1.large_bytes >= st0.large_bytes + MEMBLK_SIZE);
+    assert_int_eq(st0.used_block_count, st1.used_block_count);
+    assert_true(vm_size() >= vm_size0 + MEMBLK_SIZE);
+
+
+    // Growing beyond the region moves the block to a region with head room.
+    // Growing a bit more happens in place
+    p = realloc(p, MEMBLK_SIZE + 100);
+    assert_not_null(p);
+    assert_true(has_value(p, 0x55, MEMBLK_SIZE));
+    memset(p + MEMBLK_SIZE, 0x55, 100);
+
+    char* q = realloc(p, MEMBLK_SIZE + 4096);
+    assert_true(q == p);
+    assert_true(has_value(p, 0x55, MEMBLK_SIZE + 100));
+
+
+    // Shrinking below the threshold moves the block back to the main
+    // allocator and returns the region to the kernel
+    p = realloc(p, 100);
+    assert_not_null(p);
+    assert_true(has_value(p, 0x55, 100));
+
+    malloc_getstats(&st1);
+    assert_int_eq(st0.large_block_count, st1.large_block_count);
+    assert_int_eq(st0.used_block_count + 1, st1.used_block_count);
+
+
+    // A heap block that grows beyond the threshold moves to a region
+    p = realloc(p, MEMBLK_SIZE);
+    assert_not_null(p);
+    assert_true(has_value(p, 0x55, 100));
+
+    malloc_getstats(&st1);
+    assert_int_eq(st0.large_block_count + 1, st1.large_block_count);
+
+    free(p);
+    malloc_getstats(&st1);
+    assert_int_eq(st0.large_block_count, st1.large_block_count);
+    assert_int_eq(st0.large_bytes, st1.large_bytes);
+    assert_true(vm_size() == vm_size0);
+}
+
+void mem_stats_test(int argc, char *argv[])
+{
+    const size_t MEMBLK_SIZE = 1024;
+    malloc_stats_t st0, st1, st2;
+
+    // Make sure that stderr has its buffer before we take the first snapshot
+    malloc_dump();
+
+    malloc_getstats(&st0);
+    assert_true(st0.used_bytes <= st0.peak_used_bytes);
+    assert_true(st0.largest_free_size <= st0.free_bytes);
+
+    char* p = malloc(MEMBLK_SIZE);
+    char* q = __malloc_site(MEMBLK_SIZE, "mem_stats_test");
+    assert_not_null(p);
+    assert_not_null(q);
+
+    malloc_getstats(&st1);
+    assert_int_eq(st0.used_block_count + 2, st1.used_block_count);
+    assert_int_eq(st0.allocs + 2, st1.allocs);
+    assert_int_eq(st0.allocs_per_class[10] + 2, st1.allocs_per_class[10]);
+    assert_true(st1.used_bytes >= st0.used_bytes + 2*MEMBLK_SIZE);
+    assert_true(st1.peak_used_bytes >= st1.used_bytes);
+
+    // Should list 'q' and whatever else carries an allocation site
+    malloc_dump();
+
+    free(p);
+    free(q);
+
+    malloc_getstats(&st2);
+    assert_int_eq(st0.used_block_count, st2.used_block_count);
+    assert_int_eq(st0.frees + 2, st2.frees);
+    assert_true(st2.used_bytes == st0.used_bytes);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// mem_contention_test
+
+#define MC_NUM_VPS      4
+#define MC_ROUNDS       2000
+#define MC_BATCH        16
+
+static mtx_t gMcMutex;
+static char* gMcMailbox[MC_NUM_VPS];    // Protected by gMcMutex
+static int gMcDoneCount;                // Protected by gMcMutex
+
+
+static char* mc_take_mail(int id)
+{
+    mtx_lock(&gMcMutex);
+    char* p = gMcMailbox[id];
+    gMcMailbox[id] = NULL;
+    mtx_unlock(&gMcMutex);
+
+    return p;
+}
+
+// Hands 'p' to the next vcpu which frees it. Returns false if the mailbox of the
+// next vcpu is still occupied.
+static bool mc_put_mail(int id, char* p)
+{
+    const int dst = (id + 1) % MC_NUM_VPS;
+    bool ok = false;
+
+    mtx_lock(&gMcMutex);
+    if (gMcMailbox[dst] == NULL) {
+        gMcMailbox[dst] = p;
+        ok = true;
+    }
+    mtx_unlock(&gMcMutex);
+
+    return ok;
+}
+
+static void mc_worker(void* arg)
+{
+    const int id = (int)(intptr_t)arg;
+    const char ch = 'a' + id;
+    const char pch = 'a' + (id + MC_NUM_VPS - 1) % MC_NUM_VPS;
+    char* p[MC_BATCH];
+
+    for (int r = 0; r < MC_ROUNDS; r++) {
+        for (int i = 0; i < MC_BATCH; i++) {
+            const size_t size = 1 + ((r + i) * 7) % 128;
+
+            p[i] = malloc(size);
+            assert_not_null(p[i]);
+            p[i][0] = ch;
+            p[i][size - 1] = ch;
+        }
+
+        // Blocks that another vcpu allocated are freed by this vcpu
+        char* mp = mc_take_mail(id);
+        if (mp) {
+            assert_int_eq(pch, mp[0]);
+            free(mp);
+        }
+
+        for (int i = 0; i < MC_BATCH; i++) {
+            assert_int_eq(ch, p[i][0]);
+
+            if (i > 0 || !mc_put_mail(id, p[i])) {
+                free(p[i]);
+            }
+        }
+    }
+
+    mtx_lock(&gMcMutex);
+    gMcDoneCount++;
+    mtx_unlock(&gMcMutex);
+}
+
+static bool mc_is_done(void)
+{
+    mtx_lock(&gMcMutex);
+    const bool done = (gMcDoneCount == MC_NUM_VPS);
+    mtx_unlock(&gMcMutex);
+
+    return done;
+}
+
+// A number of vcpus run malloc()/free() loops on small blocks and pass blocks to
+// each other so that a block may be freed by a different vcpu than the one that
+// allocated it.
+void mem_contention_test(int argc, char *argv[])
+{
+    nanotime_t t0, t1, dt, poll;
+    vcpu_attr_t attr;
+
+    assert_ok(mtx_init(&gMcMutex, mtx_plain));
+    gMcDoneCount = 0;
+    nanotime_from_ms(&poll, 1);
+
+    vcpu_attr_init(&attr);
+    vcpu_attr_setqos(&attr, VCPU_QOS_UTILITY, VCPU_PRI_NORMAL);
+
+    assert_ok(clock_time(CLOCK_MONOTONIC, &t0));
+    for (int i = 0; i < MC_NUM_VPS; i++) {
+        assert_not_null(vcpu_acquire((vcpu_func_t)mc_worker, (void*)(intptr_t)i, &attr));
+    }
+
+    while (!mc_is_done()) {
+        clock_sleep(CLOCK_MONOTONIC, 0, &poll);
+    }
+    assert_ok(clock_time(CLOCK_MONOTONIC, &t1));
+
+    for (int i = 0; i < MC_NUM_VPS; i++) {
+        free(gMcMailbox[i]);
+        gMcMailbox[i] = NULL;
+    }
+
+
+    nanotime_sub(&dt, &t1, &t0);
+    const int64_t nops = 2ll * MC_NUM_VPS * MC_ROUNDS * MC_BATCH;
+    printf("%d vcpus: %lld ops in %lld us, %lld ns/op\n", MC_NUM_VPS, nops, nanotime_ns(&dt) / 1000ll, nanotime_ns(&dt) / nops);
+}
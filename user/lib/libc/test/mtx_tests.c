@@ -14,10 +14,16 @@
 #include <time.h>
 #include <ext/math.h>
 #include <ext/nanotime.h>
+#include <serena/clock.h>
 #include <serena/mtx.h>
+#include <serena/vcpu.h>
+#include <serena/vcpu_acquire.h>
 #include "asserts.h"
 
 
+////////////////////////////////////////////////////////////////////////////////
+// mtx_test
+
 #define NUM_WORKERS     16
 #define NUM_VPS         4
 #define NUM_PATTERNS    8
@@ -99,3 +105,113 @@ void mtx_test(int argc, char *argv[])
         assert_ok(dispatch_async(gDispatcher, (dispatch_async_func_t)OnWork, NULL));
     }
 }
+
+
+////////////////////////////////////////////////////////////////////////////////
+// mtx_pi_test
+
+#define PI_WORK_LOOPS   200000
+#define PI_NUM_HOGS     2
+
+static mtx_t gPiMutex;
+static volatile int gPiSink;
+static volatile bool gPiLowHolds;
+static volatile bool gPiDone;
+static int64_t gPiBlockedNs;
+
+
+static void pi_busy_work(void)
+{
+    for (int i = 0; i < PI_WORK_LOOPS; i++) {
+        gPiSink++;
+    }
+}
+
+static void pi_low(void)
+{
+    assert_ok(mtx_lock(&gPiMutex));
+    gPiLowHolds = true;
+    pi_busy_work();
+    assert_ok(mtx_unlock(&gPiMutex));
+}
+
+static void pi_medium(void)
+{
+    while (!gPiDone) {
+    }
+}
+
+static void pi_high(void)
+{
+    nanotime_t t0, t1, dt;
+
+    assert_ok(clock_time(CLOCK_MONOTONIC, &t0));
+    assert_ok(mtx_lock(&gPiMutex));
+    assert_ok(clock_time(CLOCK_MONOTONIC, &t1));
+    assert_ok(mtx_unlock(&gPiMutex));
+
+    nanotime_sub(&dt, &t1, &t0);
+    gPiBlockedNs = nanotime_ns(&dt);
+    gPiDone = true;
+}
+
+static vcpu_t pi_acquire(void (*func)(void), int qos)
+{
+    vcpu_attr_t attr;
+
+    vcpu_attr_init(&attr);
+    vcpu_attr_setqos(&attr, qos, VCPU_PRI_NORMAL);
+
+    vcpu_t vp = vcpu_acquire((vcpu_func_t)func, NULL, &attr);
+    assert_not_null(vp);
+    return vp;
+}
+
+// Priority inversion scenario:
+// a) a Background vcpu grabs the mutex and does some work while holding it
+// b) Utility vcpus hog the CPU and would starve (a) indefinitely
+// c) a Realtime vcpu blocks on the mutex
+//
+// -> (c) should lend its priority to (a) which then finishes its work ahead of
+//    (b) and releases the mutex. The blocking time of (c) should be bounded by
+//    the time it takes (a) to do its work.
+void mtx_pi_test(int argc, char *argv[])
+{
+    nanotime_t t0, t1, dt, poll;
+
+    assert_ok(mtx_init(&gPiMutex, mtx_plain | mtx_inherit));
+    nanotime_from_ms(&poll, 1);
+
+
+    // Find out how long the low priority vcpu holds the mutex if it isn't
+    // preempted
+    assert_ok(clock_time(CLOCK_MONOTONIC, &t0));
+    pi_busy_work();
+    assert_ok(clock_time(CLOCK_MONOTONIC, &t1));
+    nanotime_sub(&dt, &t1, &t0);
+    const int64_t hold_ns = nanotime_ns(&dt);
+
+
+    gPiLowHolds = false;
+    gPiDone = false;
+    pi_acquire(pi_low, VCPU_QOS_BACKGROUND);
+    while (!gPiLowHolds) {
+        clock_sleep(CLOCK_MONOTONIC, 0, &poll);
+    }
+
+    for (int i = 0; i < PI_NUM_HOGS; i++) {
+        pi_acquire(pi_medium, VCPU_QOS_UTILITY);
+    }
+    pi_acquire(pi_high, VCPU_QOS_REALTIME);
+
+    while (!gPiDone) {
+        clock_sleep(CLOCK_MONOTONIC, 0, &poll);
+    }
+
+
+    printf("Hold time: %lld us, blocked time: %lld us\n", hold_ns / 1000ll, gPiBlockedNs / 1000ll);
+
+    // Allow for the quantum that the low priority vcpu may have to wait out
+    // before it gets to run and some scheduling overhead
+    assert_true(gPiBlockedNs <= 2ll * hold_ns + 50ll * 1000000ll);
+}
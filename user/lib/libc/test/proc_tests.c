@@ -6,13 +6,18 @@
 //  Copyright © 2025 Dietmar Planitzer. All rights reserved.
 //
 
+#include <errno.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include <time.h>
 #include <ext/nanotime.h>
+#include <kpi/sef.h>
 #include <serena/clock.h>
+#include <serena/file.h>
+#include <serena/host.h>
 #include <serena/process.h>
+#include <serena/proc_spawn.h>
 #include <serena/vcpu.h>
 #include <serena/vcpu_acquire.h>
 #include "asserts.h"
@@ -91,3 +96,139 @@ void proc_exec_test(int argc, char *argv[])
 
     assert_ok(proc_exec(argv2[0], argv2, NULL));
 }
+
+
+////////////////////////////////////////////////////////////////////////////////
+// proc_sef_test
+
+#define SEF_TEST_PATH       "/Users/admin/sef_test"
+#define SEF_TEST_TEXT_SIZE  8
+
+typedef struct sef_test_file {
+    sef_hdr_t   hdr;
+    uint8_t     text[SEF_TEST_TEXT_SIZE];
+    uint32_t    reloc_first_site;
+} sef_test_file_t;
+
+// Returns a well formed executable with a text segment and an empty text to
+// text relocation table. The test cases below break one field at a time
+static void sef_test_make(sef_test_file_t* _Nonnull sf)
+{
+    memset(sf, 0, sizeof(sef_test_file_t));
+    sf->hdr.signature = SEF_SIGNATURE;
+    sf->hdr.version = SEF_VERSION;
+    sf->hdr.hdr_size = sizeof(sef_hdr_t);
+    sf->hdr.seg_align = 2;
+    sf->hdr.seg[SEF_SEG_TEXT].file_offset = offsetof(sef_test_file_t, text);
+    sf->hdr.seg[SEF_SEG_TEXT].file_size = SEF_TEST_TEXT_SIZE;
+    sf->hdr.seg[SEF_SEG_TEXT].mem_size = SEF_TEST_TEXT_SIZE;
+    sf->hdr.reloc[SEF_RELOC_TEXT_TO_TEXT].file_offset = offsetof(sef_test_file_t, reloc_first_site);
+    sf->hdr.reloc[SEF_RELOC_TEXT_TO_TEXT].delta_count = 0;
+    sf->reloc_first_site = 0;
+}
+
+// Writes 'sf' to disk, tries to spawn it and checks that the loader rejects it
+// with 'expected_err'
+static void sef_test_spawn(const sef_test_file_t* _Nonnull sf, int expected_err)
+{
+    const char* argv[2] = {SEF_TEST_PATH, NULL};
+    proc_spawnattr_t attr;
+    proc_spawnres_t sres;
+
+    const int fd = fs_create_file(NULL, SEF_TEST_PATH, O_RDWR | O_TRUNC, 0755);
+    assert_int_ge(0, fd);
+    assert_ssize_eq(sizeof(sef_test_file_t), fd_write(fd, sf, sizeof(sef_test_file_t)));
+    assert_ok(fd_close(fd));
+
+    assert_ok(proc_spawnattr_init(&attr));
+    errno = 0;
+    assert_int_eq(-1, proc_spawn(SEF_TEST_PATH, argv, NULL, &attr, NULL, &sres));
+    assert_int_eq(expected_err, errno);
+    proc_spawnattr_destroy(&attr);
+
+    assert_ok(fs_remove(NULL, SEF_TEST_PATH));
+}
+
+void proc_sef_test(int argc, char *argv[])
+{
+    sef_test_file_t sf;
+
+    // Segment bigger than any image the loader accepts
+    sef_test_make(&sf);
+    sf.hdr.seg[SEF_SEG_TEXT].mem_size = 0xfffffff0;
+    sef_test_spawn(&sf, EINVAL);
+
+    // Data and BSS sizes whose sum wraps around
+    sef_test_make(&sf);
+    sf.hdr.seg[SEF_SEG_DATA].mem_size = 0x80000000;
+    sf.hdr.seg[SEF_SEG_BSS].mem_size = 0x80000000;
+    sef_test_spawn(&sf, EINVAL);
+
+    // Page rounding of the image size would wrap around
+    sef_test_make(&sf);
+    sf.hdr.seg[SEF_SEG_BSS].mem_size = 0xffffffff - SEF_TEST_TEXT_SIZE;
+    sef_test_spawn(&sf, EINVAL);
+
+    // Data alignment out of range
+    sef_test_make(&sf);
+    sf.hdr.seg_align = 31;
+    sef_test_spawn(&sf, EINVAL);
+
+    // Odd data segment base
+    sef_test_make(&sf);
+    sf.hdr.seg_align = 0;
+    sf.hdr.seg[SEF_SEG_TEXT].file_size = SEF_TEST_TEXT_SIZE - 1;
+    sf.hdr.seg[SEF_SEG_TEXT].mem_size = SEF_TEST_TEXT_SIZE - 1;
+    sf.hdr.seg[SEF_SEG_DATA].mem_size = 4;
+    sef_test_spawn(&sf, EINVAL);
+
+    // File size bigger than memory size
+    sef_test_make(&sf);
+    sf.hdr.seg[SEF_SEG_TEXT].mem_size = SEF_TEST_TEXT_SIZE - 4;
+    sef_test_spawn(&sf, EINVAL);
+
+    // Odd relocation site. The SEF loader declines it and so does every other
+    // loader
+    sef_test_make(&sf);
+    sf.reloc_first_site = 1;
+    sef_test_spawn(&sf, ENOEXEC);
+
+    // Relocation site past the end of the segment
+    sef_test_make(&sf);
+    sf.reloc_first_site = SEF_TEST_TEXT_SIZE;
+    sef_test_spawn(&sf, ENOEXEC);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// proc_snapshot_test
+
+void proc_snapshot_test(int argc, char *argv[])
+{
+    proc_snapshot_t snaps[32];
+    proc_basic_info_t info;
+    const pid_t self_pid = proc_self();
+    const proc_snapshot_t* self_snap = NULL;
+    size_t count = 0;
+
+    // Buffer too small: still filled in as far as possible
+    assert_int_eq(1, host_procsnap(snaps, 1, &count));
+    assert_size_eq(1, count);
+
+    assert_int_ge(0, host_procsnap(snaps, 32, &count));
+    assert_true(count >= 2);
+
+    for (size_t i = 0; i < count; i++) {
+        if (snaps[i].pid == self_pid) {
+            self_snap = &snaps[i];
+        }
+        printf("%d: %s, ppid: %d, vcpus: %zu, vm: %llu\n", snaps[i].pid, snaps[i].name, snaps[i].ppid, snaps[i].vcpu_count, snaps[i].vm_size);
+    }
+    assert_not_null(self_snap);
+
+    assert_ok(proc_info(PROC_SELF, PROC_INFO_BASIC, &info));
+    assert_int_eq(info.ppid, self_snap->ppid);
+    assert_int_eq(PROC_STATE_RUNNING, self_snap->run_state);
+    assert_true(self_snap->vcpu_count >= 1);
+    assert_true(self_snap->name[0] != '\0');
+}
@@ -8,7 +8,12 @@
 
 #include <limits.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <ext/nanotime.h>
 #include <ext/string.h>
+#include <serena/clock.h>
 #include "asserts.h"
 
 
@@ -92,3 +97,152 @@ void str_test(int argc, char *argv[])
     assert_ptr_eq(&buf_8[5], strrchr(buf_8, '\0'));
     assert_ptr_eq(NULL, strrchr(buf_8, 'x'));
 }
+
+
+////////////////////////////////////////////////////////////////////////////////
+// memxxx_test
+//
+// Checks memcpy(), memmove() and memset() against simple byte loops for a range
+// of sizes and source/destination alignments. This covers the byte, long word,
+// burst and move16 paths of the CPU specific implementations.
+
+#define MEMXXX_BUF_SIZE 1024
+#define MEMXXX_ARR_SIZE (MEMXXX_BUF_SIZE + 32)
+
+// The source and destination offsets are relative to a cache line boundary.
+// The buffers have 15 spare bytes to make room for the alignment
+static uint8_t gMemSrcBuf[MEMXXX_ARR_SIZE + 15];
+static uint8_t gMemDstBuf[MEMXXX_ARR_SIZE + 15];
+
+static void memxxx_fill(uint8_t* _Nonnull p, size_t n, int seed)
+{
+    for (size_t i = 0; i < n; i++) {
+        p[i] = (uint8_t)(i * 7 + seed);
+    }
+}
+
+void memxxx_test(int argc, char *argv[])
+{
+    static const size_t sizes[] = {0, 1, 3, 15, 16, 17, 39, 40, 41, 63, 255, 256, 257, 511, 1000};
+    uint8_t* src = (uint8_t*)(((uintptr_t)gMemSrcBuf + 15) & ~(uintptr_t)15);
+    uint8_t* dst = (uint8_t*)(((uintptr_t)gMemDstBuf + 15) & ~(uintptr_t)15);
+    uint8_t ref[MEMXXX_ARR_SIZE];
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(size_t); s++) {
+        const size_t n = sizes[s];
+
+        for (int sa = 0; sa < 16; sa += 3) {
+            for (int da = 0; da < 16; da += 5) {
+                // memcpy
+                memxxx_fill(src, MEMXXX_ARR_SIZE, 1);
+                memxxx_fill(dst, MEMXXX_ARR_SIZE, 2);
+                memxxx_fill(ref, sizeof(ref), 2);
+                for (size_t i = 0; i < n; i++) {
+                    ref[da + i] = src[sa + i];
+                }
+                assert_ptr_eq(&dst[da], memcpy(&dst[da], &src[sa], n));
+                assert_int_eq(0, memcmp(dst, ref, sizeof(ref)));
+
+
+                // memset
+                memxxx_fill(dst, MEMXXX_ARR_SIZE, 3);
+                memxxx_fill(ref, sizeof(ref), 3);
+                for (size_t i = 0; i < n; i++) {
+                    ref[da + i] = 0xa5;
+                }
+                assert_ptr_eq(&dst[da], memset(&dst[da], 0x1a5, n));
+                assert_int_eq(0, memcmp(dst, ref, sizeof(ref)));
+
+
+                // memmove with overlapping regions in both directions
+                if (n + 16 <= MEMXXX_BUF_SIZE) {
+                    memxxx_fill(dst, MEMXXX_ARR_SIZE, 4);
+                    memxxx_fill(ref, sizeof(ref), 4);
+                    for (size_t i = n; i > 0; i--) {
+                        ref[da + 16 + i - 1] = ref[sa + i - 1];
+                    }
+                    assert_ptr_eq(&dst[da + 16], memmove(&dst[da + 16], &dst[sa], n));
+                    assert_int_eq(0, memcmp(dst, ref, sizeof(ref)));
+
+                    memxxx_fill(dst, MEMXXX_ARR_SIZE, 5);
+                    memxxx_fill(ref, sizeof(ref), 5);
+                    for (size_t i = 0; i < n; i++) {
+                        ref[da + i] = ref[sa + 16 + i];
+                    }
+                    assert_ptr_eq(&dst[da], memmove(&dst[da], &dst[sa + 16], n));
+                    assert_int_eq(0, memcmp(dst, ref, sizeof(ref)));
+                }
+            }
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// memxxx_bench_test
+//
+// Measures the throughput of memcpy(), memmove() and memset() in MB/s for a
+// range of block sizes. The buffers are aligned to a cache line boundary.
+
+#define MEMBENCH_BUF_SIZE       65536
+#define MEMBENCH_BYTES_PER_RUN  (1024l * 1024l)
+
+typedef void* (*memxxx_func_t)(void*, const void*, size_t);
+
+static void* memset_adapter(void* _Nonnull dst, const void* _Nonnull src, size_t n)
+{
+    return memset(dst, 0x55, n);
+}
+
+static void* memcpy_adapter(void* _Nonnull dst, const void* _Nonnull src, size_t n)
+{
+    return memcpy(dst, src, n);
+}
+
+static void* memmove_adapter(void* _Nonnull dst, const void* _Nonnull src, size_t n)
+{
+    return memmove(dst, src, n);
+}
+
+static long membench_run(memxxx_func_t _Nonnull func, uint8_t* _Nonnull dst, const uint8_t* _Nonnull src, size_t n)
+{
+    const long iterations = MEMBENCH_BYTES_PER_RUN / n;
+    nanotime_t t0, t1, dt;
+
+    clock_time(CLOCK_MONOTONIC, &t0);
+    for (long i = 0; i < iterations; i++) {
+        func(dst, src, n);
+    }
+    clock_time(CLOCK_MONOTONIC, &t1);
+    nanotime_sub(&dt, &t1, &t0);
+
+    const int64_t ns = nanotime_ns(&dt);
+    return (ns > 0) ? (long)(((int64_t)iterations * n * 1000000000ll) / (ns * 1024ll * 1024ll)) : 0l;
+}
+
+void memxxx_bench_test(int argc, char *argv[])
+{
+    static const size_t sizes[] = {16, 64, 256, 1024, 4096, 16384, MEMBENCH_BUF_SIZE};
+    uint8_t* src_buf = malloc(MEMBENCH_BUF_SIZE + 16);
+    uint8_t* dst_buf = malloc(MEMBENCH_BUF_SIZE + 16);
+
+    assert_not_null(src_buf);
+    assert_not_null(dst_buf);
+    uint8_t* src = (uint8_t*)(((uintptr_t)src_buf + 15) & ~(uintptr_t)15);
+    uint8_t* dst = (uint8_t*)(((uintptr_t)dst_buf + 15) & ~(uintptr_t)15);
+
+    memset(src, 0xaa, MEMBENCH_BUF_SIZE);
+    printf("%8s %10s %10s %10s %14s\n", "size", "memcpy", "memmove", "memset", "memcpy (unal)");
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(size_t); s++) {
+        const size_t n = sizes[s];
+        const long cpy = membench_run(memcpy_adapter, dst, src, n);
+        const long mov = membench_run(memmove_adapter, dst, src, n);
+        const long set = membench_run(memset_adapter, dst, src, n);
+        const long cpyu = membench_run(memcpy_adapter, dst + 1, src + 2, n - 2);
+
+        printf("%8zu %7ld MB/s %7ld MB/s %7ld MB/s %11ld MB/s\n", n, cpy, mov, set, cpyu);
+    }
+
+    free(src_buf);
+    free(dst_buf);
+}
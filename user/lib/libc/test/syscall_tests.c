@@ -9,7 +9,12 @@
 #include <limits.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdio.h>
+#include <ext/nanotime.h>
 #include <kpi/syscall.h>
+#include <serena/clock.h>
+#include <serena/pipe.h>
+#include <serena/scring.h>
 #include "asserts.h"
 
 
@@ -17,3 +22,93 @@ void kern_test(int argc, char *argv[])
 {
     assert_int_eq(0, _syscall(SC_nullsys));
 }
+
+
+#define RING_SIZE       16
+#define RING_ROUNDS     256
+
+static scring_sqe_t gSqes[RING_SIZE];
+static scring_cqe_t gCqes[RING_SIZE];
+
+void scring_test(int argc, char *argv[])
+{
+    scring_t ring;
+    scring_sqe_t* sqe;
+    const scring_cqe_t* cqe;
+    int fds[2], type = -1;
+    nanotime_t t0, t1, t2;
+
+    assert_ok(scring_init(&ring, gSqes, gCqes, RING_SIZE));
+    assert_ok(pipe_create(fds));
+
+
+    // Mixed batch
+    sqe = scring_sqe(&ring, SC_nullsys, 1);
+    assert_not_null(sqe);
+
+    sqe = scring_sqe(&ring, SC_fd_type, 2);
+    assert_not_null(sqe);
+    sqe->args[0] = fds[PIPE_FD_READ];
+    sqe->args[1] = (intptr_t)&type;
+
+    // Not allowed on a ring
+    sqe = scring_sqe(&ring, SC_proc_exit, 3);
+    assert_not_null(sqe);
+
+    assert_int_eq(3, scring_submit(&ring));
+
+    cqe = scring_cqe(&ring);
+    assert_not_null(cqe);
+    assert_int_eq(1, cqe->udata);
+    assert_int_eq(EOK, cqe->result);
+
+    cqe = scring_cqe(&ring);
+    assert_not_null(cqe);
+    assert_int_eq(2, cqe->udata);
+    assert_int_eq(EOK, cqe->result);
+    assert_int_eq(FD_TYPE_INODE, type);
+
+    cqe = scring_cqe(&ring);
+    assert_not_null(cqe);
+    assert_int_eq(3, cqe->udata);
+    assert_int_eq(ENOSYS, cqe->result);
+
+    assert_null(scring_cqe(&ring));
+
+
+    // Full queues
+    for (int i = 0; i < RING_SIZE; i++) {
+        assert_not_null(scring_sqe(&ring, SC_nullsys, i));
+    }
+    assert_null(scring_sqe(&ring, SC_nullsys, RING_SIZE));
+    assert_int_eq(RING_SIZE, scring_submit(&ring));
+    for (int i = 0; i < RING_SIZE; i++) {
+        cqe = scring_cqe(&ring);
+        assert_not_null(cqe);
+        assert_int_eq(i, cqe->udata);
+    }
+
+
+    // One trap per call vs one trap per batch
+    clock_time(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < RING_ROUNDS * RING_SIZE; i++) {
+        _syscall(SC_nullsys);
+    }
+    clock_time(CLOCK_MONOTONIC, &t1);
+    for (int i = 0; i < RING_ROUNDS; i++) {
+        for (int j = 0; j < RING_SIZE; j++) {
+            scring_sqe(&ring, SC_nullsys, j);
+        }
+        scring_submit(&ring);
+        while (scring_cqe(&ring)) {}
+    }
+    clock_time(CLOCK_MONOTONIC, &t2);
+
+    nanotime_sub(&t2, &t2, &t1);
+    nanotime_sub(&t1, &t1, &t0);
+    printf("%d calls: trap %ld us, ring %ld us\n", RING_ROUNDS * RING_SIZE, (long)nanotime_us(&t1), (long)nanotime_us(&t2));
+
+
+    fd_close(fds[PIPE_FD_READ]);
+    fd_close(fds[PIPE_FD_WRITE]);
+}
@@ -12,6 +12,8 @@
 #include <time.h>
 #include <ext/nanotime.h>
 #include <serena/clock.h>
+#include <serena/host.h>
+#include <serena/process.h>
 #include <serena/signal.h>
 #include <serena/vcpu.h>
 #include <serena/vcpu_acquire.h>
@@ -200,3 +202,113 @@ void vcpu_suspend_test(int argc, char *argv[])
     vcpu_b = vcpu_acquire((vcpu_func_t)test_suspend_A_loop, NULL, &attr);
     assert_not_null(vcpu_b);
 }
+
+
+////////////////////////////////////////////////////////////////////////////////
+// vcpu_sched_stats_test
+
+static void test_sched_stats_print_hist(const char* _Nonnull label, const uint32_t* _Nonnull hist, int cycle_ns)
+{
+    printf("  %s:\n", label);
+    for (int i = 0; i < SCHED_HIST_BUCKET_COUNT; i++) {
+        if (hist[i] > 0) {
+            const long us = ((long)cycle_ns << i) / 1000l;
+
+            printf("    >= %8ldus: %lu\n", us, (unsigned long)hist[i]);
+        }
+    }
+}
+
+// Sleeps a couple of times to generate wakeups and then dumps the per-QoS
+// scheduler statistics
+void vcpu_sched_stats_test(int argc, char *argv[])
+{
+    static const char* qos_name[VCPU_QOS_COUNT] = {"Background", "Utility", "Interactive", "Urgent", "Realtime"};
+    cpu_sched_stats_info_t info;
+    nanotime_t ts_10ms;
+
+    nanotime_from_ms(&ts_10ms, 10);
+    for (int i = 0; i < 16; i++) {
+        clock_sleep(CLOCK_MONOTONIC, 0, &ts_10ms);
+    }
+
+    assert_ok(cpu_info(1, CPU_INFO_SCHED_STATS, &info));
+    assert_int_ge(1, info.cycle_ns);
+
+    uint32_t wakeups = 0;
+    for (int q = 0; q < VCPU_QOS_COUNT; q++) {
+        const cpu_sched_qos_stats_t* sp = &info.qos[q];
+
+        wakeups += sp->wakeups;
+        if (sp->dispatches == 0) {
+            continue;
+        }
+
+        printf("%s: %lu dispatches, %lu wakeups, %lu preemptions, %lu quantum expirations\n", qos_name[q], (unsigned long)sp->dispatches, (unsigned long)sp->wakeups, (unsigned long)sp->preemptions, (unsigned long)sp->quantum_expirations);
+        printf("  ready queue: avg %lu, max %lu\n", (unsigned long)(sp->rq_len_sum / sp->dispatches), (unsigned long)sp->rq_len_max);
+        test_sched_stats_print_hist("wakeup latency", sp->wakeup_latency, info.cycle_ns);
+        test_sched_stats_print_hist("run time", sp->run_time, info.cycle_ns);
+    }
+
+    assert_true(wakeups >= 16);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// vcpu_stack_test
+
+static int test_stack_touch(int depth)
+{
+    volatile char buf[256];
+
+    buf[0] = (char)depth;
+    buf[sizeof(buf) - 1] = (char)depth;
+    return (depth > 0) ? test_stack_touch(depth - 1) + buf[0] : buf[sizeof(buf) - 1];
+}
+
+static void test_stack_loop(void)
+{
+    test_stack_touch(8);
+}
+
+// Checks that the stack high-water mark of a vcpu is tracked and that it ends
+// up in the process stack peak once the vcpu has been relinquished
+void vcpu_stack_test(int argc, char *argv[])
+{
+    vcpu_stack_info_t si;
+    proc_basic_info_t pi;
+    vcpu_attr_t attr;
+    nanotime_t ts_10ms;
+    vcpu_t vp;
+
+    assert_ok(vcpu_info(vcpu_self(), VCPU_INFO_STACK, &si));
+    assert_true(si.high_water > 0 && si.high_water <= si.size);
+    printf("main: %zu of %zu bytes used\n", si.high_water, si.size);
+
+
+    vcpu_attr_init(&attr);
+    vcpu_attr_setstacksize(&attr, 8192);
+    vcpu_attr_setsuspended(&attr, true);
+    vp = vcpu_acquire((vcpu_func_t)test_stack_loop, NULL, &attr);
+    assert_not_null(vp);
+
+    assert_ok(vcpu_info(vp, VCPU_INFO_STACK, &si));
+    assert_int_ge(8192, si.size);
+    assert_true(si.high_water < 256);
+    vcpu_resume(vp);
+
+
+    // Wait for the vcpu to relinquish itself
+    nanotime_from_ms(&ts_10ms, 10);
+    for (int i = 0; i < 100; i++) {
+        clock_sleep(CLOCK_MONOTONIC, 0, &ts_10ms);
+
+        assert_ok(proc_info(PROC_SELF, PROC_INFO_BASIC, &pi));
+        if (pi.vcpu_stack_peak >= 8 * 256) {
+            break;
+        }
+    }
+
+    printf("peak: %zu bytes\n", pi.vcpu_stack_peak);
+    assert_int_ge(8 * 256, pi.vcpu_stack_peak);
+}
@@ -186,22 +186,23 @@ typedef struct dispatch_attr {
     int         qos;
     int         priority;
     const char* _Nullable   name;   // Length limited to DISPATCH_MAX_NAME_LENGTH
+    size_t      stackSize;          // User stack size of the worker vcpus. 0 -> default size
 } dispatch_attr_t;
 
 
 // Initializes a dispatch attribute object to set up a serial queue with
 // interactive priority.
-#define DISPATCH_ATTR_INIT_SERIAL_INTERACTIVE       (dispatch_attr_t){0, 1, 1, DISPATCH_QOS_INTERACTIVE, DISPATCH_PRI_NORMAL, NULL}
+#define DISPATCH_ATTR_INIT_SERIAL_INTERACTIVE       (dispatch_attr_t){0, 1, 1, DISPATCH_QOS_INTERACTIVE, DISPATCH_PRI_NORMAL, NULL, 0}
 
 // Initializes a dispatch attribute object to set up a concurrent queue with
 // exactly '__n' virtual processors and utility priority. This dispatcher does
 // not relinquish unused vcpus. It maintains a fixed set of them.
-#define DISPATCH_ATTR_INIT_FIXED_CONCURRENT_UTILITY(__n)  (dispatch_attr_t){0, __n, __n, DISPATCH_QOS_UTILITY, DISPATCH_PRI_NORMAL, NULL}
+#define DISPATCH_ATTR_INIT_FIXED_CONCURRENT_UTILITY(__n)  (dispatch_attr_t){0, __n, __n, DISPATCH_QOS_UTILITY, DISPATCH_PRI_NORMAL, NULL, 0}
 
 // Initializes a dispatch attribute object to set up a concurrent queue with
 // exactly '__n' virtual processors and utility priority. This dispatcher does
 // relinquish unused vcpus after some time and reacquires them as needed.
-#define DISPATCH_ATTR_INIT_ELASTIC_CONCURRENT_UTILITY(__n)  (dispatch_attr_t){0, 1, __n, DISPATCH_QOS_UTILITY, DISPATCH_PRI_NORMAL, NULL}
+#define DISPATCH_ATTR_INIT_ELASTIC_CONCURRENT_UTILITY(__n)  (dispatch_attr_t){0, 1, __n, DISPATCH_QOS_UTILITY, DISPATCH_PRI_NORMAL, NULL, 0}
 
 
 
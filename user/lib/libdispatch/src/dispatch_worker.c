@@ -23,6 +23,7 @@ static bool _dispatch_worker_acquire_vcpu(dispatch_worker_t _Nonnull self)
     vcpu_attr_setqos(&attr, owner->attr.qos, owner->attr.priority);
     vcpu_attr_setgroupid(&attr, owner->group_id);
     vcpu_attr_setsuspended(&attr, true);
+    vcpu_attr_setstacksize(&attr, owner->attr.stackSize);
 
     self->allow_relinquish = !_dispatch_is_fixed_concurrency(owner);
     self->vcpu = vcpu_acquire((vcpu_func_t)_dispatch_worker_run, self, &attr);